@@ -9,7 +9,11 @@ set(RISCV_MEM_LIBRARY_HEADERS
     "${_RV_MEM_HDR_DIR}/mem_MemoryController.h"
     "${_RV_MEM_HDR_DIR}/mem_RegionInfo.h"
     "${_RV_MEM_HDR_DIR}/mem_Result.h"
+    "${_RV_MEM_HDR_DIR}/mem_RomDevice.h"
 
+    "${_RV_MEM_HDR_DIR}/detail/mem_DirtyPageBitmap.h"
+    "${_RV_MEM_HDR_DIR}/detail/mem_ExecRegion.h"
+    "${_RV_MEM_HDR_DIR}/detail/mem_HostMemory.h"
     "${_RV_MEM_HDR_DIR}/detail/mem_IoRegion.h"
     "${_RV_MEM_HDR_DIR}/detail/mem_MemRegion.h"
     "${_RV_MEM_HDR_DIR}/detail/mem_RegionBase.h"
@@ -17,4 +21,6 @@ set(RISCV_MEM_LIBRARY_HEADERS
 
 set(RISCV_MEM_LIBRARY_SOURCES
     "${_RV_MEM_SRC_DIR}/mem_MemoryController.cpp"
+
+    "${_RV_MEM_SRC_DIR}/detail/mem_HostMemory-os.linux.cpp"
 )
@@ -7,8 +7,11 @@ set(RISCV_UTIL_LIBRARY_HEADERS
     "${_RV_UTIL_HDR_DIR}/util_Bitmask.h"
     "${_RV_UTIL_HDR_DIR}/util_BitSwap.h"
     "${_RV_UTIL_HDR_DIR}/util_ByteCount.h"
+    "${_RV_UTIL_HDR_DIR}/util_CacheLine.h"
+    "${_RV_UTIL_HDR_DIR}/util_IndexedHeap.h"
     "${_RV_UTIL_HDR_DIR}/util_OverflowCheck.h"
     "${_RV_UTIL_HDR_DIR}/util_SignExtend.h"
+    "${_RV_UTIL_HDR_DIR}/util_SpinWait.h"
 )
 
 set(RISCV_UTIL_LIBRARY_SOURCES
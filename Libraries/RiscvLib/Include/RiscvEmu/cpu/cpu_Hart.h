@@ -1,16 +1,23 @@
 #pragma once
 #include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/diag.h>
 #include <RiscvEmu/cpu/cpu_CsrFormat.h>
 #include <RiscvEmu/cpu/cpu_CsrId.h>
 #include <RiscvEmu/cpu/cpu_Types.h>
 #include <RiscvEmu/cpu/cpu_Result.h>
 #include <RiscvEmu/cpu/cpu_TrapCode.h>
 #include <RiscvEmu/cpu/cpu_InstructionFormat.h>
+#include <RiscvEmu/cpu/cpu_ITimeSource.h>
 #include <RiscvEmu/cpu/detail/cpu_ClkTime.h>
 #include <RiscvEmu/cpu/detail/cpu_MemoryManager.h>
 #include <RiscvEmu/cpu/detail/cpu_MemoryMonitor.h>
+#include <RiscvEmu/cpu/detail/cpu_SpinDetector.h>
 #include <RiscvEmu/mem/mem_MemoryController.h>
+#include <RiscvEmu/util/util_CacheLine.h>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <utility>
 
 namespace riscv {
 namespace cpu {
@@ -39,11 +46,18 @@ public:
     /** Execute an instruction. */
     Result ExecuteInst(Instruction inst);
 
-    /** Execute the instruction at PC (atomic ReadInstructionAtPc + ExecuteInstruction) */
+    /**
+     * Execute the instruction at PC (atomic ReadInstructionAtPc + ExecuteInstruction).
+     *
+     * Unlike ExecuteInst, PC is advanced to the next instruction unless the instruction branched or jumped.
+    */
     Result ExecuteInstAtPc();
 
     /** Write the PC register. */
-    constexpr void WritePC(NativeWord addr) noexcept { m_PC = addr; }
+    constexpr void WritePC(NativeWord addr) noexcept {
+        m_PC = addr;
+        m_SelfLooping = false;
+    }
 
     /** Write a general purpose register. */
     constexpr void WriteGPR(int index, NativeWord value) noexcept {
@@ -60,6 +74,9 @@ public:
         return m_GPR[index];
     }
 
+    /** Read the retired instruction count, the same counter as the mcycle and minstret CSRs. */
+    constexpr DWord GetCycleCount() const noexcept { return m_CycleCount; }
+
     /** Write a control/status register. */
     Result WriteCSR(CsrId id, NativeWord value);
 
@@ -94,6 +111,96 @@ public:
     Result MappedWriteDWord(DWord in, Address addr);
 
     Result Reset();
+
+    /** Check whether the hart has nothing to do until woken, e.g. after executing WFI. */
+    bool IsIdle() const noexcept { return m_IdleState.load(std::memory_order_relaxed) == IdleState::Idle; }
+
+    /**
+     * Clear the hart's idle state and interrupt any wait, this may be called from any thread.
+     *
+     * Waking a hart which isn't idle makes its next WFI complete immediately, so wakes racing WFI aren't lost.
+    */
+    void Wake() noexcept;
+
+    /** Block the calling thread while the hart is idle, until Wake is called. */
+    void WaitWhileIdle() const noexcept {
+        while(this->IsIdle()) {
+            m_IdleState.wait(IdleState::Idle, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Allow WRS.NTO/WRS.STO to stall the calling host thread until the hart's reservation is lost.
+     *
+     * Only enable this when the hart has a host thread to itself, otherwise WRS is treated as a NOP.
+    */
+    void SetBlockingWaitEnabled(bool enabled) noexcept { m_BlockingWaitEnabled = enabled; }
+
+    /** End the hart's current or next blocking wait early, this may be called from any thread. */
+    void InterruptWait() { m_MemMonitorCtx.InterruptReservationWait(); }
+
+    /**
+     * Check and clear whether the hart asked to be switched out, e.g. because it's spinning.
+     *
+     * Runners sharing a host thread between harts should move on to another hart when this is set.
+    */
+    bool ConsumeYieldRequest() noexcept { return std::exchange(m_YieldRequested, false); }
+
+    /**
+     * Check whether the last instruction was a taken branch or jump to itself, e.g. "j .".
+     *
+     * Without interrupts such a hart repeats the instruction forever, so runners may skip ahead instead of executing it.
+    */
+    bool IsSelfLooping() const noexcept { return m_SelfLooping; }
+
+    /** Account for instCount iterations of a self loop without executing them, see IsSelfLooping. */
+    void RetireSelfLoop(DWord instCount) noexcept {
+        diag::Assert(m_SelfLooping);
+        m_CycleCount += instCount;
+    }
+
+    /**
+     * Account for cycles spent idle in WFI, so the cycle counter keeps pace with time like on hardware, see IsIdle.
+     *
+     * minstret shares the counter and counts them as well.
+    */
+    void CountIdleCycles(DWord cycleCount) noexcept {
+        diag::Assert(this->IsIdle());
+        m_CycleCount += cycleCount;
+    }
+
+    /**
+     * Account for the rest of a quantum a spinning hart gave up, see ConsumeYieldRequest.
+     *
+     * It would have kept spinning for those cycles, so they're counted as retired like CountIdleCycles does.
+    */
+    void CountYieldedCycles(DWord cycleCount) noexcept { m_CycleCount += cycleCount; }
+
+    using TimeMode = detail::ClkTime::Mode;
+
+    /**
+     * Select where the time CSR gets its value from, time continues from its current value.
+     *
+     * TimeMode::Instret is the default, deterministic and derived from retired instructions.
+     * TimeMode::HostClock follows the host's clock, for harts which aren't run in virtual time.
+     *
+     * @param[in] mode  Time source, TimeMode::External is selected by SetTimeSource.
+     * @param[in] instFreq  Instructions retired per second, used by TimeMode::Instret.
+    */
+    void SetTimeMode(TimeMode mode, DWord instFreq) { m_ClkTime.SetMode(mode, m_CycleCount, instFreq); }
+
+    /** Back the time CSR with a source shared with devices, selecting TimeMode::External. */
+    void SetTimeSource(const ITimeSource* pSource) { m_ClkTime.SetSource(pSource); }
+private:
+    enum class IdleState : Word {
+        Running,
+        Idle,
+
+        /** Woken while running, the next WFI completes immediately. */
+        WakePending
+    }; // enum class IdleState
+
+    void EnterIdle() noexcept;
 private:
     class InstructionRunner;
     Result ExecuteInstructionImpl(Instruction inst);
@@ -102,11 +209,13 @@ private:
         /* TODO: Check alignment, throw exception if misaligned. */
 
         m_PC += offset;
+        m_PCWritten = true;
         return ResultSuccess();
     }
 
     constexpr Result SignalJump(Address addr) {
         m_PC = addr;
+        m_PCWritten = true;
         return ResultSuccess();
     }
 private:
@@ -120,6 +229,9 @@ private:
     Result MemWriteDWord(DWord in, Address addr);
 
     Result FetchInstruction(Instruction* pOut, Address addr);
+private:
+    void OnSpinLoop();
+    void OnPauseHint();
 private:
     Result TriggerTrap(TrapCode code);
 private:
@@ -157,6 +269,9 @@ private:
 
     Result CSRRead_instret(NativeWord* pOut);
     Result CSRRead_instreth(NativeWord* pOut);
+
+    Result CSRRead_time(NativeWord* pOut);
+    Result CSRRead_timeh(NativeWord* pOut);
 private:
     NativeWord& GetEPC() noexcept;
     NativeWord& GetTrapVecBase() noexcept;
@@ -171,18 +286,63 @@ private:
         misa.SetMXL(cfg::cpu::EnableIsaRV64I ? 2 : 1);
         misa.SetI(true);
         misa.SetM(true);
+        misa.SetA(true);
         return misa;
     }();
+
+    /** WRS.STO waits at most this long. */
+    static constexpr std::chrono::microseconds c_WrsShortTimeout{50};
+
+    /** Spinning harts are parked at most this long, the loop may be polling something stores don't change. */
+    static constexpr std::chrono::microseconds c_SpinParkTimeout{50};
 private:
-    NativeWord m_PC;
+    /*
+     * Members are grouped by who touches them, with each group starting on its own cache line,
+     * so harts running on different host threads never share a line.
+    */
+
+    /* Hot execution state, only touched by the thread running the hart. */
+    alignas(util::CacheLineSize) NativeWord m_PC;
     NativeWord m_GPR[NumGPR];
 
+    /** Cycle & retired inst count. */
+    DWord m_CycleCount;
+
+    /** Value loaded by the last LR, SC only succeeds if memory still holds it. */
+    DWord m_ReservedValue;
+
     PrivilageLevel m_CurPrivLevel;
 
-    Word m_HartId;
+    /** Set when the executing instruction wrote PC. */
+    bool m_PCWritten;
 
-    /** Cycle & retired inst count. */
-    DWord m_CycleCount;
+    /** See SetBlockingWaitEnabled. */
+    bool m_BlockingWaitEnabled;
+
+    /** See ConsumeYieldRequest. */
+    bool m_YieldRequested;
+
+    /** See IsSelfLooping. */
+    bool m_SelfLooping;
+
+    /** Watches for guest busy-wait loops. */
+    detail::SpinDetector m_SpinDetector;
+
+    /* Memory manager. */
+    detail::MemoryManager m_MemMgr;
+
+    /* Memory monitor context for this hart. */
+    detail::MemoryMonitor::Context m_MemMonitorCtx;
+
+    SharedState* m_pSharedCtx;
+
+    /* Written by other threads. */
+
+    /** See IsIdle and Wake. */
+    alignas(util::CacheLineSize) std::atomic<IdleState> m_IdleState;
+
+    /* Cold state, only touched by traps and CSR accesses. */
+    alignas(util::CacheLineSize) Word m_HartId;
 
     /** EPC for each privilage level. */
     NativeWord m_EPC[4];
@@ -201,13 +361,8 @@ private:
     //NativeWord m_HypervisorScratch;
     NativeWord m_SupervisorScratch;
 
-    /* Memory manager. */
-    detail::MemoryManager m_MemMgr;
-
-    /* Memory monitor context for this hart. */
-    detail::MemoryMonitor::Context m_MemMonitorCtx;
-
-    SharedState* m_pSharedCtx;
+    /** Source of the time CSR. */
+    detail::ClkTime m_ClkTime;
 }; // class Hart
 
 } // namespace cpu
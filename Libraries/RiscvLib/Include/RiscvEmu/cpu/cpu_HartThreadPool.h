@@ -0,0 +1,107 @@
+#pragma once
+#include <RiscvEmu/result.h>
+#include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/cpu/cpu_Hart.h>
+#include <RiscvEmu/util/util_CacheLine.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace riscv {
+namespace cpu {
+
+/**
+ * This runs many harts on a fixed number of host worker threads.
+ *
+ * Each worker owns a queue of runnable harts and runs the hart at its front for a quantum
+ * before moving it to the back. Workers with an empty queue steal harts from the other workers.
+ *
+ * Idle harts (see Hart::IsIdle) are parked and aren't run again until passed to Wake.
+*/
+class HartThreadPool {
+public:
+    HartThreadPool() = default;
+    HartThreadPool(const HartThreadPool&) = delete;
+
+    /**
+     * Start running harts.
+     *
+     * @param[in] pHarts  Harts to run, these must outlive the pool's run.
+     * @param[in] hartCount  Number of harts in pHarts.
+     * @param[in] workerCount  Number of host worker threads, 0 uses one per host core.
+     * @param[in] quantum  Instructions a hart executes before workers switch to another hart.
+    */
+    void Start(Hart* pHarts, Word hartCount, std::size_t workerCount, DWord quantum);
+
+    /** Request all workers stop, this doesn't wait for them, see Join. */
+    void Stop() noexcept;
+
+    /**
+     * Wait for all workers to exit.
+     *
+     * @return The first failure returned by a hart, otherwise ResultSuccess().
+    */
+    Result Join();
+
+    /**
+     * Wake a hart and make it runnable again if it was parked, this may be called from any thread.
+     *
+     * Wakes racing with Start or Join are safe, Join waits for any wake still using the pool.
+     *
+     * @return Whether the pool was running and woke the hart, if not the caller has to wake it.
+    */
+    bool Wake(Word hartId);
+
+    /** Check whether the pool has been started and not yet joined, this may be called from any thread. */
+    bool IsRunning() const noexcept { return m_Running.load(std::memory_order_acquire); }
+private:
+    struct alignas(util::CacheLineSize) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Word> harts;
+    }; // struct WorkerQueue
+private:
+    void RunWorker(std::size_t workerIndex);
+
+    bool PopHart(std::size_t workerIndex, Word* pOut);
+    bool StealHart(std::size_t workerIndex, Word* pOut);
+    void PushHart(std::size_t workerIndex, Word hartId);
+
+    void ParkHart(std::size_t workerIndex, Word hartId);
+    void WaitForWork();
+
+    Result ExecuteQuantum(Hart& hart);
+    void SignalHartFailure(Result res) noexcept;
+private:
+    Hart* m_pHarts = nullptr;
+    Word m_HartCount = 0;
+    DWord m_Quantum = 0;
+
+    std::size_t m_WorkerCount = 0;
+    std::unique_ptr<std::thread[]> m_pWorkers;
+    std::unique_ptr<WorkerQueue[]> m_pQueues;
+
+    /* Set for harts which are idle and in no queue. */
+    std::unique_ptr<std::atomic<bool>[]> m_pParked;
+
+    /* Number of harts sitting in queues, idle workers sleep while this is zero. */
+    std::atomic<std::size_t> m_QueuedCount = 0;
+    std::atomic<std::size_t> m_SleepingCount = 0;
+    std::mutex m_SleepMutex;
+    std::condition_variable m_SleepCv;
+
+    std::atomic<bool> m_StopRequested = false;
+    std::atomic<Word> m_HartResult = ResultSuccess().GetValue();
+
+    /* Set once Start has set up the pool and cleared by Join, Wake only uses the pool while it's set. */
+    std::atomic<bool> m_Running = false;
+
+    /* Number of Wake calls which may be using the pool, Join waits for these before tearing it down. */
+    std::atomic<std::size_t> m_WakesInFlight = 0;
+}; // class HartThreadPool
+
+} // namespace cpu
+} // namespace riscv
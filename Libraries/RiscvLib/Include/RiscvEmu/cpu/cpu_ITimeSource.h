@@ -0,0 +1,21 @@
+#pragma once
+#include <RiscvEmu/riscv_Types.h>
+
+namespace riscv {
+namespace cpu {
+
+/**
+ * Time source a hart's time CSR can be backed by, see Hart::SetTimeSource.
+ *
+ * This lets harts share a clock with devices, e.g. a CLINT's mtime, see intrpt::CLINT::GetTimeSource.
+*/
+class ITimeSource {
+public:
+    virtual ~ITimeSource() noexcept = default;
+
+    /** Get the current time, harts read it as is so it counts at whatever timebase frequency guests expect. */
+    virtual DWord GetTime() const = 0;
+}; // class ITimeSource
+
+} // namespace cpu
+} // namespace riscv
@@ -97,6 +97,13 @@ enum class Function {
     SW = detail::CreateFunctionImpl3(0b010),
     SD = detail::CreateFunctionImpl3(0b011),
 
+    /* Opcode AMO, see AmoFunction. */
+    AMO_B = detail::CreateFunctionImpl3(0b000),
+    AMO_H = detail::CreateFunctionImpl3(0b001),
+    AMO_W = detail::CreateFunctionImpl3(0b010),
+    AMO_D = detail::CreateFunctionImpl3(0b011),
+    AMO_Q = detail::CreateFunctionImpl3(0b100),
+
     /* Opcode OP. */
     ADD    = detail::CreateFunctionImpl37(0b000, 0b0000000),
     SUB    = detail::CreateFunctionImpl37(0b000, 0b0100000),
@@ -141,6 +148,7 @@ enum class Function {
     JALR = detail::CreateFunctionImpl3(0b000),
 
     /* Opcode SYSTEM. */
+    PRIV  = detail::CreateFunctionImpl3(0b000),
     CSRRW = detail::CreateFunctionImpl3(0b001),
     CSRRS = detail::CreateFunctionImpl3(0b010),
     CSRRC = detail::CreateFunctionImpl3(0b011),
@@ -149,6 +157,34 @@ enum class Function {
     CSRRCI = detail::CreateFunctionImpl3(0b111),
 };
 
+/* Opcode MISC_MEM, Function FENCE hints are identified by fm/pred/succ with rd and rs1 zero. */
+enum class FenceHint {
+    PAUSE = 0b000000010000,
+}; // enum class FenceHint
+
+/* Opcode SYSTEM, Function PRIV instructions are identified by funct12. */
+enum class PrivFunction {
+    WFI     = 0b000100000101,
+    WRS_NTO = 0b000000001101,
+    WRS_STO = 0b000000011101,
+}; // enum class PrivFunction
+
+/* Opcode AMO instructions are identified by funct5, the upper bits of funct7 above aq/rl. */
+enum class AmoFunction {
+    AMOADD  = 0b00000,
+    AMOSWAP = 0b00001,
+    LR      = 0b00010,
+    SC      = 0b00011,
+    AMOXOR  = 0b00100,
+    AMOCAS  = 0b00101,
+    AMOOR   = 0b01000,
+    AMOAND  = 0b01100,
+    AMOMIN  = 0b10000,
+    AMOMAX  = 0b10100,
+    AMOMINU = 0b11000,
+    AMOMAXU = 0b11100,
+}; // enum class AmoFunction
+
 constexpr Function CreateFunction3(int f3) noexcept { return static_cast<Function>(detail::CreateFunctionImpl3(f3)); }
 
 constexpr Function CreateFunction37(int f3, int f7) noexcept { return static_cast<Function>(detail::CreateFunctionImpl37(f3, f7)); }
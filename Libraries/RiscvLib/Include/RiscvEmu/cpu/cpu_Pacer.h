@@ -0,0 +1,75 @@
+#pragma once
+#include <RiscvEmu/riscv_Types.h>
+#include <atomic>
+#include <chrono>
+
+namespace riscv {
+namespace cpu {
+
+/**
+ * Throttles a host thread running guest instructions to a guest frequency, so guest time keeps pace with wall clock time.
+ *
+ * Guest time is a retired instruction count divided by the frequency. Once it's ahead of host time by SleepGranularity
+ * the thread sleeps off the lead, so pacing costs a comparison per check and sleeps are coarse instead of per instruction.
+ *
+ * Sleeps target an absolute schedule set by Start, oversleeping shortens the next sleep instead of accumulating as drift.
+ * The host's usual oversleep is measured and sleeps wake that much early.
+ *
+ * Drift beyond MaxDrift in either direction, e.g. after the host process was suspended or the guest rewrote mcycle,
+ * isn't made up for, the schedule restarts from the current count instead.
+ *
+ * Instances aren't thread safe, each paced thread owns one.
+*/
+class Pacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** Guest time a thread may run ahead before sleeping, in nanoseconds. */
+    static constexpr DWord SleepGranularity = 1'000'000;
+
+    /** Longest single sleep, stop requests are noticed within this, in nanoseconds. */
+    static constexpr DWord MaxSleepSlice = 10'000'000;
+
+    /** Drift the schedule is kept through, in nanoseconds. */
+    static constexpr DWord MaxDrift = 100'000'000;
+public:
+    /**
+     * Start pacing.
+     *
+     * @param[in] freq  Guest frequency, instructions retired per second.
+     * @param[in] instCount  Current retired instruction count.
+    */
+    void Start(DWord freq, DWord instCount);
+
+    /** Restart the schedule from instCount, e.g. after the thread waited for reasons other than pacing. */
+    void Resync(DWord instCount);
+
+    /** Check whether Pace has to be called for instCount, this is cheap enough to call per instruction. */
+    bool IsDue(DWord instCount) const noexcept { return instCount - m_LastCount >= m_CheckInterval; }
+
+    /**
+     * Sleep until host time catches up with guest time.
+     *
+     * @param[in] instCount  Current retired instruction count.
+     * @param[in] stopRequested  Returns early once this is set.
+    */
+    void Pace(DWord instCount, const std::atomic<bool>& stopRequested);
+
+    /** Get the number of instructions retired in MaxSleepSlice. */
+    DWord GetSliceInstCount() const noexcept { return m_SliceInstCount; }
+private:
+    DWord m_Freq = 1;
+    DWord m_CheckInterval = 1;
+    DWord m_SliceInstCount = 1;
+
+    /* Guest time is host time m_BaseTime at m_BaseCount. */
+    Clock::time_point m_BaseTime;
+    DWord m_BaseCount = 0;
+    DWord m_LastCount = 0;
+
+    /* Average time sleeps overran by. */
+    Clock::duration m_Oversleep{};
+}; // class Pacer
+
+} // namespace cpu
+} // namespace riscv
@@ -15,12 +15,14 @@ class ResultInvalidInstruction : public result::ErrorBase<detail::ModuleId, 1> {
 class ResultNotImplemented : public result::ErrorBase<detail::ModuleId, 2> {};
 
 /* Memory Access Errors. */
-class ResultLoadAccessFault  : public result::ErrorBase<detail::ModuleId, 200> {};
-class ResultStoreAccessFault : public result::ErrorBase<detail::ModuleId, 201> {};
-class ResultFetchAccessFault : public result::ErrorBase<detail::ModuleId, 202> {};
-class ResultLoadPageFault    : public result::ErrorBase<detail::ModuleId, 203> {};
-class ResultStorePageFault   : public result::ErrorBase<detail::ModuleId, 204> {};
-class ResultFetchPageFault   : public result::ErrorBase<detail::ModuleId, 205> {};
+class ResultLoadAccessFault        : public result::ErrorBase<detail::ModuleId, 200> {};
+class ResultStoreAccessFault       : public result::ErrorBase<detail::ModuleId, 201> {};
+class ResultFetchAccessFault       : public result::ErrorBase<detail::ModuleId, 202> {};
+class ResultLoadPageFault          : public result::ErrorBase<detail::ModuleId, 203> {};
+class ResultStorePageFault         : public result::ErrorBase<detail::ModuleId, 204> {};
+class ResultFetchPageFault         : public result::ErrorBase<detail::ModuleId, 205> {};
+class ResultLoadAddressMisaligned  : public result::ErrorBase<detail::ModuleId, 206> {};
+class ResultStoreAddressMisaligned : public result::ErrorBase<detail::ModuleId, 207> {};
 
 /* Internal translation error. */
 class ResultInvalidTranslationMode  : public result::ErrorBase<detail::ModuleId, 210> {};
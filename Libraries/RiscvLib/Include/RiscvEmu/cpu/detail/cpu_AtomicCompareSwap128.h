@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+namespace riscv {
+namespace cpu {
+namespace detail {
+
+/**
+ * Atomically compare and swap 16 bytes of host memory with a single host instruction.
+ *
+ * @param[in] pMem  Memory to operate on as { low, high }, must be 16 byte aligned.
+ * @param[in,out] pExpected  Expected value as { low, high }, receives the previous value.
+ * @param[in] desiredLow  Low half of the value to store.
+ * @param[in] desiredHigh  High half of the value to store.
+ * @return Whether memory held the expected value and was written.
+*/
+bool CompareSwap128(uint64_t* pMem, uint64_t* pExpected, uint64_t desiredLow, uint64_t desiredHigh);
+
+} // namespace detail
+} // namespace cpu
+} // namespace riscv
@@ -1,22 +1,89 @@
 #pragma once
 #include <RiscvEmu/riscv_Types.h>
 #include <RiscvEmu/result.h>
+#include <RiscvEmu/cpu/cpu_ITimeSource.h>
 
 namespace riscv {
 namespace cpu {
 namespace detail {
 
+/**
+ * Monotonic time source backing the time CSR.
+ *
+ * In Mode::Instret time is derived from the retired instruction count at a fixed instruction frequency,
+ * which makes it deterministic. This is the default, counting one per retired instruction.
+ *
+ * In Mode::HostClock time follows the host's monotonic clock. Reads use the host cycle counter, scaled by a
+ * factor recalibrated against the clock every CalibrationInterval, so they cost a few cycles instead of a clock call.
+ * Recalibration never makes time go backwards.
+ *
+ * In Mode::External time is read from an ITimeSource as is, so everything sharing the source agrees on it.
+ *
+ * Instances aren't thread safe, each hart owns one.
+*/
 class ClkTime {
 public:
-    Result Initialize();
+    enum class Mode {
+        Instret,
+        HostClock,
 
-    Result GetCurrentTime(DWord* pOut);
+        /** Set by SetSource. */
+        External
+    }; // enum class Mode
 
-    Result SetCurrentTime(DWord in);
+    /** Default frequency time counts at, the same as the CLINT's mtime. */
+    static constexpr DWord DefaultFreq = 10'000'000;
+
+    /** Host time between recalibrations of the cycle counter, in nanoseconds. */
+    static constexpr DWord CalibrationInterval = 100'000'000;
+public:
+    Result Initialize(DWord freq = DefaultFreq);
+
+    /**
+     * Select where time comes from, time continues from its current value.
+     *
+     * @param[in] mode  Time source.
+     * @param[in] instret  Current retired instruction count.
+     * @param[in] instFreq  Instructions retired per second, used by Mode::Instret.
+    */
+    void SetMode(Mode mode, DWord instret, DWord instFreq);
+
+    /**
+     * Read time from a source, switching to Mode::External.
+     *
+     * Unlike SetMode time doesn't continue from its current value, it's the source's.
+     *
+     * @param[in] pSource  Time source, this must outlive its use.
+    */
+    void SetSource(const ITimeSource* pSource);
+
+    Mode GetMode() const noexcept { return m_Mode; }
+
+    Result GetCurrentTime(DWord* pOut, DWord instret);
+
+    Result SetCurrentTime(DWord in, DWord instret);
+private:
+    DWord GetSourceTime(DWord instret);
+    DWord GetHostTime();
+    void Calibrate(DWord cycles);
 private:
+    Mode m_Mode;
+    DWord m_Freq;
+    DWord m_InstFreq;
+    const ITimeSource* m_pSource;
+
+    /* Time is GetSourceTime() + m_Offset, but never less than m_Last. */
     DWord m_Offset;
+    DWord m_Last;
+
+    /* Host time is m_BaseTime + (cycles - m_BaseCycles) * m_CycleScale / 2^32. */
+    bool m_UseCycleCounter;
+    DWord m_BaseCycles;
+    DWord m_BaseTime;
+    DWord m_CycleScale;
+    DWord m_CalibrationCycles;
 }; // class ClkTime
 
 } // namespace detail
 } // namespace cpu
-} // namespace riscv
\ No newline at end of file
+} // namespace riscv
@@ -50,6 +50,23 @@ private:
         return (*GetDerived().*func)(CreateOutReg(inst.rd()), CreateImmediate(inst.imm_ext()));
     }
 
+    constexpr Result CallCasType(RTypeInstruction inst, auto func) {
+        /* rd is both the compare value and the output. */
+        return (*GetDerived().*func)(CreateOutReg(inst.rd()), CreateInReg(inst.rd()), CreateInReg(inst.rs1()), CreateInReg(inst.rs2()));
+    }
+
+    constexpr Result CallCasPairType(RTypeInstruction inst, auto func) {
+        /* Register pairs must start at an even register. */
+        if((inst.rd() | inst.rs2()) & 1) {
+            return ResultInvalidInstruction();
+        }
+
+        /* A pair starting at x0 reads as zero and is never written, so both halves map to x0. */
+        auto getHigh = [](int reg) { return reg == 0 ? 0 : reg + 1; };
+        return (*GetDerived().*func)(CreateOutReg(inst.rd()), CreateOutReg(getHigh(inst.rd())), CreateInReg(inst.rd()), CreateInReg(getHigh(inst.rd())),
+            CreateInReg(inst.rs1()), CreateInReg(inst.rs2()), CreateInReg(getHigh(inst.rs2())));
+    }
+
 private:
     constexpr Result ParseOpcode(Instruction inst) {
         switch(inst.opcode()) {
@@ -72,8 +89,7 @@ private:
             /* TODO */
             break;
         case Opcode::AMO:
-            /* TODO */
-            break;
+            return this->ParseAMO(RTypeInstruction(inst));
         case Opcode::OP:
             return this->ParseOP(RTypeInstruction(inst));
         case Opcode::LUI:
@@ -141,6 +157,9 @@ private:
     constexpr Result ParseMISC_MEM(ITypeInstruction inst) {
         switch(inst.function()) {
         case Function::FENCE:
+            if(inst.rd() == 0 && inst.rs1() == 0 && static_cast<FenceHint>(inst.imm()) == FenceHint::PAUSE) {
+                return this->GetDerived()->ParseInstPAUSE();
+            }
             return this->CallStandardITypeExt(inst, &Derived::ParseInstFENCE);
         case Function::FENCEI:
             return this->CallStandardITypeExt(inst, &Derived::ParseInstFENCEI);
@@ -251,6 +270,179 @@ private:
         return ResultInvalidInstruction();
     }
 
+    constexpr Result ParseAMO(RTypeInstruction inst) {
+        /* Width is given by funct3, operation by funct5. aq/rl are ignored, every AMO is sequentially consistent. */
+        auto func = static_cast<AmoFunction>(inst.funct7() >> 2);
+
+        switch(static_cast<Function>(inst.funct3())) {
+        case Function::AMO_B:
+            return this->ParseAMO_B(inst, func);
+        case Function::AMO_H:
+            return this->ParseAMO_H(inst, func);
+        case Function::AMO_W:
+            return this->ParseAMO_W(inst, func);
+#ifdef RISCV_CFG_CPU_ENABLE_RV64
+        case Function::AMO_D:
+            return this->ParseAMO_D(inst, func);
+        case Function::AMO_Q: {
+            /* Only AMOCAS exists at quad width, operating on register pairs. */
+            if(func != AmoFunction::AMOCAS) {
+                break;
+            }
+            return this->CallCasPairType(inst, &Derived::ParseInstAMOCAS_Q);
+        }
+#else
+        case Function::AMO_D: {
+            /* Only AMOCAS exists at double width, operating on register pairs. */
+            if(func != AmoFunction::AMOCAS) {
+                break;
+            }
+            return this->CallCasPairType(inst, &Derived::ParseInstAMOCAS_D);
+        }
+#endif // RISCV_CFG_CPU_ENABLE_RV64
+        default:
+            break;
+        }
+
+        return ResultInvalidInstruction();
+    }
+
+    constexpr Result ParseAMO_B(RTypeInstruction inst, AmoFunction func) {
+        switch(func) {
+        case AmoFunction::AMOCAS:
+            return this->CallCasType(inst, &Derived::ParseInstAMOCAS_B);
+        case AmoFunction::AMOSWAP:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOSWAP_B);
+        case AmoFunction::AMOADD:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOADD_B);
+        case AmoFunction::AMOXOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOXOR_B);
+        case AmoFunction::AMOAND:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOAND_B);
+        case AmoFunction::AMOOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOOR_B);
+        case AmoFunction::AMOMIN:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMIN_B);
+        case AmoFunction::AMOMAX:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAX_B);
+        case AmoFunction::AMOMINU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMINU_B);
+        case AmoFunction::AMOMAXU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAXU_B);
+        default:
+            break;
+        }
+
+        return ResultInvalidInstruction();
+    }
+
+    constexpr Result ParseAMO_H(RTypeInstruction inst, AmoFunction func) {
+        switch(func) {
+        case AmoFunction::AMOCAS:
+            return this->CallCasType(inst, &Derived::ParseInstAMOCAS_H);
+        case AmoFunction::AMOSWAP:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOSWAP_H);
+        case AmoFunction::AMOADD:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOADD_H);
+        case AmoFunction::AMOXOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOXOR_H);
+        case AmoFunction::AMOAND:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOAND_H);
+        case AmoFunction::AMOOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOOR_H);
+        case AmoFunction::AMOMIN:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMIN_H);
+        case AmoFunction::AMOMAX:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAX_H);
+        case AmoFunction::AMOMINU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMINU_H);
+        case AmoFunction::AMOMAXU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAXU_H);
+        default:
+            break;
+        }
+
+        return ResultInvalidInstruction();
+    }
+
+    constexpr Result ParseAMO_W(RTypeInstruction inst, AmoFunction func) {
+        switch(func) {
+        case AmoFunction::LR: {
+            /* LR requires that rs2 is 0. */
+            if(inst.rs2() != 0) {
+                break;
+            }
+            return GetDerived()->ParseInstLR_W(CreateOutReg(inst.rd()), CreateInReg(inst.rs1()));
+        }
+        case AmoFunction::SC:
+            return this->CallStandardRType(inst, &Derived::ParseInstSC_W);
+        case AmoFunction::AMOCAS:
+            return this->CallCasType(inst, &Derived::ParseInstAMOCAS_W);
+        case AmoFunction::AMOSWAP:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOSWAP_W);
+        case AmoFunction::AMOADD:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOADD_W);
+        case AmoFunction::AMOXOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOXOR_W);
+        case AmoFunction::AMOAND:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOAND_W);
+        case AmoFunction::AMOOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOOR_W);
+        case AmoFunction::AMOMIN:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMIN_W);
+        case AmoFunction::AMOMAX:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAX_W);
+        case AmoFunction::AMOMINU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMINU_W);
+        case AmoFunction::AMOMAXU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAXU_W);
+        default:
+            break;
+        }
+
+        return ResultInvalidInstruction();
+    }
+
+#ifdef RISCV_CFG_CPU_ENABLE_RV64
+    constexpr Result ParseAMO_D(RTypeInstruction inst, AmoFunction func) {
+        switch(func) {
+        case AmoFunction::LR: {
+            /* LR requires that rs2 is 0. */
+            if(inst.rs2() != 0) {
+                break;
+            }
+            return GetDerived()->ParseInstLR_D(CreateOutReg(inst.rd()), CreateInReg(inst.rs1()));
+        }
+        case AmoFunction::SC:
+            return this->CallStandardRType(inst, &Derived::ParseInstSC_D);
+        case AmoFunction::AMOCAS:
+            return this->CallCasType(inst, &Derived::ParseInstAMOCAS_D);
+        case AmoFunction::AMOSWAP:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOSWAP_D);
+        case AmoFunction::AMOADD:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOADD_D);
+        case AmoFunction::AMOXOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOXOR_D);
+        case AmoFunction::AMOAND:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOAND_D);
+        case AmoFunction::AMOOR:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOOR_D);
+        case AmoFunction::AMOMIN:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMIN_D);
+        case AmoFunction::AMOMAX:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAX_D);
+        case AmoFunction::AMOMINU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMINU_D);
+        case AmoFunction::AMOMAXU:
+            return this->CallStandardRType(inst, &Derived::ParseInstAMOMAXU_D);
+        default:
+            break;
+        }
+
+        return ResultInvalidInstruction();
+    }
+#endif // RISCV_CFG_CPU_ENABLE_RV64
+
     constexpr Result ParseOP(RTypeInstruction inst) {
         switch(inst.function()) {
         case Function::ADD:
@@ -369,6 +561,8 @@ private:
         };
 
         switch(inst.function()) {
+        case Function::PRIV:
+            return this->ParsePRIV(inst);
         case Function::CSRRW:
             return this->CallStandardIType(inst, &Derived::ParseInstCSRRW);
         case Function::CSRRS:
@@ -388,6 +582,26 @@ private:
         return ResultInvalidInstruction();
     }
 
+    constexpr Result ParsePRIV(ITypeInstruction inst) {
+        /* These never use rd or rs1. */
+        if(inst.rd() != 0 || inst.rs1() != 0) {
+            return ResultInvalidInstruction();
+        }
+
+        switch(static_cast<PrivFunction>(inst.imm())) {
+        case PrivFunction::WFI:
+            return this->GetDerived()->ParseInstWFI();
+        case PrivFunction::WRS_NTO:
+            return this->GetDerived()->ParseInstWRS_NTO();
+        case PrivFunction::WRS_STO:
+            return this->GetDerived()->ParseInstWRS_STO();
+        default:
+            break;
+        }
+
+        return ResultInvalidInstruction();
+    }
+
 }; // class DecoderImpl
 
 } // namespace detail
@@ -40,6 +40,20 @@ public:
 
     Result InstFetch(Word* pOut, Address addr, PrivilageLevel level);
 
+    /**
+     * Translate an address to be loaded from, for accesses which bypass ReadByte etc. such as atomics.
+     *
+     * @return ResultLoadAccessFault() or ResultLoadPageFault() if the address can't be loaded from.
+    */
+    Result TranslateLoadAddress(Address* pOut, Address addr, PrivilageLevel level);
+
+    /**
+     * Translate an address to be stored to, for accesses which bypass WriteByte etc. such as atomics.
+     *
+     * @return ResultStoreAccessFault() or ResultStorePageFault() if the address can't be stored to.
+    */
+    Result TranslateStoreAddress(Address* pOut, Address addr, PrivilageLevel level);
+
     Result MappedReadByte(Byte* pOut, Address addr);
     Result MappedReadHWord(HWord* pOut, Address addr);
     Result MappedReadWord(Word* pOut, Address addr);
@@ -1,5 +1,8 @@
 #pragma once
 #include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/util/util_CacheLine.h>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -30,8 +33,45 @@ public:
 
         bool IsAddressReserved(Address addr) const noexcept;
 
-        /** Revoke a reservation at an address belonging to any hart. */
-        bool TryRevokeAnyReservation(Address addr) noexcept;
+        /**
+         * Resolve a store conditional.
+         *
+         * If this hart holds a valid reservation covering addr, it and every other reservation
+         * of the same granule are atomically invalidated, otherwise nothing happens.
+         *
+         * @return Whether the store conditional may be performed.
+        */
+        bool TryConsumeReservation(Address addr) noexcept;
+
+        /** Revoke reservations of the granule(s) covering [addr, addr + len) belonging to any hart. */
+        bool TryRevokeAnyReservation(Address addr, std::size_t len = 1) noexcept;
+
+        /**
+         * Stall until this hart's reservation becomes invalid, the wait is interrupted or times out.
+         *
+         * Returns immediately if the hart holds no reservation or an interrupt is pending,
+         * the pending interrupt is consumed either way.
+         *
+         * @param[in] timeout  Maximum time to wait, NoTimeout waits until the reservation is lost.
+        */
+        void WaitForReservationLoss(std::chrono::nanoseconds timeout = NoTimeout);
+
+        /**
+         * Start watching the granule of addr for stores without reserving it.
+         *
+         * @return Tag identifying the granule's current state, see WaitForStore.
+        */
+        DWord WatchStores(Address addr) noexcept;
+
+        /**
+         * Stall until the granule of addr is stored to after WatchStores returned tag, the wait is interrupted or times out.
+         *
+         * Stores to unrelated granules may end the wait early.
+        */
+        void WaitForStore(Address addr, DWord tag, std::chrono::nanoseconds timeout);
+
+        /** End this hart's current or next wait, this may be called from any thread. */
+        void InterruptReservationWait();
     private:
         friend class MemoryMonitor;
         Context(MemoryMonitor* pParent, Word hartId) noexcept;
@@ -39,6 +79,8 @@ public:
         MemoryMonitor* m_pParent;
         Word m_HartId;
     }; // class Context
+public:
+    static constexpr std::chrono::nanoseconds NoTimeout = std::chrono::nanoseconds::max();
 public:
     MemoryMonitor() = default;
     MemoryMonitor(const MemoryMonitor&) = delete;
@@ -52,55 +94,105 @@ private:
     void AquireReservation(Word hartIndex, Address addr) noexcept;
     void ReleaseReservation(Word hartIndex) noexcept;
 
-    void AquireSharedAccessImpl(Word hartIndex, Address addr);
     void AquireSharedAccess(Word hartIndex, Address addr);
     bool TryAquireSharedAccess(Word hartIndex, Address addr);
     void ReleaseSharedAccess(Word hartIndex);
 
-    void AquireExclusiveAccessImpl(Word hartIndex, Address addr);
     void AquireExclusiveAccess(Word hartIndex, Address addr);
     bool TryAquireExclusiveAccess(Word hartIndex, Address addr);
     void ReleaseExclusiveAccess(Word hartIndex);
 
+    void WaitForAccessStripe(std::atomic<Word>& state, Word* pCur, int* pSpins) noexcept;
+
     bool HartHasReservation(Word hartId) const noexcept;
     Address HartGetReservedAddress(Word hartId) const noexcept;
 
     bool IsAddressReserved(Address addr) const noexcept;
 
+    bool TryConsumeReservation(Word hartId, Address addr) noexcept;
     bool TryRevokeReservation(Address addr) noexcept;
+    bool TryRevokeBucket(std::size_t index) noexcept;
+
+    void WaitForReservationLoss(Word hartId, std::chrono::nanoseconds timeout);
+    DWord WatchStores(Address addr) noexcept;
+    void WaitForBucketChange(Word hartId, std::size_t index, DWord tag, std::chrono::nanoseconds timeout);
+    void InterruptReservationWait(Word hartId);
+    void NotifyReservationWaiters(std::size_t index);
+
+    std::size_t GetReservationBucketIndex(Address addr) const noexcept;
+    std::atomic<DWord>& GetReservationBucket(Address addr) const noexcept;
+    std::size_t GetAccessStripeIndex(Address addr) const noexcept;
 private:
+    /**
+     * Reservations are tracked per bucket of granules, each bucket holding (version << 1) | reserved.
+     *
+     * LR sets reserved and remembers the bucket's value, stores to a reserved bucket bump the version,
+     * and SC succeeds only if it can swap the remembered value for the next version.
+     * Unrelated granules may share a bucket, which can only cause spurious SC failures.
+    */
+    static constexpr std::size_t ReservationBucketCount = 4096;
+    static constexpr DWord ReservedFlag = 1;
+    static constexpr DWord VersionIncrement = 2;
+
     struct ReservationEntry {
         bool active;
         Address addr;
+        DWord tag;
     }; // struct Entry
 
-    struct SharedAccessEntry {
-        bool active;
-        Address addr;
-        std::mutex mutex;
-        std::condition_variable cv;
-    }; // struct SharedAccessEntry
+    /**
+     * Harts waiting for a bucket to change sleep on their own condition variable,
+     * revoking a bucket wakes the harts waiting on it.
+     *
+     * Each bucket counts its waiters, revokers only look for waiters while their bucket has some,
+     * and then only lock the harts waiting on it.
+    */
+    static constexpr std::size_t NoWaitBucket = ~static_cast<std::size_t>(0);
 
-    struct ExclAccessEntry {
-        bool active;
-        Address addr;
+    struct alignas(util::CacheLineSize) WaitEntry {
         std::mutex mutex;
         std::condition_variable cv;
-    }; // struct ExclAccessEntry
+        std::atomic<std::size_t> bucket = NoWaitBucket;
+        bool interrupted = false;
+    }; // struct WaitEntry
+
+    /**
+     * Shared/exclusive access is arbitrated by a reader/writer lock per stripe of addresses,
+     * so accesses to unrelated addresses rarely contend.
+     *
+     * Waiters spin briefly before sleeping on the state word with a futex.
+    */
+    static constexpr std::size_t AccessStripeCount = 1024;
+    static constexpr Word AccessReaderMask = 0x3FFFFFFF;
+    static constexpr Word AccessWaitersFlag = 0x40000000;
+    static constexpr Word AccessWriterFlag = 0x80000000;
+    static constexpr int AccessSpinCount = 128;
+
+    struct alignas(util::CacheLineSize) AccessStripe {
+        std::atomic<Word> state;
+    }; // struct AccessStripe
+
+    struct AccessEntry {
+        bool active;
+        std::size_t stripe;
+    }; // struct AccessEntry
 
-    std::mutex m_ExclAccessMutex;
-    std::mutex m_SharedAccessMutex;
+    /* Only ever accessed by the owning hart, each hart gets its own cache line. */
+    struct alignas(util::CacheLineSize) HartEntry {
+        ReservationEntry reserv;
+        AccessEntry shared;
+        AccessEntry excl;
+    }; // struct HartEntry
 
     Word m_HartCount;
 
-    std::size_t m_ReserveCount;
-    std::unique_ptr<ReservationEntry[]> m_ReservEntries;
+    std::unique_ptr<HartEntry[]> m_HartEntries;
+    std::unique_ptr<std::atomic<DWord>[]> m_ReservBuckets;
 
-    std::size_t m_SharedAccessCount;
-    std::unique_ptr<SharedAccessEntry[]> m_SharedEntries;
+    std::unique_ptr<WaitEntry[]> m_WaitEntries;
+    std::unique_ptr<std::atomic<Word>[]> m_ReservWaiterCounts;
 
-    std::atomic<std::size_t> m_ExclAccessCount;
-    std::unique_ptr<ExclAccessEntry[]> m_ExclEntries;
+    std::unique_ptr<AccessStripe[]> m_AccessStripes;
 }; // class MemoryMonitor
 
 } // namespace detail
@@ -0,0 +1,136 @@
+#pragma once
+#include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/diag.h>
+#include <algorithm>
+#include <array>
+#include <span>
+
+namespace riscv {
+namespace cpu {
+namespace detail {
+
+/**
+ * Recognizes guest busy-wait loops.
+ *
+ * A loop is considered spinning once a short backward branch or jump has closed SpinIterationCount iterations
+ * in a row, each of which loaded the same value from the same granule and had no side effects such as stores.
+ * The registers must also be unchanged between iterations, so counted delay or poll loops aren't spinning.
+ * Forward branches inside the loop don't end an iteration.
+*/
+class SpinDetector {
+public:
+    static constexpr Address MaxLoopLength = 64;
+    static constexpr Word SpinIterationCount = 64;
+    static constexpr std::size_t MaxGprCount = 32;
+public:
+    constexpr void Reset() noexcept {
+        m_LoopPc = 0;
+        m_LoopAddr = 0;
+        m_LoopValue = 0;
+        m_Iterations = 0;
+        m_HasLoad = false;
+        m_SideEffect = false;
+        m_WatchArmed = false;
+    }
+
+    /** Record a load of the current iteration. */
+    constexpr void OnLoad(Address addr, DWord value) noexcept {
+        addr = GetGranule(addr);
+        if(!m_HasLoad) {
+            m_LoadAddr = addr;
+            m_LoadValue = value;
+            m_HasLoad = true;
+        }
+        else if(m_LoadAddr != addr) {
+            m_SideEffect = true;
+        }
+    }
+
+    /** Record something a spin loop wouldn't do, e.g. a store. */
+    constexpr void OnSideEffect() noexcept { m_SideEffect = true; }
+
+    /**
+     * Record a taken branch or jump.
+     *
+     * @param[in] pc  Address of the branch.
+     * @param[in] target  Address branched to.
+     * @param[in] gprs  The hart's registers at the end of the iteration.
+     * @return Whether the loop closed by this branch is spinning.
+    */
+    constexpr bool OnBranch(Address pc, Address target, std::span<const NativeWord> gprs) noexcept {
+        /* Forward branches don't close a loop. */
+        if(target > pc) {
+            return false;
+        }
+
+        /* Count consecutive clean iterations of the same loop making no progress. */
+        bool isClean = pc - target <= MaxLoopLength && m_HasLoad && !m_SideEffect;
+        if(isClean && pc == m_LoopPc && m_LoadAddr == m_LoopAddr && m_LoadValue == m_LoopValue && this->IsLoopGprs(gprs)) {
+            m_Iterations++;
+        }
+        else {
+            m_LoopPc = pc;
+            m_LoopAddr = m_LoadAddr;
+            m_LoopValue = m_LoadValue;
+            m_Iterations = isClean ? 1 : 0;
+            m_WatchArmed = false;
+
+            /* Registers are only compared for clean iterations, skip the copy otherwise. */
+            if(isClean) {
+                this->SetLoopGprs(gprs);
+            }
+        }
+
+        /* Start tracking the next iteration. */
+        m_HasLoad = false;
+        m_SideEffect = false;
+
+        return m_Iterations >= SpinIterationCount;
+    }
+
+    /** Get the granule the spinning loop loads from. */
+    constexpr Address GetWatchAddress() const noexcept { return m_LoopAddr; }
+
+    /**
+     * A store watch is armed an iteration before waiting on it, so the wait can't miss stores
+     * which happened between the loop's last load and arming the watch.
+    */
+    constexpr bool IsWatchArmed() const noexcept { return m_WatchArmed; }
+    constexpr DWord GetWatchTag() const noexcept { return m_WatchTag; }
+
+    constexpr void ArmWatch(DWord tag) noexcept {
+        m_WatchTag = tag;
+        m_WatchArmed = true;
+    }
+
+    constexpr void DisarmWatch() noexcept { m_WatchArmed = false; }
+private:
+    constexpr bool IsLoopGprs(std::span<const NativeWord> gprs) const noexcept {
+        return std::equal(gprs.begin(), gprs.end(), m_LoopGprs.begin());
+    }
+
+    constexpr void SetLoopGprs(std::span<const NativeWord> gprs) noexcept {
+        diag::Assert(gprs.size() <= MaxGprCount);
+        std::copy(gprs.begin(), gprs.end(), m_LoopGprs.begin());
+    }
+
+    static constexpr Address GetGranule(Address addr) noexcept { return addr & ~static_cast<Address>(sizeof(NativeWord) - 1); }
+private:
+    Address m_LoopPc = 0;
+    Address m_LoopAddr = 0;
+    Address m_LoadAddr = 0;
+    DWord m_LoopValue = 0;
+    DWord m_LoadValue = 0;
+    Word m_Iterations = 0;
+    DWord m_WatchTag = 0;
+    bool m_HasLoad = false;
+    bool m_SideEffect = false;
+    bool m_WatchArmed = false;
+
+    /* Registers at the end of the loop's first clean iteration. */
+    std::array<NativeWord, MaxGprCount> m_LoopGprs{};
+}; // class SpinDetector
+
+} // namespace detail
+} // namespace cpu
+} // namespace riscv
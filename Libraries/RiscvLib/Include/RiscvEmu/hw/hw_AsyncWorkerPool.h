@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace riscv {
+namespace hw {
+
+/**
+ * Host threads which run slow device work, e.g. block I/O or compression, off the thread running harts.
+ *
+ * Jobs are run in submission order by whichever worker is free, see DeviceScheduler::RunAsync.
+*/
+class AsyncWorkerPool {
+public:
+    using Job = std::function<void()>;
+public:
+    AsyncWorkerPool() = default;
+    AsyncWorkerPool(const AsyncWorkerPool&) = delete;
+    ~AsyncWorkerPool();
+
+    /**
+     * Start the worker threads.
+     *
+     * @param[in] workerCount  Number of host worker threads, must be at least 1.
+    */
+    void Start(std::size_t workerCount);
+
+    /** Run the remaining jobs and wait for all workers to exit. */
+    void Stop();
+
+    /** Queue a job to run on a worker, this may be called from any thread. */
+    void Submit(Job job);
+
+    bool IsRunning() const noexcept { return m_pWorkers != nullptr; }
+private:
+    void RunWorker();
+private:
+    std::size_t m_WorkerCount = 0;
+    std::unique_ptr<std::thread[]> m_pWorkers;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Cv;
+    std::deque<Job> m_Jobs;
+    bool m_StopRequested = false;
+}; // class AsyncWorkerPool
+
+} // namespace hw
+} // namespace riscv
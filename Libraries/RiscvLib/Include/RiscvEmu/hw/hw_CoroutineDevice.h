@@ -0,0 +1,178 @@
+#pragma once
+#include <RiscvEmu/diag.h>
+#include <RiscvEmu/result.h>
+#include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/hw/hw_IDevice.h>
+#include <RiscvEmu/hw/hw_Scheduler.h>
+#include <coroutine>
+#include <utility>
+
+namespace riscv {
+namespace hw {
+
+/**
+ * Coroutine running a CoroutineDevice's model, see CoroutineDevice::Run.
+ *
+ * The coroutine starts suspended and is resumed by the device, co_return ends the device with a result.
+*/
+class DeviceTask {
+public:
+    class promise_type {
+    public:
+        DeviceTask get_return_object() noexcept { return DeviceTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        void return_value(Result res) noexcept { m_Result = res; }
+        void unhandled_exception() const noexcept { diag::Abort(); }
+
+        Result GetResult() const noexcept { return m_Result; }
+    private:
+        Result m_Result = ResultSuccess();
+    }; // class promise_type
+public:
+    constexpr DeviceTask() noexcept = default;
+    DeviceTask(const DeviceTask&) = delete;
+
+    DeviceTask(DeviceTask&& rhs) noexcept :
+        m_Handle(std::exchange(rhs.m_Handle, nullptr)) {}
+
+    DeviceTask& operator=(DeviceTask&& rhs) noexcept {
+        if(this != &rhs) {
+            this->Destroy();
+            m_Handle = std::exchange(rhs.m_Handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~DeviceTask() { this->Destroy(); }
+
+    bool IsValid() const noexcept { return static_cast<bool>(m_Handle); }
+    bool IsDone() const noexcept { return m_Handle.done(); }
+
+    void Resume() const { m_Handle.resume(); }
+
+    Result GetResult() const noexcept { return m_Handle.promise().GetResult(); }
+private:
+    explicit DeviceTask(std::coroutine_handle<promise_type> handle) noexcept :
+        m_Handle(handle) {}
+
+    void Destroy() noexcept {
+        if(m_Handle) {
+            m_Handle.destroy();
+            m_Handle = nullptr;
+        }
+    }
+private:
+    std::coroutine_handle<promise_type> m_Handle;
+}; // class DeviceTask
+
+class CoroutineDevice;
+
+/**
+ * Auto-reset event a CoroutineDevice can wait on, e.g. a guest acknowledging an interrupt.
+ *
+ * Signaling an event nobody waits on makes the next wait complete immediately.
+ * Signal must be called on the thread running the device's scheduler.
+*/
+class DeviceEvent {
+public:
+    DeviceEvent() = default;
+    DeviceEvent(const DeviceEvent&) = delete;
+
+    /** Resume the waiting device at the current tick, or record the signal if there's none. */
+    void Signal();
+
+    bool IsSignaled() const noexcept { return m_Signaled; }
+private:
+    friend class CoroutineDevice;
+
+    CoroutineDevice* m_pWaiter = nullptr;
+    bool m_Signaled = false;
+}; // class DeviceEvent
+
+/**
+ * Base for devices modelled as sequential code instead of a state machine polled at a fixed frequency.
+ *
+ * Run is a coroutine which awaits Delay or an event, the device is only processed at the tick it's resumed at.
+ * i.e.
+ *
+ *     DeviceTask Run() override {
+ *         while(true) {
+ *             co_await this->Delay(1000);
+ *             m_pIrq->SignalInterrupt();
+ *             co_await this->WaitFor(m_IrqAck);
+ *         }
+ *     }
+*/
+class CoroutineDevice : public IDevice {
+public:
+    class DelayAwaiter {
+    public:
+        constexpr bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) const noexcept;
+        constexpr void await_resume() const noexcept {}
+    private:
+        friend class CoroutineDevice;
+
+        constexpr DelayAwaiter(CoroutineDevice* pDev, DWord ticks) noexcept :
+            m_pDev(pDev),
+            m_Ticks(ticks) {}
+    private:
+        CoroutineDevice* m_pDev;
+        DWord m_Ticks;
+    }; // class DelayAwaiter
+
+    class EventAwaiter {
+    public:
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<>) const noexcept;
+        constexpr void await_resume() const noexcept {}
+    private:
+        friend class CoroutineDevice;
+
+        constexpr EventAwaiter(CoroutineDevice* pDev, DeviceEvent* pEvent) noexcept :
+            m_pDev(pDev),
+            m_pEvent(pEvent) {}
+    private:
+        CoroutineDevice* m_pDev;
+        DeviceEvent* m_pEvent;
+    }; // class EventAwaiter
+public:
+    /**
+     * Constructor, Run is started on the first tick after the device is added to pScheduler.
+     *
+     * @param[in] pScheduler  Scheduler the device will be added to.
+    */
+    CoroutineDevice(DeviceScheduler* pScheduler) noexcept;
+
+    Result ProcessCycle() override;
+
+    DWord GetNextDeadline(DWord now, DWord periodicTick) const override;
+protected:
+    /** The device's model, which may return a failure to stop the scheduler. */
+    virtual DeviceTask Run() = 0;
+
+    /** Suspend for at least one tick, resuming ticks after the current one. */
+    DelayAwaiter Delay(DWord ticks) noexcept { return DelayAwaiter(this, ticks); }
+
+    /** Suspend until an event is signaled, without any deadline in between. */
+    EventAwaiter WaitFor(DeviceEvent& event) noexcept { return EventAwaiter(this, &event); }
+
+    /** Get the current scheduler tick. */
+    DWord GetTime() const noexcept { return m_pScheduler->GetTime(); }
+private:
+    friend class DeviceEvent;
+
+    void Wake();
+private:
+    DeviceScheduler* m_pScheduler;
+    DeviceTask m_Task;
+
+    /* Tick the task waits for, NoDeadline while it waits for an event or has returned. */
+    DWord m_WakeTick;
+}; // class CoroutineDevice
+
+} // namespace hw
+} // namespace riscv
@@ -11,7 +11,23 @@ namespace hw {
  *
  * See hw::DeviceScheduler.
 */
-class IDevice : Peripheral {
+class IDevice : public Peripheral {
+public:
+    /** See GetNextDeadline. */
+    static constexpr DWord NoDeadline = ~static_cast<DWord>(0);
+
+    /** How the scheduler runs ProcessCycle, see GetExecPolicy. */
+    enum class ExecPolicy {
+        /** ProcessCycle runs on the scheduler's thread at the device's deadline. */
+        Synchronous,
+
+        /**
+         * ProcessCycle is started at the device's deadline on a DeviceScheduler worker thread,
+         * the device isn't processed again until it returns.
+         * The device must synchronize state it shares with MMIO accesses itself.
+        */
+        Asynchronous
+    }; // enum class ExecPolicy
 public:
     constexpr IDevice(DWordS updateFreq) noexcept :
         m_UpdateFreq(updateFreq) {}
@@ -19,6 +35,21 @@ public:
     constexpr auto GetFreq() const noexcept { return m_UpdateFreq; }
 
     constexpr virtual Result ProcessCycle() = 0;
+
+    /**
+     * Get the scheduler tick the device next has work at, called after each ProcessCycle.
+     *
+     * Devices which know they're idle can return a later tick, or NoDeadline until they're
+     * rescheduled with DeviceScheduler::ScheduleDevice, so the scheduler skips the idle period.
+     *
+     * @param[in] now  Tick the device was just processed at.
+     * @param[in] periodicTick  Tick the device would next run at given its update frequency.
+     * @return periodicTick by default.
+    */
+    constexpr virtual DWord GetNextDeadline([[maybe_unused]] DWord now, DWord periodicTick) const { return periodicTick; }
+
+    /** Get how the scheduler runs ProcessCycle, ExecPolicy::Synchronous by default. */
+    constexpr virtual ExecPolicy GetExecPolicy() const { return ExecPolicy::Synchronous; }
 private:
     DWordS m_UpdateFreq;
 }; // class IDevice
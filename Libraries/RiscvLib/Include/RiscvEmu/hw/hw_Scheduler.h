@@ -1,8 +1,15 @@
 #pragma once
 #include <RiscvEmu/result.h>
 #include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/hw/hw_AsyncWorkerPool.h>
 #include <RiscvEmu/hw/hw_IDevice.h>
-#include <RiscvEmu/util/util_RemovablePrioQueue.h>
+#include <RiscvEmu/util/util_IndexedHeap.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace riscv {
@@ -12,16 +19,19 @@ namespace hw {
  * This is a scheduler for hw::IDevice devices.
  *
  * This will schedule devices relative to eachother and an internal timer, not in realtime.
- * The timer will increment every time ProcessCycle is called.
+ * The timer counts ticks of TickFreq and only moves when the caller advances it, devices are
+ * processed at the deadlines they're due at instead of the scheduler being polled every tick.
  *
- * When a device will be processed is calculated by timer + timer_max / dev_feq.
+ * A device's next deadline is its last deadline + TickFreq / dev_freq, unless the device reports otherwise,
+ * see IDevice::GetNextDeadline.
  *
- * i.e. if timer_max is 10, devA runs at 5hz, and devB runs at 10hz
- * devB will run every cycle (10/10 = 1), and devA will run every alternating cycle (10/5 = 2).)
+ * Deadlines are kept in an indexed heap, so rescheduling or removing a device is O(log n).
  *
- * NOTE: timer_max is currently non-configurable.
+ * Slow work can be moved off the scheduler's thread with RunAsync, its completion is delivered back
+ * as a timed event processed in order with device deadlines, see also IDevice::ExecPolicy.
  *
- * TODO: Make timer_max configurable.
+ * i.e. if TickFreq is 10, devA runs at 5hz, and devB runs at 10hz
+ * devB will run every tick (10/10 = 1), and devA will run every alternating tick (10/5 = 2).
 */
 class DeviceScheduler {
 public:
@@ -43,22 +53,64 @@ public:
     private:
         IDevice* m_pDev;
     }; // class SchdResult
+public:
+    /** Ticks per second of virtual time. */
+    static constexpr DWord TickFreq = 1'000'000;
+
+    static constexpr DWord NoDeadline = IDevice::NoDeadline;
+
+    /** Work started by RunAsync, this runs on a worker thread. */
+    using AsyncWork = std::function<Result()>;
+
+    /** Called on the scheduler's thread with the result of AsyncWork once it's complete and due. */
+    using AsyncCompletion = std::function<Result(Result)>;
 public:
     /** Default constructor. */
     DeviceScheduler();
+    DeviceScheduler(const DeviceScheduler&) = delete;
+    ~DeviceScheduler();
 
     /**
-     * Processes a single cycle.
-     *
-     * If any device return a non-ResultSuccess result when its ProcessCycle
-     * function is called, no further devices will be processed and the internal
-     * timer will not be updated, a SchdResult containing the Result and offending
-     * device will be returned.
+     * Processes a single tick, same as Advance(1).
      *
      * @return IDevice::ProcessCycle error if non-Success, otherwise ResultSuccess().
      * */
     SchdResult ProcessCycle();
 
+    /**
+     * Advance virtual time, processing every device deadline within [GetTime(), GetTime() + tickCount) in order.
+     *
+     * While a device is processed GetTime() returns the deadline it's processed at.
+     * If any device return a non-ResultSuccess result when its ProcessCycle
+     * function is called, no further devices will be processed and the timer
+     * is left at the offending device's deadline, a SchdResult containing the Result
+     * and offending device will be returned.
+     *
+     * @param[in] tickCount  Number of ticks to advance by.
+     * @return IDevice::ProcessCycle error if non-Success, otherwise ResultSuccess().
+    */
+    SchdResult Advance(DWord tickCount);
+
+    /**
+     * Skip ahead to the next device deadline and process it, advancing at most maxTicks.
+     *
+     * This is Advance(GetNextDeadline() - GetTime() + 1), limited to maxTicks.
+     * Nothing happens if no device has a deadline and maxTicks is NoDeadline.
+     *
+     * @param[in] maxTicks  Maximum number of ticks to advance by.
+     * @return IDevice::ProcessCycle error if non-Success, otherwise ResultSuccess().
+    */
+    SchdResult AdvanceToNextDeadline(DWord maxTicks = NoDeadline);
+
+    /** Get the current virtual time in ticks. */
+    DWord GetTime() const noexcept { return m_Timer; }
+
+    /** Get the earliest device deadline, or NoDeadline if no device has one. */
+    DWord GetNextDeadline() const;
+
+    /** Get the number of devices added to the scheduler. */
+    std::size_t GetDeviceCount() const noexcept { return m_Devices.size(); }
+
     /**
      * Add a device to the scheduler.
      *
@@ -74,49 +126,125 @@ public:
      * @return ResultSuccess()
     */
     Result RemoveDevice(IDevice* pDev);
+
+    /**
+     * Move a device's deadline, e.g. to wake a device which reported NoDeadline.
+     *
+     * @param[in] pDev  Device to schedule.
+     * @param[in] tick  New deadline, deadlines in the past are processed on the next advance.
+     * @return ResultSuccess()
+    */
+    Result ScheduleDevice(IDevice* pDev, DWord tick);
+
+    /**
+     * Set the number of worker threads running async work, 0 runs it on the calling thread when it's started.
+     *
+     * Work which was already started is completed first.
+     *
+     * @param[in] workerCount  Number of host worker threads.
+    */
+    void SetAsyncWorkerCount(std::size_t workerCount);
+
+    /**
+     * Start work on a worker thread and deliver its result to a completion as a timed event.
+     *
+     * The completion is processed at GetTime() + latency, or as soon as the work is noticed to be complete
+     * if it takes longer than that, so the result is deterministic as long as the host keeps up.
+     * Completions typically update device state and signal an interrupt.
+     * If the completion returns a failure it's returned by Advance along with pDev.
+     *
+     * @param[in] pDev  Device the work belongs to, its pending completions are dropped by RemoveDevice.
+     * @param[in] work  Work to run.
+     * @param[in] completion  Completion to call with the work's result.
+     * @param[in] latency  Ticks the work takes in virtual time.
+     * @return ResultSuccess()
+    */
+    Result RunAsync(IDevice* pDev, AsyncWork work, AsyncCompletion completion, DWord latency = 0);
+
+    /** Wait for all work started by RunAsync to complete, its completions are then due on the next advance. */
+    void WaitForAsync();
 private:
     class DeviceContainer {
     public:
-        constexpr DeviceContainer(IDevice* pDev, DWordS next = 0) noexcept :
+        constexpr DeviceContainer(IDevice* pDev, DWord next = 0) noexcept :
             m_pDev(pDev),
             m_NextCycle(next) {}
 
         constexpr auto GetDevice() const noexcept { return m_pDev; }
         constexpr auto GetNextCycle() const noexcept { return m_NextCycle; }
-
-        constexpr bool operator==(const DeviceContainer& rhs) const noexcept { return this->m_pDev == rhs.m_pDev; }
     private:
         IDevice* m_pDev;
-        DWordS m_NextCycle;
+        DWord m_NextCycle;
     }; // class DeviceContainer
 
     class CompareImpl {
     public:
-        constexpr CompareImpl(DeviceScheduler* pParent) :
-            m_pParent(pParent) {}
-
         constexpr bool operator()(const DeviceContainer& lhs, const DeviceContainer& rhs) const noexcept {
-            return this->GetNextCycle(lhs) < this->GetNextCycle(rhs);
+            return lhs.GetNextCycle() < rhs.GetNextCycle();
         }
-    private:
-        constexpr DWordS GetNextCycle(const DeviceContainer& pair) const noexcept {
-            auto next = pair.GetNextCycle();
-            if(next <= m_pParent->m_Timer) {
-                return next + DeviceScheduler::c_TimerFreq;
-            }
-            return next;
-        }
-    private:
-        DeviceScheduler* const m_pParent;
     }; // class CompareImpl
+
+    using DeviceQueue = util::IndexedHeap<DeviceContainer, CompareImpl>;
+
+    struct DeviceEntry {
+        /* Queue handle, InvalidHandle while the device has no deadline or its cycle is running async. */
+        DeviceQueue::Handle handle;
+
+        /* Set while an async ProcessCycle runs, ScheduleDevice then records the earliest tick requested. */
+        bool isBusy;
+        DWord requestedTick;
+    }; // struct DeviceEntry
+
+    struct AsyncEvent {
+        DWord tick;
+
+        /* Submission order, breaks ties between events due at the same tick. */
+        DWord seq;
+
+        IDevice* pDev;
+        Result result;
+        AsyncCompletion completion;
+    }; // struct AsyncEvent
+
+    class AsyncEventCompareImpl {
+    public:
+        constexpr bool operator()(const AsyncEvent& lhs, const AsyncEvent& rhs) const noexcept {
+            return lhs.tick != rhs.tick ? lhs.tick < rhs.tick : lhs.seq < rhs.seq;
+        }
+    }; // class AsyncEventCompareImpl
+
+    using AsyncEventQueue = util::IndexedHeap<AsyncEvent, AsyncEventCompareImpl>;
 private:
     IDevice* GetTopDevice() const;
-    DWordS GetTopCycle() const;
-    DWordS CalculateNextCycle(DWordS freq) const noexcept;
+    DWord GetTopCycle() const;
+    DWord CalculatePeriodicCycle(DWord from, DWordS freq) const noexcept;
+
+    SchdResult ProcessDevice();
+    SchdResult ProcessAsyncEvent();
+    void StartAsyncCycle(IDevice* pDev);
+    Result CompleteAsyncCycle(IDevice* pDev, DWord due, Result res);
+    void PostAsyncEvent(AsyncEvent&& event);
+    void CollectAsyncEvents();
 private:
-    util::RemovablePrioQueue<DeviceContainer, std::vector<DeviceContainer>, CompareImpl> m_Queue;
-    static constexpr DWordS c_TimerFreq = 1'000'000;
-    DWordS m_Timer;
+    DeviceQueue m_Queue;
+
+    std::unordered_map<IDevice*, DeviceEntry> m_Devices;
+
+    DWord m_Timer;
+
+    /* Completions which are due, ordered by tick. */
+    AsyncEventQueue m_AsyncEvents;
+    DWord m_AsyncSeq = 0;
+
+    /* Completions posted by workers, moved to m_AsyncEvents by the scheduler's thread. */
+    std::mutex m_AsyncMutex;
+    std::condition_variable m_AsyncCv;
+    std::vector<AsyncEvent> m_AsyncDone;
+    std::atomic<bool> m_HasAsyncDone = false;
+    std::size_t m_AsyncInFlight = 0;
+
+    /* Declared last so workers are stopped before the state they post to is destroyed. */
+    AsyncWorkerPool m_AsyncPool;
 }; // class DeviceScheduler
 
 } // namespace hw
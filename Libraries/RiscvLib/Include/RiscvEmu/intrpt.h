@@ -1,3 +1,4 @@
+#include <RiscvEmu/intrpt/intrpt_CLINT.h>
 #include <RiscvEmu/intrpt/intrpt_ISource.h>
 #include <RiscvEmu/intrpt/intrpt_ITarget.h>
 #include <RiscvEmu/intrpt/intrpt_ITargetCtlrBridge.h>
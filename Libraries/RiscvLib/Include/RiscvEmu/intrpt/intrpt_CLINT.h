@@ -0,0 +1,147 @@
+#pragma once
+#include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/cpu/cpu_ITimeSource.h>
+#include <RiscvEmu/hw/hw_IDevice.h>
+#include <RiscvEmu/hw/hw_Scheduler.h>
+#include <RiscvEmu/mem/mem_IMmioDev.h>
+#include <vector>
+
+namespace riscv {
+namespace intrpt {
+
+/**
+ * Core local interruptor, providing each hart's machine timer and software interrupts.
+ *
+ * The register layout is the SiFive CLINT one, which ACLINT's MSWI and MTIMER devices keep:
+ * msip at 0x0 + 4 * hart, mtimecmp at 0x4000 + 8 * hart and mtime at 0xBFF8.
+ *
+ * mtime isn't a counter, it's derived from the hw::DeviceScheduler's virtual time whenever it's read.
+ * The timer only takes part in scheduling as a single deadline, at the earliest tick any hart's mtimecmp is reached.
+ * Harts can read mtime through their time CSR by using GetTimeSource, see System::SetTimeSource.
+ *
+ * Like the scheduler, registers must only be accessed from the thread advancing it, e.g. harts run by System::Run.
+*/
+class CLINT : public mem::IMmioDev {
+public:
+    /** Receives changes to the interrupt lines the CLINT drives. */
+    class IHartTarget {
+    public:
+        virtual ~IHartTarget() noexcept = default;
+
+        /** Called when a hart's machine timer interrupt becomes pending or is cleared. */
+        virtual void NotifyTimerInterrupt(Word hartId, bool pending) = 0;
+
+        /** Called when a hart's machine software interrupt becomes pending or is cleared. */
+        virtual void NotifySoftwareInterrupt(Word hartId, bool pending) = 0;
+    }; // class IHartTarget
+public:
+    static constexpr DWord DefaultTimebaseFreq = 10'000'000;
+    static constexpr Word MaxHartCount = 4095;
+public:
+    CLINT() noexcept;
+    CLINT(const CLINT&) = delete;
+    virtual ~CLINT();
+
+    /**
+     * Initialize the CLINT and add its timer to a scheduler.
+     *
+     * @param[in] hartCount  Number of harts, at most MaxHartCount.
+     * @param[in] pScheduler  Scheduler providing virtual time, this must outlive the CLINT.
+     * @param[in] timebaseFreq  Frequency mtime counts at.
+     * @return ResultCLINTInvalidHartCount() if hartCount is out of range, otherwise ResultSuccess().
+    */
+    Result Initialize(Word hartCount, hw::DeviceScheduler* pScheduler, DWord timebaseFreq = DefaultTimebaseFreq);
+
+    /** Set who is notified of interrupt line changes. */
+    void SetTarget(IHartTarget* pTarget) noexcept { m_pTarget = pTarget; }
+
+    Word GetHartCount() const noexcept { return static_cast<Word>(m_Harts.size()); }
+
+    /** Get the current mtime value. */
+    DWord ReadTime() const noexcept;
+
+    /** Set mtime, moving every hart's timer deadline accordingly. */
+    void WriteTime(DWord val);
+
+    DWord ReadTimeCompare(Word hartId) const noexcept;
+    void WriteTimeCompare(Word hartId, DWord val);
+
+    bool ReadSoftwarePending(Word hartId) const noexcept;
+    void WriteSoftwarePending(Word hartId, bool val);
+
+    bool IsTimerPending(Word hartId) const noexcept;
+
+    /** Get a time source reading mtime, at the timebase frequency. */
+    const cpu::ITimeSource* GetTimeSource() const noexcept { return &m_TimeSource; }
+public:
+    virtual NativeWord GetMappedSize() override;
+
+    virtual Result ReadByte(Byte* pOut, Address addr) override;
+    virtual Result ReadHWord(HWord* pOut, Address addr) override;
+    virtual Result ReadWord(Word* pOut, Address addr) override;
+    virtual Result ReadDWord(DWord* pOut, Address addr) override;
+    virtual Result WriteByte(Byte in, Address addr) override;
+    virtual Result WriteHWord(HWord in, Address addr) override;
+    virtual Result WriteWord(Word in, Address addr) override;
+    virtual Result WriteDWord(DWord in, Address addr) override;
+private:
+    /** Processes timer deadlines, the CLINT can't be an IDevice itself as it already is an IMmioDev. */
+    class TimerDevice : public hw::IDevice {
+    public:
+        TimerDevice(CLINT* pParent) noexcept;
+
+        virtual Result ProcessCycle() override;
+        virtual DWord GetNextDeadline(DWord now, DWord periodicTick) const override;
+    private:
+        CLINT* m_pParent;
+    }; // class TimerDevice
+
+    class TimeSource : public cpu::ITimeSource {
+    public:
+        TimeSource(const CLINT* pParent) noexcept :
+            m_pParent(pParent) {}
+
+        virtual DWord GetTime() const override { return m_pParent->ReadTime(); }
+    private:
+        const CLINT* m_pParent;
+    }; // class TimeSource
+
+    struct HartState {
+        DWord timeCompare;
+
+        /* Tick mtime reaches timeCompare at, NoDeadline if it won't. */
+        DWord deadline;
+
+        bool timerPending;
+        bool softwarePending;
+    }; // struct HartState
+private:
+    DWord TicksToTime(DWord ticks) const noexcept;
+    DWord TimeToTicks(DWord time) const noexcept;
+
+    void UpdateTimer(Word hartId);
+    void UpdateNextDeadline();
+    void ProcessTimers();
+
+    void SetTimerPending(Word hartId, bool pending);
+
+    bool ReadRegister(DWord* pOut, Address addr, std::size_t size) const noexcept;
+    bool WriteRegister(DWord val, Address addr, std::size_t size);
+private:
+    hw::DeviceScheduler* m_pScheduler;
+    IHartTarget* m_pTarget;
+    DWord m_TimebaseFreq;
+
+    /* mtime is TicksToTime(scheduler time) + m_TimeOffset, wrapping. */
+    DWord m_TimeOffset;
+
+    DWord m_NextDeadline;
+
+    std::vector<HartState> m_Harts;
+
+    TimerDevice m_TimerDevice;
+    TimeSource m_TimeSource;
+}; // class CLINT
+
+} // namespace intrpt
+} // namespace riscv
@@ -4,7 +4,7 @@
 #include <RiscvEmu/intrpt/intrpt_ITarget.h>
 #include <RiscvEmu/mem/mem_AlignedMmioDev.h>
 #include <RiscvEmu/mem/mem_MemoryController.h>
-#include <queue>
+#include <array>
 #include <source_location>
 #include <vector>
 #include <memory>
@@ -12,10 +12,23 @@
 namespace riscv {
 namespace intrpt {
 
+/**
+ * Platform-level interrupt controller.
+ *
+ * Sources which can be claimed are kept in a bitmap per priority level, alongside masks of the non-empty words and levels.
+ * A claim scans the highest non-empty levels above the target's threshold, masked by the target's enable bits,
+ * so claiming costs a few count-zero scans however many interrupts are pending.
+*/
 class PLIC {
 public:
     using TargetPtrT = std::shared_ptr<ITarget>;
+
+    /** Highest source priority, priorities and thresholds are clamped to this. Priority 0 never interrupts. */
+    static constexpr Word MaxPriority = 7;
 public:
+    PLIC() = default;
+    PLIC(const PLIC&) = delete;
+
     Result Initialize(int sourceCount, int targetCount);
 
     Word GetTargetCount() const noexcept;
@@ -32,10 +45,20 @@ public:
 
     bool GetEnabled(int source, int target) const noexcept;
     void SetEnabled(int source, int target, bool val) noexcept;
-private:
+
+    /**
+     * Access a register by word index into the PLIC's address space, as a guest word access at index * 4 through
+     * GetMmioDevice does.
+     *
+     * Registers of sources and contexts which don't exist read as zero and ignore writes.
+    */
     Word ReadRegister(Word index);
     void WriteRegister(Word index, Word val);
 
+    /** Get the device guests access registers through, e.g. for mem::MemoryController::AddMmioDev. */
+    mem::IMmioDev* GetMmioDevice() noexcept { return &m_MmioIterface; }
+private:
+
     Word ReadPriorityReg(Word index) const noexcept;
     void WritePriorityReg(Word index, Word val) noexcept;
 
@@ -60,17 +83,16 @@ private:
     bool WriteContextRegImpl(Word index, Word val) noexcept;
 private:
     class Source;
-    struct QueueData;
+    class Target;
 
-    void CleanupQueue();
+    void SetClaimable(const Source& src, bool claimable) noexcept;
+    bool FindClaimable(Word* pOut, const Target& target) const noexcept;
 
-    void AddSourceToQueue(Source* pSrc);
-    Word ClaimTopRequest();
+    void AddClaimableSource(Source* pSrc);
+    Word ClaimRequest(Target& target);
 
     void NotifyAllTargetsIRQAvailable();
 
-    const QueueData& GetQueueTop() const;
-
     bool TargetIdValid(Word id) const noexcept;
     bool SourceIdValid(Word id) const noexcept;
 
@@ -79,6 +101,9 @@ private:
 private:
     class MmioInterface : public mem::IMmioDev {
     public:
+        MmioInterface(PLIC* pParent) noexcept :
+            m_pParent(pParent) {}
+
         virtual NativeWord GetMappedSize() override;
 
         virtual Result ReadByte(Byte* pOut, Address addr) override;
@@ -131,15 +156,6 @@ private:
         Word m_PendingCount;
     }; // class Source
 
-    struct QueueData {
-        QueueData(Source* p, Word prio) noexcept;
-
-        auto operator<=>(const QueueData& rhs) const noexcept;
-        
-        Source* pSrc;
-        Word priority;
-    }; // struct QueueData
-
     class Target : public detail::ITargetForCtrl {
     public:
         virtual bool HasPendingIRQ() override;
@@ -155,28 +171,32 @@ private:
 
         void Initialize(PLIC* pParent, TargetPtrT&& pTarget, Word id, Word pending);
 
-        void Finalize();
-
-        bool IsInitialized() const noexcept;
-
         Word ReadEnableReg(Word index) const;
         void WriteEnableReg(Word index, Word val);
 
         Word ReadPrioThreshold() const noexcept;
         void WritePrioThreshold(Word val) noexcept;
 
-        bool HasEnabledIRQ(Word src);
-
-        bool CanTakeTopIRQ();
+        bool HasClaimableIRQ() const noexcept;
 
         Result NotifyAvailableIRQImpl();
     private:
-        TargetPtrT m_pTarget;
         std::vector<Word> m_EnableBits;
         PLIC* m_pParent;
         Word m_PrioThreshold;
         Word m_Id;
     }; // struct Target
+
+    /* Enough words for one bit per source at the largest source count. */
+    static constexpr std::size_t SourceWordCount = 1024 / WordBitLen;
+
+    struct PriorityLevel {
+        /* Sources at this priority which are pending and not claimed, one bit per source. */
+        std::array<Word, SourceWordCount> claimable;
+
+        /* Bit n is set while claimable[n] is non-zero. */
+        Word nonEmptyWords;
+    }; // struct PriorityLevel
 private:
     bool m_Claimed;
 
@@ -190,9 +210,12 @@ private:
 
     std::vector<Word> m_PendingBits;
 
-    std::priority_queue<QueueData> m_Queue;
+    std::array<PriorityLevel, MaxPriority + 1> m_Levels;
+
+    /* Bit n is set while m_Levels[n] has a claimable source. */
+    Word m_NonEmptyLevels;
 
-    mem::AlignedMmioDev<MmioInterface> m_MmioIterface;
+    mem::AlignedMmioDev<MmioInterface> m_MmioIterface{ this };
 }; // class PLIC
 
 } // namespace intrpt
@@ -16,6 +16,9 @@ class ResultPLICInvalidTargetCount : public result::ErrorBase<detail::ModuleId,
 class ResultPLICSourceAlreadyTaken : public result::ErrorBase<detail::ModuleId, 102> {};
 class ResultPLICTargetAlreadyTaken : public result::ErrorBase<detail::ModuleId, 103> {};
 
+/* CLINT errors. */
+class ResultCLINTInvalidHartCount : public result::ErrorBase<detail::ModuleId, 200> {};
+
 /* Target results. */
 class ResultTargetIntrptPending : public result::ErrorBase<detail::ModuleId, 1000> {};
 class ResultTargetIntrptAccept  : public result::ErrorBase<detail::ModuleId, 1001> {};
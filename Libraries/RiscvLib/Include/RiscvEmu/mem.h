@@ -4,3 +4,4 @@
 #include <RiscvEmu/mem/mem_MemoryDevice.h>
 #include <RiscvEmu/mem/mem_RegionInfo.h>
 #include <RiscvEmu/mem/mem_Result.h>
+#include <RiscvEmu/mem/mem_RomDevice.h>
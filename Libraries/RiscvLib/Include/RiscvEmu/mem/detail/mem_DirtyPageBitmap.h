@@ -0,0 +1,126 @@
+#pragma once
+#include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/diag.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace riscv {
+namespace mem {
+namespace detail {
+
+/**
+ * This tracks which pages of a block of memory have been written to, one bit per page.
+ *
+ * Tracking is disabled until Initialize is called, while disabled MarkDirty is a single branch.
+ * Writes may be marked from any thread, including while Initialize enables tracking.
+ * Moving and Finalize require that no other thread is using the bitmap.
+*/
+class DirtyPageBitmap {
+public:
+    static constexpr std::size_t PageShift = 12;
+    static constexpr std::size_t PageSize = std::size_t(1) << PageShift;
+    static constexpr std::size_t PagesPerWord = sizeof(DWord) * 8;
+
+    DirtyPageBitmap() noexcept = default;
+
+    DirtyPageBitmap(DirtyPageBitmap&& other) noexcept :
+        m_pStorage(std::move(other.m_pStorage)),
+        m_pBits(other.m_pBits.exchange(nullptr, std::memory_order_relaxed)),
+        m_WordCount(std::exchange(other.m_WordCount, 0)) {}
+
+    DirtyPageBitmap& operator=(DirtyPageBitmap&& other) noexcept {
+        m_pStorage = std::move(other.m_pStorage);
+        m_pBits.store(other.m_pBits.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        m_WordCount = std::exchange(other.m_WordCount, 0);
+        return *this;
+    }
+
+    /**
+     * Enable tracking for a block of memory with all pages initially clean.
+     *
+     * The bitmap is published once it's complete, so this is safe while other threads mark writes.
+     * If tracking is already enabled the existing bitmap is kept, it's never swapped under running writers.
+     * Initialize isn't safe to call from multiple threads at once.
+    */
+    void Initialize(std::size_t length) {
+        if(this->IsEnabled()) {
+            return;
+        }
+
+        m_WordCount = (((length + PageSize - 1) >> PageShift) + PagesPerWord - 1) / PagesPerWord;
+        m_pStorage = std::make_unique<std::atomic<DWord>[]>(m_WordCount);
+        m_pBits.store(m_pStorage.get(), std::memory_order_release);
+    }
+
+    /** Disable tracking and free the bitmap. */
+    void Finalize() noexcept {
+        m_pBits.store(nullptr, std::memory_order_relaxed);
+        m_pStorage.reset();
+        m_WordCount = 0;
+    }
+
+    bool IsEnabled() const noexcept { return m_pBits.load(std::memory_order_acquire) != nullptr; }
+
+    /** Retrieve the number of DWords needed to hold the bitmap, 0 while tracking is disabled. */
+    std::size_t GetWordCount() const noexcept { return this->IsEnabled() ? m_WordCount : 0; }
+
+    /** Mark the pages covering [offset, offset + len) as dirty, len must not exceed a page. */
+    void MarkDirty(Address offset, std::size_t len) noexcept {
+        auto* pBits = m_pBits.load(std::memory_order_acquire);
+        if(!pBits) {
+            return;
+        }
+
+        this->MarkPage(pBits, offset >> PageShift);
+
+        /* Accesses may straddle a page boundary. */
+        auto lastPage = (offset + len - 1) >> PageShift;
+        if(lastPage != offset >> PageShift) {
+            this->MarkPage(pBits, lastPage);
+        }
+    }
+
+    /**
+     * Atomically fetch and clear the bitmap.
+     *
+     * Bit n of word n / 64 set means page n was written since the previous call.
+     *
+     * @param[out] out  Receives the bitmap, must hold at least GetWordCount() words.
+    */
+    void FetchAndClear(std::span<DWord> out) noexcept {
+        auto* pBits = m_pBits.load(std::memory_order_acquire);
+        if(!pBits) {
+            return;
+        }
+
+        diag::Assert(out.size() >= m_WordCount);
+
+        for(std::size_t i = 0; i < m_WordCount; i++) {
+            /* Skip the read-modify-write for clean words. */
+            out[i] = pBits[i].load(std::memory_order_relaxed) ? pBits[i].exchange(0, std::memory_order_acq_rel) : 0;
+        }
+    }
+private:
+    static void MarkPage(std::atomic<DWord>* pBits, std::size_t page) noexcept {
+        auto& word = pBits[page / PagesPerWord];
+        auto bit = DWord(1) << (page % PagesPerWord);
+
+        /* Repeated stores to a dirty page only cost a load, avoiding contention on the bitmap. */
+        if(!(word.load(std::memory_order_relaxed) & bit)) {
+            word.fetch_or(bit, std::memory_order_release);
+        }
+    }
+private:
+    std::unique_ptr<std::atomic<DWord>[]> m_pStorage;
+
+    /* m_pStorage once it's fully initialized, readers only go through this. */
+    std::atomic<std::atomic<DWord>*> m_pBits = nullptr;
+    std::size_t m_WordCount = 0;
+}; // class DirtyPageBitmap
+
+} // namespace detail
+} // namespace mem
+} // namespace riscv
@@ -0,0 +1,25 @@
+#pragma once
+#include <RiscvEmu/mem/detail/mem_RegionBase.h>
+#include <RiscvEmu/mem/detail/mem_MemoryDeviceImpl.h>
+
+namespace riscv {
+namespace mem {
+namespace detail {
+
+/**
+ * This is a range of an mmio device's address space which may be fetched from directly, see IMmioDev::GetReadOnlyBacking.
+*/
+class ExecRegion : public RegionBase, private MemoryDeviceImpl<const Byte*> {
+public:
+    constexpr ExecRegion(Address addr, NativeWord len, const Byte* pMem) noexcept :
+        RegionBase(addr, len),
+        MemoryDeviceImpl(std::move(pMem)) {}
+
+    constexpr const Byte* GetHostPointer(Address addr) noexcept { return this->GetHostPointerImpl(addr); }
+
+    constexpr Result ReadWord(Word* pOut, Address addr) { return this->ReadWordImpl(pOut, addr); }
+}; // class ExecRegion
+
+} // namespace detail
+} // namespace mem
+} // namespace riscv
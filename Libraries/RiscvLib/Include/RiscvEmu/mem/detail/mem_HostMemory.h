@@ -0,0 +1,46 @@
+#pragma once
+#include <RiscvEmu/result.h>
+#include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/mem/mem_RegionInfo.h>
+#include <cstddef>
+
+namespace riscv {
+namespace mem {
+namespace detail {
+
+/**
+ * This owns a block of host memory used to back guest memory.
+ *
+ * Memory is either zero initialized or mapped directly from a file, see FileMapMode.
+*/
+class HostMemory {
+public:
+    HostMemory() noexcept;
+    HostMemory(HostMemory&& other) noexcept;
+    HostMemory(const HostMemory&) = delete;
+    ~HostMemory();
+
+    HostMemory& operator=(HostMemory&& other) noexcept;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    /** Allocate zero initialized memory. */
+    Result Initialize(std::size_t length);
+
+    /** Map memory from a file, see RegionInfo. */
+    Result InitializeFromFile(std::size_t length, const char* pFilePath, FileMapMode mode);
+
+    void Finalize() noexcept;
+
+    Byte* Get() const noexcept { return m_pMem; }
+
+    std::size_t GetLength() const noexcept { return m_Length; }
+
+    Byte& operator[](std::size_t index) const noexcept { return m_pMem[index]; }
+private:
+    Byte* m_pMem;
+    std::size_t m_Length;
+}; // class HostMemory
+
+} // namespace detail
+} // namespace mem
+} // namespace riscv
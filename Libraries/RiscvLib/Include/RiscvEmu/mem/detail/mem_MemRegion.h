@@ -1,26 +1,46 @@
 #pragma once
 #include <RiscvEmu/mem/mem_RegionInfo.h>
 #include <RiscvEmu/mem/mem_Result.h>
+#include <RiscvEmu/mem/detail/mem_HostMemory.h>
 #include <RiscvEmu/mem/detail/mem_RegionBase.h>
 #include <RiscvEmu/mem/detail/mem_MemoryDeviceImpl.h>
-#include <memory>
 
 namespace riscv {
 namespace mem {
 namespace detail {
 
-class MemRegion : public RegionBase, private MemoryDeviceImpl<std::unique_ptr<Byte[]>> {
+class MemRegion : public RegionBase, private MemoryDeviceImpl<HostMemory> {
 public:
     MemRegion() noexcept = default;
-    constexpr MemRegion(const RegionBase& info) :
-        RegionBase(info),
-        MemoryDeviceImpl(std::make_unique<Byte[]>(info.GetLength())) {}
 
-    constexpr void Initialize(const RegionBase& info) {
+    Result Initialize(const RegionInfo& info) {
+        /* Allocate or map backing memory. */
+        HostMemory mem;
+        Result res = info.GetMapMode() == FileMapMode::None ?
+            mem.Initialize(info.GetLength()) :
+            mem.InitializeFromFile(info.GetLength(), info.GetFilePath(), info.GetMapMode());
+        if(res.IsFailure()) {
+            return res;
+        }
+
         RegionBase::Initialize(info);
-        MemoryDeviceImpl::Initialize(std::make_unique<Byte[]>(info.GetLength()));
+        MemoryDeviceImpl::Initialize(std::move(mem));
+
+        return ResultSuccess();
+    }
+
+    void Finalize() {
+        RegionBase::Initialize(0, 0);
+        MemoryDeviceImpl::Initialize(HostMemory());
     }
 
+    constexpr Byte* GetHostPointer(Address addr) noexcept { return this->GetHostPointerImpl(addr); }
+
+    void EnableDirtyPageTracking() { this->EnableDirtyPageTrackingImpl(this->GetLength()); }
+    std::size_t GetDirtyPageWordCount() const noexcept { return this->GetDirtyPageWordCountImpl(); }
+    void FetchAndClearDirtyPages(std::span<DWord> out) noexcept { this->FetchAndClearDirtyPagesImpl(out); }
+    void MarkDirty(Address addr, std::size_t len) noexcept { this->MarkDirtyImpl(addr, len); }
+
     constexpr Result ReadByte  (Byte* pOut, Address addr)  { return this->ReadByteImpl(pOut, addr); }
     constexpr Result ReadHWord (HWord* pOut, Address addr) { return this->ReadHWordImpl(pOut, addr); }
     constexpr Result ReadWord  (Word* pOut, Address addr)  { return this->ReadWordImpl(pOut, addr); }
@@ -1,7 +1,11 @@
 #pragma once
 #include <RiscvEmu/result.h>
 #include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/mem/detail/mem_DirtyPageBitmap.h>
+#include <atomic>
 #include <bit>
+#include <cstdint>
+#include <type_traits>
 #include <utility>
 
 namespace riscv {
@@ -10,22 +14,58 @@ namespace detail {
 
 template<typename T>
 class MemoryDeviceImpl {
+private:
+    /* Read-only backings, e.g. for execute in place, aren't written to and don't need atomic accesses. */
+    static constexpr bool IsWritable = !std::is_const_v<std::remove_reference_t<decltype(std::declval<T&>()[0])>>;
 public:
     constexpr MemoryDeviceImpl() noexcept = default;
 
     constexpr MemoryDeviceImpl(T&& pMem) :
         m_pMem(std::forward<T>(pMem)) {}
 
-    constexpr void Initialize(T&& pMem) {
+    void Initialize(T&& pMem) {
         m_pMem = std::forward<T>(pMem);
+        m_DirtyPages.Finalize();
+    }
+
+    constexpr auto* GetHostPointerImpl(Address addr) noexcept {
+        return &m_pMem[addr];
+    }
+
+    void EnableDirtyPageTrackingImpl(std::size_t length) {
+        m_DirtyPages.Initialize(length);
+    }
+
+    std::size_t GetDirtyPageWordCountImpl() const noexcept {
+        return m_DirtyPages.GetWordCount();
+    }
+
+    void FetchAndClearDirtyPagesImpl(std::span<DWord> out) noexcept {
+        m_DirtyPages.FetchAndClear(out);
+    }
+
+    void MarkDirtyImpl(Address addr, std::size_t len) noexcept {
+        m_DirtyPages.MarkDirty(addr, len);
     }
 
     constexpr Result ReadByteImpl(Byte* pOut, Address addr) {
-        *pOut = m_pMem[addr];
+        if constexpr(IsWritable) {
+            *pOut = this->GetAtomicRef<Byte>(addr).load(std::memory_order_relaxed);
+        }
+        else {
+            *pOut = m_pMem[addr];
+        }
         return ResultSuccess();
     }
 
     constexpr Result ReadHWordImpl(HWord* pOut, Address addr) {
+        if constexpr(IsWritable) {
+            if(this->IsAtomicAccess<HWord>(addr)) {
+                *pOut = this->GetAtomicRef<HWord>(addr).load(std::memory_order_relaxed);
+                return ResultSuccess();
+            }
+        }
+
         if constexpr(std::endian::native == std::endian::little) {
             /* On little endian we go from lower to higher.*/
             *pOut = static_cast<HWord>(m_pMem[addr + 0] << 0) |
@@ -40,6 +80,13 @@ public:
     }
 
     constexpr Result ReadWordImpl(Word* pOut, Address addr) {
+        if constexpr(IsWritable) {
+            if(this->IsAtomicAccess<Word>(addr)) {
+                *pOut = this->GetAtomicRef<Word>(addr).load(std::memory_order_relaxed);
+                return ResultSuccess();
+            }
+        }
+
         if constexpr(std::endian::native == std::endian::little) {
             /* On little endian we go from lower to higher.*/
             *pOut = static_cast<Word>(m_pMem[addr + 0] <<  0) |
@@ -58,6 +105,13 @@ public:
     }
 
     constexpr Result ReadDWordImpl(DWord* pOut, Address addr) {
+        if constexpr(IsWritable) {
+            if(this->IsAtomicAccess<DWord>(addr)) {
+                *pOut = this->GetAtomicRef<DWord>(addr).load(std::memory_order_relaxed);
+                return ResultSuccess();
+            }
+        }
+
         if constexpr(std::endian::native == std::endian::little) {
             /* On little endian we go from lower to higher.*/
             *pOut = static_cast<DWord>(m_pMem[addr + 0]) <<  0 |
@@ -84,11 +138,20 @@ public:
     }
 
     constexpr Result WriteByteImpl(Byte in, Address addr) {
-        m_pMem[addr] = in;
+        this->GetAtomicRef<Byte>(addr).store(in, std::memory_order_relaxed);
+        m_DirtyPages.MarkDirty(addr, sizeof(in));
         return ResultSuccess();
     }
 
     constexpr Result WriteHWordImpl(HWord in, Address addr) {
+        if constexpr(IsWritable) {
+            if(this->IsAtomicAccess<HWord>(addr)) {
+                this->GetAtomicRef<HWord>(addr).store(in, std::memory_order_relaxed);
+                m_DirtyPages.MarkDirty(addr, sizeof(in));
+                return ResultSuccess();
+            }
+        }
+
         if constexpr(std::endian::native == std::endian::little) {
             /* On little endian we go from lower to higher. */
             m_pMem[addr + 0] = static_cast<Byte>(in >> 0u & 0xFFu);
@@ -99,10 +162,19 @@ public:
             m_pMem[addr + 0] = static_cast<Byte>(in >> 8 & 0xFF);
             m_pMem[addr + 1] = static_cast<Byte>(in >> 0 & 0xFF);
         }
+        m_DirtyPages.MarkDirty(addr, sizeof(in));
         return ResultSuccess();
     }
 
     constexpr Result WriteWordImpl(Word in, Address addr) {
+        if constexpr(IsWritable) {
+            if(this->IsAtomicAccess<Word>(addr)) {
+                this->GetAtomicRef<Word>(addr).store(in, std::memory_order_relaxed);
+                m_DirtyPages.MarkDirty(addr, sizeof(in));
+                return ResultSuccess();
+            }
+        }
+
         if constexpr(std::endian::native == std::endian::little) {
             /* On little endian we go from lower to higher. */
             m_pMem[addr + 0] = static_cast<Byte>(in >>  0 & 0xFF);
@@ -117,10 +189,19 @@ public:
             m_pMem[addr + 2] = static_cast<Byte>(in >>  8 & 0xFF);
             m_pMem[addr + 3] = static_cast<Byte>(in >>  0 & 0xFF);
         }
+        m_DirtyPages.MarkDirty(addr, sizeof(in));
         return ResultSuccess();
     }
 
     constexpr Result WriteDWordImpl(DWord in, Address addr) {
+        if constexpr(IsWritable) {
+            if(this->IsAtomicAccess<DWord>(addr)) {
+                this->GetAtomicRef<DWord>(addr).store(in, std::memory_order_relaxed);
+                m_DirtyPages.MarkDirty(addr, sizeof(in));
+                return ResultSuccess();
+            }
+        }
+
         if constexpr(std::endian::native == std::endian::little) {
             /* On little endian we go from lower to higher. */
             m_pMem[addr + 0] = static_cast<Byte>(in >>  0 & 0xFF);
@@ -143,10 +224,28 @@ public:
             m_pMem[addr + 6] = static_cast<Byte>(in >>  8 & 0xFF);
             m_pMem[addr + 7] = static_cast<Byte>(in >>  0 & 0xFF);
         }
+        m_DirtyPages.MarkDirty(addr, sizeof(in));
         return ResultSuccess();
     }
+private:
+    /**
+     * Check whether an access can be made through std::atomic_ref.
+     *
+     * Harts access memory concurrently, naturally aligned accesses have to be single-copy atomic
+     * and mustn't race with the atomic accesses of AMOs. Misaligned accesses have no such guarantee.
+    */
+    template<typename U>
+    bool IsAtomicAccess(Address addr) const noexcept {
+        return reinterpret_cast<std::uintptr_t>(&m_pMem[addr]) % std::atomic_ref<U>::required_alignment == 0;
+    }
+
+    template<typename U>
+    std::atomic_ref<U> GetAtomicRef(Address addr) const noexcept {
+        return std::atomic_ref<U>(*reinterpret_cast<U*>(&m_pMem[addr]));
+    }
 private:
     T m_pMem;
+    DirtyPageBitmap m_DirtyPages;
 }; // class MemoryDeviceImpl
 
 } // namespace detail
@@ -14,7 +14,16 @@ public:
     constexpr auto GetLength() const noexcept { return m_Length; }
 
     constexpr auto Includes(Address addr) const noexcept {
-        return addr >= this->GetStart() && addr <= this->GetEnd();
+        return m_Length != 0 && addr >= this->GetStart() && addr < this->GetEnd();
+    }
+
+    constexpr auto IncludesRange(Address addr, NativeWord len) const noexcept {
+        /* Written to avoid overflowing when addr + len wraps. */
+        return addr >= this->GetStart() && len <= this->GetLength() && addr - this->GetStart() <= this->GetLength() - len;
+    }
+
+    constexpr auto Overlaps(const RegionBase& other) const noexcept {
+        return m_Length != 0 && other.m_Length != 0 && other.GetStart() < this->GetEnd() && this->GetStart() < other.GetEnd();
     }
 protected:
     constexpr RegionBase() noexcept = default;
@@ -32,8 +41,8 @@ protected:
         m_Length = other.m_Length;
     }
 private:
-    Address m_Address;
-    NativeWord m_Length;
+    Address m_Address = 0;
+    NativeWord m_Length = 0;
 }; // class RegionBase
 
 } // namespace detail
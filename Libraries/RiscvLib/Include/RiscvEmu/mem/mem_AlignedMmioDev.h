@@ -2,6 +2,7 @@
 #include <RiscvEmu/mem/mem_IMmioDev.h>
 #include <RiscvEmu/mem/mem_Result.h>
 #include <concepts>
+#include <utility>
 
 namespace riscv {
 namespace mem {
@@ -17,6 +18,11 @@ namespace mem {
 template<std::derived_from<IMmioDev> ImplT>
 class AlignedMmioDev : public IMmioDev {
 public:
+    /** Construct the wrapped device from args. */
+    template<typename... Args>
+    constexpr explicit AlignedMmioDev(Args&&... args) :
+        m_Impl(std::forward<Args>(args)...) {}
+
     constexpr virtual NativeWord GetMappedSize() override { return m_Impl.GetMappedSize(); } 
 
     constexpr virtual Result ReadByte(Byte* pOut, Address addr) override {
@@ -50,21 +56,25 @@ public:
     constexpr virtual Result WriteDWord(DWord in, Address addr) override {
         return this->CallWriteImpl(&ImplT::WriteDWord, in, addr);
     }
+
+    constexpr virtual Result GetReadOnlyBacking(std::span<const Byte>* pOut, NativeWord* pOutOffset) override {
+        return m_Impl.GetReadOnlyBacking(pOut, pOutOffset);
+    }
 private:
     template<typename WordT>
     constexpr Result CallReadImpl(auto func, WordT* pOut, Address addr) {
         if(addr % sizeof(WordT)) {
-            return (m_Impl.*func)(pOut, addr);
+            return ResultBadMisalignedAddress();
         }
-        return ResultBadMisalignedAddress();
+        return (m_Impl.*func)(pOut, addr);
     }
 
     template<typename WordT>
     constexpr Result CallWriteImpl(auto func, WordT in, Address addr) {
         if(addr % sizeof(WordT)) {
-            return (m_Impl.*func)(in, addr);
+            return ResultBadMisalignedAddress();
         }
-        return ResultBadMisalignedAddress();
+        return (m_Impl.*func)(in, addr);
     }
 private:
     ImplT m_Impl;
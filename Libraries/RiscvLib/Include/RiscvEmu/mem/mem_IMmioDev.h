@@ -2,6 +2,8 @@
 #include <RiscvEmu/result.h>
 #include <RiscvEmu/riscv_Peripheral.h>
 #include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/mem/mem_Result.h>
+#include <span>
 
 namespace riscv {
 namespace mem {
@@ -14,6 +16,8 @@ namespace mem {
  * 
  * Implementations should return ResultBadMisalignedAddress if they doesn't support
  * misaligned addresses when a misaligned address is given to them.
+ * 
+ * GetReadOnlyBacking is the only exception, devices which can't provide one may leave it as is.
 */
 class IMmioDev : public Peripheral {
 public:
@@ -45,6 +49,19 @@ public:
 
     /** Write a single double word. */
     virtual Result WriteDWord(DWord in, Address addr) = 0;
+
+    /**
+     * Retrieve host memory directly backing part of the device's address space, used to execute in place.
+     * 
+     * The memory must remain valid and unchanged for as long as the device is attached to a
+     * MemoryController, instruction fetches from this range will bypass the device entirely.
+     * 
+     * @param[out] pOut  Host memory backing the range.
+     * @param[out] pOutOffset  Offset of the range within the device's address space.
+     * @return ResultNotRamBacked() if the device has no such range.
+     * @return ResultSuccess() otherwise.
+    */
+    virtual Result GetReadOnlyBacking(std::span<const Byte>*, NativeWord*) { return ResultNotRamBacked(); }
 }; // class IMmioDev
 
 } // namespace mem
@@ -3,8 +3,10 @@
 #include <RiscvEmu/mem/mem_IMmioDev.h>
 #include <RiscvEmu/mem/mem_RegionInfo.h>
 #include <RiscvEmu/mem/mem_Result.h>
+#include <RiscvEmu/mem/detail/mem_ExecRegion.h>
 #include <RiscvEmu/mem/detail/mem_MemRegion.h>
 #include <RiscvEmu/mem/detail/mem_IoRegion.h>
+#include <span>
 #include <vector>
 
 namespace riscv {
@@ -26,22 +28,100 @@ class MemoryController {
 public:
 
     /**
-     * Initializes the Memory Controller's regions.
+     * Initializes the Memory Controller's regions, replacing any existing regions.
+     * 
+     * MMIO devices are removed along with their regions and have to be added again.
      * 
      * Note: Only a single Memory region may exist, if multiple entries are present the last will be used.
      * If multiple memory regions are needed, add a mem::Ram IO device.
      * 
-     * @param[in] pRegions  Regions to add.
+     * Every entry is validated before any region is replaced, if this fails the existing regions are left untouched.
+     * 
+     * @param[in] pRegions  Regions to map.
      * @param[in] regionCount  Number of entries in pRegions.
-     * @return ResultRegionAlreadyExists() if a region in pRegions overlaps with a prexisting region.
+     * @return ResultInvalidRegionSize() if a region in pRegions is empty or wraps around the address space.
+     * @return ResultRegionAlreadyExists() if a region in pRegions overlaps with another entry.
      * @return ResultInvalidRegionType() if the type field in an entry is invalid.
+     * @return ResultHostMapFailed() if backing memory for a Memory region couldn't be allocated or mapped.
+     * @return ResultFileOpenFailed() if the file backing a Memory region couldn't be opened.
      * @return ResultSuccess() otherwise.
     */
     Result Initialize(const RegionInfo* pRegions, std::size_t regionCount);
 
-    /** Add an MMIO device. */
+    /**
+     * Add an MMIO device.
+     * 
+     * If the device provides a read-only backing via IMmioDev::GetReadOnlyBacking it's queried once here,
+     * instruction fetches from that range are then served directly from host memory.
+    */
     Result AddMmioDev(IMmioDev* dev, Address addr);
 
+    /**
+     * Get direct host access to a range of physical memory.
+     *
+     * The returned span remains valid until the memory controller is re-initialized.
+     *
+     * @param[out] pOut  Span covering the requested range.
+     * @param[in] addr  Physical address of the start of the range.
+     * @param[in] len  Length of the range in bytes.
+     * @return ResultNotRamBacked() if any part of the range isn't backed by main memory.
+     * @return ResultSuccess() otherwise.
+    */
+    Result GetHostSpan(std::span<Byte>* pOut, Address addr, NativeWord len);
+
+    /**
+     * Get direct read-only host access to a range of executable memory.
+     *
+     * Unlike GetHostSpan this also covers ranges of mmio devices which may be executed in place,
+     * making it suitable for caching decoded code.
+     *
+     * @param[out] pOut  Span covering the requested range.
+     * @param[in] addr  Physical address of the start of the range.
+     * @param[in] len  Length of the range in bytes.
+     * @return ResultNotRamBacked() if any part of the range isn't backed by host memory.
+     * @return ResultSuccess() otherwise.
+    */
+    Result GetExecSpan(std::span<const Byte>* pOut, Address addr, NativeWord len);
+
+    /**
+     * Read a word for instruction fetch.
+     *
+     * This behaves like ReadWord but skips the device search and virtual call for execute in place ranges.
+    */
+    Result FetchWord(Word* pOut, Address addr);
+
+    /**
+     * Start tracking which pages of main memory are written to.
+     *
+     * Tracking is reset if the memory controller is re-initialized. Writes made through
+     * spans from GetHostSpan aren't tracked.
+     *
+     * This may be called while harts are running, writes are tracked from the point the bitmap is published.
+     * If tracking is already enabled the existing bitmap is kept.
+    */
+    void EnableDirtyPageTracking();
+
+    /** Retrieve the number of DWords needed to hold the dirty page bitmap, 0 while tracking is disabled. */
+    std::size_t GetDirtyPageWordCount() const noexcept;
+
+    /**
+     * Atomically fetch and clear the dirty page bitmap of main memory.
+     *
+     * Bit n of word n / 64 is set if the 4KiB page at n * 4KiB from the start of main memory
+     * was written to since the previous call. For a consistent snapshot no harts should be running.
+     *
+     * @param[out] out  Receives the bitmap, must hold at least GetDirtyPageWordCount() words.
+    */
+    void FetchAndClearDirtyPages(std::span<DWord> out);
+
+    /**
+     * Mark a range of main memory as written to.
+     *
+     * This is for writes made through spans from GetHostSpan, ranges outside main memory are ignored.
+     * The range must not exceed a page.
+    */
+    void MarkDirty(Address addr, NativeWord len) noexcept;
+
     Result ReadByte(Byte* pOut, Address addr);
 
     Result ReadHWord(HWord* pOut, Address addr);
@@ -64,6 +144,7 @@ public:
 private:
     detail::MemRegion m_MemRegion;
     std::vector<detail::IoRegion> m_IoRegions;
+    std::vector<detail::ExecRegion> m_ExecRegions;
 private:
     template<auto MemRead, auto IoRead, typename T>
     Result ReadWriteImpl(T pOut, Address addr);
@@ -73,6 +154,7 @@ private:
 
     detail::IoRegion* FindIoRegion(Address addr);
     detail::IoDev* FindIoDevice(Address addr, NativeWord len);
+    detail::ExecRegion* FindExecRegion(Address addr, NativeWord len);
 };
 
 } // namespace mem
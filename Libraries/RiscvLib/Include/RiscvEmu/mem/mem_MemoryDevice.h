@@ -3,6 +3,7 @@
 #include <RiscvEmu/mem/mem_IMmioDev.h>
 #include <RiscvEmu/mem/detail/mem_MemoryDeviceImpl.h>
 #include <memory>
+#include <span>
 
 namespace riscv {
 namespace mem {
@@ -23,6 +24,15 @@ public:
 
     constexpr virtual NativeWord GetMappedSize() override { return m_Length; }
 
+    /** Start tracking which pages are written to, see MemoryController::EnableDirtyPageTracking. */
+    void EnableDirtyPageTracking() { this->EnableDirtyPageTrackingImpl(m_Length); }
+
+    /** Retrieve the number of DWords needed to hold the dirty page bitmap. */
+    std::size_t GetDirtyPageWordCount() const noexcept { return this->GetDirtyPageWordCountImpl(); }
+
+    /** Atomically fetch and clear the dirty page bitmap, see MemoryController::FetchAndClearDirtyPages. */
+    void FetchAndClearDirtyPages(std::span<DWord> out) noexcept { this->FetchAndClearDirtyPagesImpl(out); }
+
     constexpr virtual Result ReadByte  (Byte* pOut, Address addr)  override { return this->ReadByteImpl(pOut, addr); }
     constexpr virtual Result ReadHWord (HWord* pOut, Address addr) override { return this->ReadHWordImpl(pOut, addr); }
     constexpr virtual Result ReadWord  (Word* pOut, Address addr)  override { return this->ReadWordImpl(pOut, addr); }
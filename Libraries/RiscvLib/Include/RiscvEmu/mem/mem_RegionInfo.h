@@ -10,15 +10,46 @@ enum class RegionType {
     IO
 }; // enum class RegionType
 
+enum class FileMapMode {
+    /** Region is not backed by a file. */
+    None,
+
+    /** Region is copy-on-write, writes are never carried through to the file. */
+    Private,
+
+    /** Writes are carried through to the file and are visible to any other mappings of it. */
+    Shared
+}; // enum class FileMapMode
+
 class RegionInfo : public detail::RegionBase {
 public:
     constexpr RegionInfo(Address addr, NativeWord length, RegionType type) noexcept :
         RegionBase(addr, length),
-        m_Type(type) {}
+        m_Type(type),
+        m_pFilePath(nullptr),
+        m_MapMode(FileMapMode::None) {}
+
+    /**
+     * Construct a Memory region that's mapped directly from a file.
+     *
+     * If the file is shorter than length the remainder of the region is zero filled,
+     * or for FileMapMode::Shared the file is extended to length.
+    */
+    constexpr RegionInfo(Address addr, NativeWord length, const char* pFilePath, FileMapMode mode) noexcept :
+        RegionBase(addr, length),
+        m_Type(RegionType::Memory),
+        m_pFilePath(pFilePath),
+        m_MapMode(mode) {}
 
     constexpr auto GetType() const noexcept { return m_Type; }
+
+    constexpr auto GetFilePath() const noexcept { return m_pFilePath; }
+
+    constexpr auto GetMapMode() const noexcept { return m_MapMode; }
 private:
     RegionType m_Type;
+    const char* m_pFilePath;
+    FileMapMode m_MapMode;
 }; // class RegionInfo
 
 } // namespace mem
@@ -28,5 +28,13 @@ class ResultReadAccessFault : public result::ErrorBase<detail::ModuleId, 8> {};
 
 class ResultWriteAccessFault : public result::ErrorBase<detail::ModuleId, 9> {};
 
+class ResultNotRamBacked : public result::ErrorBase<detail::ModuleId, 10> {};
+
+class ResultHostMapFailed : public result::ErrorBase<detail::ModuleId, 11> {};
+
+class ResultFileOpenFailed : public result::ErrorBase<detail::ModuleId, 12> {};
+
+class ResultInvalidRegionSize : public result::ErrorBase<detail::ModuleId, 13> {};
+
 } // namespace mem
 } // namespace riscv
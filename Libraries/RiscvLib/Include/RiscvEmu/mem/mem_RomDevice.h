@@ -0,0 +1,52 @@
+#pragma once
+#include <RiscvEmu/riscv_Types.h>
+#include <RiscvEmu/mem/mem_IMmioDev.h>
+#include <RiscvEmu/mem/mem_Result.h>
+#include <RiscvEmu/mem/detail/mem_MemoryDeviceImpl.h>
+#include <algorithm>
+#include <memory>
+#include <span>
+
+namespace riscv {
+namespace mem {
+
+/**
+ * This is IO device which provides read only memory, e.g. a boot ROM or flash.
+ * 
+ * The entire device may be executed in place.
+*/
+class RomDevice : public IMmioDev, private detail::MemoryDeviceImpl<std::unique_ptr<Byte[]>> {
+public:
+    /**
+     * Construct a RomDevice object holding a copy of an image.
+     * 
+     * @param[in] image  Contents of the ROM.
+    */
+    RomDevice(std::span<const Byte> image) :
+        MemoryDeviceImpl(std::make_unique<Byte[]>(image.size())),
+        m_Length(static_cast<NativeWord>(image.size())) {
+        std::ranges::copy(image, this->GetHostPointerImpl(0));
+    }
+
+    constexpr virtual NativeWord GetMappedSize() override { return m_Length; }
+
+    constexpr virtual Result ReadByte  (Byte* pOut, Address addr)  override { return this->ReadByteImpl(pOut, addr); }
+    constexpr virtual Result ReadHWord (HWord* pOut, Address addr) override { return this->ReadHWordImpl(pOut, addr); }
+    constexpr virtual Result ReadWord  (Word* pOut, Address addr)  override { return this->ReadWordImpl(pOut, addr); }
+    constexpr virtual Result ReadDWord (DWord* pOut, Address addr) override { return this->ReadDWordImpl(pOut, addr); }
+    constexpr virtual Result WriteByte (Byte, Address)  override { return ResultWriteAccessFault(); }
+    constexpr virtual Result WriteHWord(HWord, Address) override { return ResultWriteAccessFault(); }
+    constexpr virtual Result WriteWord (Word, Address)  override { return ResultWriteAccessFault(); }
+    constexpr virtual Result WriteDWord(DWord, Address) override { return ResultWriteAccessFault(); }
+
+    virtual Result GetReadOnlyBacking(std::span<const Byte>* pOut, NativeWord* pOutOffset) override {
+        *pOut = std::span<const Byte>(this->GetHostPointerImpl(0), m_Length);
+        *pOutOffset = 0;
+        return ResultSuccess();
+    }
+private:
+    NativeWord m_Length;
+}; // class RomDevice
+
+} // namespace mem
+} // namespace riscv
@@ -2,6 +2,10 @@
 
 namespace riscv {
 
-class Peripheral {};
+class Peripheral {
+public:
+    /* System owns peripherals through this base. */
+    virtual ~Peripheral() = default;
+};
 
-} // namespace riscv
\ No newline at end of file
+} // namespace riscv
@@ -1,10 +1,18 @@
 #pragma once
+#include <RiscvEmu/diag.h>
 #include <RiscvEmu/result.h>
 #include <RiscvEmu/riscv_Peripheral.h>
 #include <RiscvEmu/cpu/cpu_Hart.h>
+#include <RiscvEmu/cpu/cpu_HartThreadPool.h>
+#include <RiscvEmu/cpu/cpu_Pacer.h>
 #include <RiscvEmu/hw/hw_Scheduler.h>
+#include <RiscvEmu/intrpt/intrpt_CLINT.h>
+#include <RiscvEmu/intrpt/intrpt_ITarget.h>
 #include <RiscvEmu/mem/mem_MemoryController.h>
+#include <atomic>
 #include <memory>
+#include <span>
+#include <thread>
 #include <vector>
 
 namespace riscv {
@@ -21,6 +29,13 @@ public:
         Result WriteHWord(HWord in, Address addr)   { return m_pMemCtlr->WriteHWord(in, addr); }
         Result WriteWord(Word in, Address addr)     { return m_pMemCtlr->WriteWord(in, addr); }
         Result WriteDWord(DWord in, Address addr)   { return m_pMemCtlr->WriteDWord(in, addr); }
+
+        Result GetHostSpan(std::span<Byte>* pOut, Address addr, NativeWord len) { return m_pMemCtlr->GetHostSpan(pOut, addr, len); }
+        Result GetExecSpan(std::span<const Byte>* pOut, Address addr, NativeWord len) { return m_pMemCtlr->GetExecSpan(pOut, addr, len); }
+
+        void EnableDirtyPageTracking() { m_pMemCtlr->EnableDirtyPageTracking(); }
+        std::size_t GetDirtyPageWordCount() const noexcept { return m_pMemCtlr->GetDirtyPageWordCount(); }
+        void FetchAndClearDirtyPages(std::span<DWord> out) { m_pMemCtlr->FetchAndClearDirtyPages(out); }
     private:
         friend class System;
         constexpr MemCtlrAccessor(mem::MemoryController* pMemCtlr) noexcept :
@@ -36,6 +51,8 @@ public:
 
         NativeWord ReadPC() const noexcept { return m_pHart->ReadPC(); }
         NativeWord ReadGPR(int index) const noexcept { return m_pHart->ReadGPR(index); }
+        DWord GetCycleCount() const noexcept { return m_pHart->GetCycleCount(); }
+        bool IsIdle() const noexcept { return m_pHart->IsIdle(); }
     private:
         friend class System;
         constexpr HartAccessor(cpu::Hart* pHart) noexcept :
@@ -43,19 +60,199 @@ public:
     private:
         cpu::Hart* m_pHart;
     }; // class HartAccessor
+public:
+    /** How harts are mapped onto host threads. */
+    enum class ExecMode {
+        /** Every hart runs freely on its own host thread. */
+        ThreadPerHart,
+
+        /**
+         * A single host thread interleaves all harts, running each for a fixed number of instructions in turn.
+         * Execution is deterministic and reproducible.
+        */
+        RoundRobin,
+
+        /**
+         * Harts are multiplexed onto a fixed pool of host threads which steal work from eachother.
+         * Idle harts are skipped until woken, see cpu::HartThreadPool.
+        */
+        ThreadPool
+    }; // enum class ExecMode
+
+    static constexpr DWord DefaultQuantum = 1000;
+
+    /** Instructions each hart retires per second of virtual time, see SetGuestFrequency. */
+    static constexpr DWord DefaultGuestFrequency = 100'000'000;
 public:
     System() = default;
+    System(const System&) = delete;
+    ~System();
 
-    Result Initialize();
+    /**
+     * Initialize the system's harts.
+     *
+     * All harts share the memory controller, hart ids are assigned from 0 to hartCount - 1.
+     *
+     * @param[in] hartCount  Number of harts to create.
+     * @return ResultSuccess()
+    */
+    Result Initialize(Word hartCount = 1);
 
     Result InitializeMemRegions(const mem::RegionInfo* pRegions, std::size_t regionCount) {
         return m_MemCtlr.Initialize(pRegions, regionCount);
     }
 
-    auto GetHartAccessor([[maybe_unused]] int index = 0) noexcept { return HartAccessor(&m_Hart); }
+    /**
+     * Set how harts are run by Start, must not be called while running.
+     *
+     * @param[in] mode  Execution mode.
+     * @param[in] quantum  Instructions each hart executes before switching to the next, unused by ExecMode::ThreadPerHart.
+     * @param[in] workerCount  Number of host threads used by ExecMode::ThreadPool, 0 uses one per host core.
+    */
+    void SetExecMode(ExecMode mode, DWord quantum = DefaultQuantum, std::size_t workerCount = 0) noexcept;
+
+    /**
+     * Set how many instructions a hart retires per second of virtual time, must not be called while running.
+     *
+     * This couples execution to devices run by the hw::DeviceScheduler, see Run.
+     *
+     * @param[in] freq  Guest frequency in Hz.
+    */
+    void SetGuestFrequency(DWord freq) noexcept;
+
+    DWord GetGuestFrequency() const noexcept { return m_GuestFreq; }
+
+    /**
+     * Select where harts' time CSR gets its value from, must not be called while running.
+     *
+     * cpu::Hart::TimeMode::Instret is the default, time is then derived from retired instructions at the guest frequency,
+     * making it deterministic and advancing in every way harts are run.
+     * cpu::Hart::TimeMode::HostClock follows the host's clock, at the cost of disagreeing with a CLINT.
+     *
+     * @param[in] mode  Time source, cpu::Hart::TimeMode::External is selected by SetTimeSource.
+    */
+    void SetTimeMode(cpu::Hart::TimeMode mode);
+
+    /**
+     * Back harts' time CSR with a source shared with devices, selecting cpu::Hart::TimeMode::External.
+     *
+     * This must not be called while running. Passing intrpt::CLINT::GetTimeSource makes time read mtime, at the CLINT's
+     * timebase frequency. mtime follows virtual time, which only Run advances.
+     *
+     * @param[in] pSource  Time source, this must outlive its use by the harts.
+    */
+    void SetTimeSource(const cpu::ITimeSource* pSource);
+
+    /**
+     * Pace execution to wall clock time, must not be called while running.
+     *
+     * Harts then retire instructions no faster than the guest frequency, so guest timers and devices keep time with
+     * host processes. Threads which get ahead sleep it off, see cpu::Pacer.
+     *
+     * Run paces virtual time, ExecMode::ThreadPerHart paces every hart's retired instructions and ExecMode::RoundRobin
+     * paces rounds by the most instructions a hart retired in them. ExecMode::ThreadPool isn't supported, a sleeping
+     * worker would hold up every hart queued on it.
+     *
+     * Run and ExecMode::RoundRobin limit the quantum to cpu::Pacer::MaxSleepSlice worth of instructions while pacing,
+     * so a single round can't run further ahead than the pacer keeps its schedule through.
+     *
+     * @param[in] enable  Whether to pace execution.
+    */
+    void SetRealTimePacing(bool enable) noexcept;
+
+    bool IsRealTimePacing() const noexcept { return m_RealTimePacing; }
+
+    /** Get the virtual time in hw::DeviceScheduler ticks, advanced by Run. */
+    DWord GetTime() const noexcept { return m_DevScheduler.GetTime(); }
+
+    /**
+     * Run harts and devices on the calling thread in virtual time.
+     *
+     * Harts are run round-robin in batches which end at the next device deadline, or after the quantum set by
+     * SetExecMode if that comes first. Each batch advances virtual time by the time its instructions take at the
+     * guest frequency, then the devices due within it are processed. Idle harts are skipped until woken,
+     * but virtual time still passes for them.
+     *
+     * While every hart is idle or stuck branching to itself, virtual time skips straight to the next deadline
+     * instead of being simulated, or sleeps through it with real-time pacing, see SetRealTimePacing.
+     * Cycle counters of idle harts, and of spinning harts which yield the rest of a batch, still advance with virtual time,
+     * so each hart's mcycle matches the time that passed.
+     *
+     * @param[in] instCount  Number of instructions of virtual time to run each hart for.
+     * @return The failure returned by a hart or device, otherwise ResultSuccess().
+    */
+    Result Run(DWord instCount);
+
+    /**
+     * Start running harts on host thread(s), see SetExecMode.
+     *
+     * Each hart executes from its current PC until Stop is called or it fails to execute an instruction.
+     *
+     * Nothing advances virtual time while harts run on host threads, so no hw::IDevice peripherals, e.g. a CLINT's
+     * timer, may be attached, use Run for those instead. Harts idle in WFI are then only woken through WakeHart and
+     * the targets from CreateIrqTarget and GetClintTarget.
+     *
+     * @return ResultSuccess()
+    */
+    Result Start();
+
+    /**
+     * Run harts round-robin on the calling thread for a number of rounds.
+     *
+     * Each round executes the quantum set by SetExecMode on every hart in hart id order,
+     * making this suitable for reproducible runs regardless of the current ExecMode.
+     * Idle harts do nothing until woken.
+     *
+     * @param[in] roundCount  Number of rounds to run.
+     * @return The failure returned by a hart, otherwise ResultSuccess().
+    */
+    Result Step(DWord roundCount);
+
+    /** Request all harts stop, this doesn't wait for them, see Join. */
+    void Stop() noexcept;
+
+    /**
+     * Wake an idle hart, this may be called from any thread.
+     *
+     * Harts idle in WFI don't use their host thread until woken, interrupt sources wake them through
+     * the targets from CreateIrqTarget and GetClintTarget.
+    */
+    void WakeHart(Word hartId);
+
+    /**
+     * Create an interrupt controller target for a hart, e.g. for intrpt::PLIC::RegisterTarget.
+     *
+     * The hart is woken whenever an interrupt is available to the target.
+    */
+    std::shared_ptr<intrpt::ITarget> CreateIrqTarget(Word hartId);
+
+    /** Get a CLINT target waking harts whose timer or software interrupt becomes pending, see intrpt::CLINT::SetTarget. */
+    intrpt::CLINT::IHartTarget* GetClintTarget() noexcept { return &m_ClintTarget; }
+
+    /**
+     * Wait for all hart threads to exit.
+     *
+     * If any hart fails the remaining harts are stopped as well.
+     *
+     * @return The first failure returned by a hart, otherwise ResultSuccess().
+    */
+    Result Join();
+
+    /** Check whether hart threads have been started and not yet joined. */
+    bool IsRunning() const noexcept { return m_pHartThreads != nullptr || m_HartPool.IsRunning(); }
+
+    Word GetHartCount() const noexcept { return m_HartCount; }
+
+    auto GetHartAccessor(int index = 0) noexcept {
+        diag::Assert(index >= 0 && static_cast<Word>(index) < m_HartCount);
+        return HartAccessor(&m_pHarts[index]);
+    }
 
     auto GetMemCtlrAccessor() noexcept { return MemCtlrAccessor(&m_MemCtlr); }
 
+    /** Get the scheduler running hw::IDevice peripherals, e.g. for devices starting async work. */
+    hw::DeviceScheduler* GetDeviceScheduler() noexcept { return &m_DevScheduler; }
+
     template<typename T>
     Result AddPeripheral(std::unique_ptr<T>&& pPeripheral) {
         this->AddPeripheralImpl(std::move(pPeripheral));
@@ -63,35 +260,94 @@ public:
     }
 
     template<std::derived_from<mem::IMmioDev> T>
-    Result AddMmioPeripheral(std::unique_ptr<T>&& pPeripheral) {
+    Result AddMmioPeripheral(std::unique_ptr<T>&& pPeripheral, Address addr) {
         /* Add peripheral. */
-        auto& p = this->AddPeripheralImpl(std::move(pPeripheral));
+        T* p = this->AddPeripheralImpl(std::move(pPeripheral));
 
         /* Register peripheral with memory controller. */
-        m_MemCtlr.AddMmioDev(p.get());
+        return m_MemCtlr.AddMmioDev(p, addr);
+    }
+private:
+    class HartIrqTarget : public intrpt::ITarget {
+    public:
+        HartIrqTarget(System* pParent, Word hartId) noexcept :
+            m_pParent(pParent),
+            m_HartId(hartId) {}
 
-        return ResultSuccess();
-    }    
+        virtual Result NotifyAvailableIRQ() override;
+    private:
+        System* m_pParent;
+        Word m_HartId;
+    }; // class HartIrqTarget
+
+    class ClintTarget : public intrpt::CLINT::IHartTarget {
+    public:
+        ClintTarget(System* pParent) noexcept :
+            m_pParent(pParent) {}
+
+        virtual void NotifyTimerInterrupt(Word hartId, bool pending) override;
+        virtual void NotifySoftwareInterrupt(Word hartId, bool pending) override;
+    private:
+        System* m_pParent;
+    }; // class ClintTarget
 private:
     template<typename T>
-    auto& AddPeripheralImpl(std::unique_ptr<T>&& pPeripheral) {
+    T* AddPeripheralImpl(std::unique_ptr<T>&& pPeripheral) {
         /* Move the peripheral to our list. */
-        auto& p = m_PeripheralList.emplace_back(std::move(pPeripheral));
+        T* p = pPeripheral.get();
+        m_PeripheralList.emplace_back(std::move(pPeripheral));
 
         /* Register peripheral with hardware scheduler if it's a hw::IDevice. */
         if constexpr(std::derived_from<T, hw::IDevice>) {
-            m_DevScheduler.AddDevice(p.get());
+            m_DevScheduler.AddDevice(p);
         }
 
         return p;
     }
 
+    Result ExecuteQuantum(cpu::Hart& hart);
+    Result ExecuteBatch(cpu::Hart& hart, DWord instCount);
+    bool AreAllHartsWaiting() const noexcept;
+    Result AdvanceDevices(DWord instCount);
+    DWord GetBatchInstCount(DWord maxInstCount) const noexcept;
+    void SignalHartFailure(Result res) noexcept;
+    void NotifyWake() noexcept;
+
+    void RunHart(Word hartId);
+    void RunRoundRobin();
 private:
+    /* Declared before the peripherals, which may remove themselves from it as they're destroyed. */
+    hw::DeviceScheduler m_DevScheduler;
+
     std::vector<std::unique_ptr<Peripheral>> m_PeripheralList;
-    cpu::Hart m_Hart;
+
+    Word m_HartCount = 0;
+    std::unique_ptr<cpu::Hart[]> m_pHarts;
+    cpu::Hart::SharedState m_HartSharedState;
     mem::MemoryController m_MemCtlr;
 
-    hw::DeviceScheduler m_DevScheduler;
-};
+    ExecMode m_ExecMode = ExecMode::ThreadPerHart;
+    DWord m_Quantum = DefaultQuantum;
+    std::size_t m_WorkerCount = 0;
+    cpu::HartThreadPool m_HartPool;
+
+    std::size_t m_ThreadCount = 0;
+    std::unique_ptr<std::thread[]> m_pHartThreads;
+    std::atomic<bool> m_StopRequested = false;
+    std::atomic<Word> m_HartResult = ResultSuccess().GetValue();
+
+    /* Bumped by every WakeHart and Stop, ExecMode::RoundRobin sleeps on it while all harts are idle. */
+    std::atomic<Word> m_WakeCount = 0;
+
+    ClintTarget m_ClintTarget{ this };
+
+    DWord m_GuestFreq = DefaultGuestFrequency;
+    cpu::Hart::TimeMode m_TimeMode = cpu::Hart::TimeMode::Instret;
+    const cpu::ITimeSource* m_pTimeSource = nullptr;
+    bool m_RealTimePacing = false;
+
+    /* Fraction of a tick retired instructions have run for, in units of 1 / m_GuestFreq ticks. */
+    DWord m_TickRemainder = 0;
+}; // class System
 
 } // namespace riscv
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+namespace riscv {
+namespace util {
+
+/** Host cache line size, used to keep data written by different threads on separate lines. */
+constexpr inline std::size_t CacheLineSize = 64;
+
+} // namespace util
+} // namespace riscv
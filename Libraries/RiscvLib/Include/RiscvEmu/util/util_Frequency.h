@@ -0,0 +1,17 @@
+#pragma once
+#include <RiscvEmu/riscv_Types.h>
+
+namespace riscv {
+namespace util {
+
+/**
+ * Scale a count at one frequency to another, rounding down.
+ *
+ * The count is split at whole seconds so the multiplication can't overflow, as long as toFreq * fromFreq fits in a DWord.
+*/
+constexpr DWord ScaleCount(DWord count, DWord fromFreq, DWord toFreq) noexcept {
+    return (count / fromFreq) * toFreq + (count % fromFreq) * toFreq / fromFreq;
+}
+
+} // namespace util
+} // namespace riscv
@@ -0,0 +1,176 @@
+#pragma once
+#include <RiscvEmu/diag.h>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace riscv {
+namespace util {
+
+/**
+ * Heap with Arity children per node whose elements are addressed by stable handles.
+ *
+ * Unlike std::priority_queue, an element can be updated or removed in O(log n) through the handle
+ * returned when it was pushed, handles stay valid until their element is popped or removed.
+ *
+ * Compare(lhs, rhs) returns whether lhs comes out before rhs, so std::less makes a min-heap.
+*/
+template<typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class IndexedHeap {
+    static_assert(Arity >= 2);
+public:
+    using Handle = std::size_t;
+
+    static constexpr Handle InvalidHandle = ~static_cast<Handle>(0);
+public:
+    constexpr IndexedHeap(Compare comp = Compare()) :
+        m_Comp(std::move(comp)) {}
+
+    constexpr bool IsEmpty() const noexcept { return m_Nodes.empty(); }
+    constexpr std::size_t GetSize() const noexcept { return m_Nodes.size(); }
+
+    constexpr const T& GetTop() const noexcept {
+        diag::Assert(!this->IsEmpty());
+        return m_Nodes.front().value;
+    }
+
+    constexpr Handle GetTopHandle() const noexcept {
+        diag::Assert(!this->IsEmpty());
+        return m_Nodes.front().handle;
+    }
+
+    constexpr bool Contains(Handle handle) const noexcept {
+        return handle < m_Positions.size() && m_Positions[handle] != NoPosition;
+    }
+
+    constexpr const T& Get(Handle handle) const noexcept {
+        diag::Assert(this->Contains(handle));
+        return m_Nodes[m_Positions[handle]].value;
+    }
+
+    /** Insert an element, the returned handle stays valid until the element leaves the heap. */
+    constexpr Handle Push(T val) {
+        /* Reuse a free handle if there is one. */
+        Handle handle = 0;
+        if(!m_FreeHandles.empty()) {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+        }
+        else {
+            handle = m_Positions.size();
+            m_Positions.push_back(NoPosition);
+        }
+
+        m_Nodes.push_back({ std::move(val), handle });
+        this->SiftUp(m_Nodes.size() - 1);
+
+        return handle;
+    }
+
+    constexpr void Pop() { this->Remove(this->GetTopHandle()); }
+
+    constexpr void Remove(Handle handle) {
+        diag::Assert(this->Contains(handle));
+
+        /* Fill the hole with the last node, which may have to move either way. */
+        std::size_t pos = m_Positions[handle];
+        m_Positions[handle] = NoPosition;
+        m_FreeHandles.push_back(handle);
+
+        Node last = std::move(m_Nodes.back());
+        m_Nodes.pop_back();
+        if(pos < m_Nodes.size()) {
+            m_Nodes[pos] = std::move(last);
+            this->Restore(pos);
+        }
+    }
+
+    /** Replace an element's value, keeping its handle. */
+    constexpr void Update(Handle handle, T val) {
+        diag::Assert(this->Contains(handle));
+
+        std::size_t pos = m_Positions[handle];
+        m_Nodes[pos].value = std::move(val);
+        this->Restore(pos);
+    }
+
+    constexpr void Clear() noexcept {
+        m_Nodes.clear();
+        m_Positions.clear();
+        m_FreeHandles.clear();
+    }
+private:
+    static constexpr std::size_t NoPosition = ~static_cast<std::size_t>(0);
+
+    struct Node {
+        T value;
+        Handle handle;
+    }; // struct Node
+
+    constexpr void Restore(std::size_t pos) {
+        if(pos > 0 && m_Comp(m_Nodes[pos].value, m_Nodes[(pos - 1) / Arity].value)) {
+            this->SiftUp(pos);
+        }
+        else {
+            this->SiftDown(pos);
+        }
+    }
+
+    constexpr void SiftUp(std::size_t pos) {
+        /* Move parents down until the node's place is found, then place it once. */
+        Node node = std::move(m_Nodes[pos]);
+        while(pos > 0) {
+            std::size_t parent = (pos - 1) / Arity;
+            if(!m_Comp(node.value, m_Nodes[parent].value)) {
+                break;
+            }
+            this->Place(pos, std::move(m_Nodes[parent]));
+            pos = parent;
+        }
+        this->Place(pos, std::move(node));
+    }
+
+    constexpr void SiftDown(std::size_t pos) {
+        /* Move the first child up until the node's place is found, then place it once. */
+        Node node = std::move(m_Nodes[pos]);
+        const std::size_t size = m_Nodes.size();
+        while(true) {
+            std::size_t first = pos * Arity + 1;
+            if(first >= size) {
+                break;
+            }
+
+            std::size_t best = first;
+            std::size_t end = first + Arity < size ? first + Arity : size;
+            for(std::size_t child = first + 1; child < end; child++) {
+                if(m_Comp(m_Nodes[child].value, m_Nodes[best].value)) {
+                    best = child;
+                }
+            }
+
+            if(!m_Comp(m_Nodes[best].value, node.value)) {
+                break;
+            }
+            this->Place(pos, std::move(m_Nodes[best]));
+            pos = best;
+        }
+        this->Place(pos, std::move(node));
+    }
+
+    constexpr void Place(std::size_t pos, Node&& node) {
+        m_Positions[node.handle] = pos;
+        m_Nodes[pos] = std::move(node);
+    }
+private:
+    std::vector<Node> m_Nodes;
+
+    /* Position of each handle's node, NoPosition for free handles. */
+    std::vector<std::size_t> m_Positions;
+    std::vector<Handle> m_FreeHandles;
+
+    [[no_unique_address]] Compare m_Comp;
+}; // class IndexedHeap
+
+} // namespace util
+} // namespace riscv
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace riscv {
+namespace util {
+
+/** Hint to the host CPU that we're in a spin-wait loop. */
+inline void SpinPause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+} // namespace util
+} // namespace riscv
@@ -84,6 +84,10 @@ Result Hart::ReadWriteCSRImpl(CsrId id, NativeWord* pOut, NativeWord writeVal, C
         return this->RmwCSRImpl(pOut, writeVal, &Hart::CSRRead_cycleh, nullptr, nullptr);
     case CsrId::instreth:
         return this->RmwCSRImpl(pOut, writeVal, &Hart::CSRRead_instreth, nullptr, nullptr);
+    case CsrId::time:
+        return this->RmwCSRImpl(pOut, writeVal, &Hart::CSRRead_time, nullptr, nullptr);
+    case CsrId::timeh:
+        return this->RmwCSRImpl(pOut, writeVal, &Hart::CSRRead_timeh, nullptr, nullptr);
     
     default: break;
     }
@@ -223,5 +227,26 @@ Result Hart::CSRRead_instreth(NativeWord* pOut) {
     return this->CSRRead_minstreth(pOut);
 }
 
+Result Hart::CSRRead_time(NativeWord* pOut) {
+    /* Read lower 32bits on RV32, full 64bits on RV64. */
+    DWord time = 0;
+    Result res = m_ClkTime.GetCurrentTime(&time, m_CycleCount);
+    *pOut = static_cast<NativeWord>(time);
+    return res;
+}
+
+Result Hart::CSRRead_timeh(NativeWord* pOut) {
+    /* This CSR doesn't exits on RV64. */
+    if constexpr(cfg::cpu::EnableIsaRV64I) {
+        return ResultCsrIdInvalid();
+    }
+
+    /* Read upper 32bits. */
+    DWord time = 0;
+    Result res = m_ClkTime.GetCurrentTime(&time, m_CycleCount);
+    *pOut = static_cast<NativeWord>(time >> 32);
+    return res;
+}
+
 } // namespace cpu
 } // namespace riscv
@@ -0,0 +1,31 @@
+#include <RiscvEmu/cpu/cpu_Hart.h>
+
+namespace riscv {
+namespace cpu {
+
+void Hart::EnterIdle() noexcept {
+    /* A wake which arrived since the last WFI is consumed instead of idling. */
+    IdleState expected = IdleState::Running;
+    if(!m_IdleState.compare_exchange_strong(expected, IdleState::Idle, std::memory_order_seq_cst)) {
+        m_IdleState.store(IdleState::Running, std::memory_order_seq_cst);
+    }
+}
+
+void Hart::Wake() noexcept {
+    /* Idle harts start running, running harts remember the wake for their next WFI. */
+    IdleState state = m_IdleState.load(std::memory_order_relaxed);
+    IdleState next;
+    do {
+        next = state == IdleState::Idle ? IdleState::Running : IdleState::WakePending;
+    } while(!m_IdleState.compare_exchange_weak(state, next, std::memory_order_seq_cst));
+
+    /* Release a host thread parked in WaitWhileIdle. */
+    if(state == IdleState::Idle) {
+        m_IdleState.notify_all();
+    }
+
+    this->InterruptWait();
+}
+
+} // namespace cpu
+} // namespace riscv
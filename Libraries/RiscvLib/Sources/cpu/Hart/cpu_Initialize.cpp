@@ -20,7 +20,11 @@ Result Hart::Initialize(SharedState* pSharedCtx, Word hartId) {
     /* Initialize memory monitor context. */
     m_MemMonitorCtx = m_pSharedCtx->GetMemMonitor()->GetContext(m_HartId);
 
-    return ResultSuccess();
+    /* Only a runner giving the hart its own host thread may let it block. */
+    m_BlockingWaitEnabled = false;
+
+    /* Initialize time source. */
+    return m_ClkTime.Initialize();
 }
 
 } // namespace cpu
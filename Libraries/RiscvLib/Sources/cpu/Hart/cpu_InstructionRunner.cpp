@@ -1,10 +1,14 @@
 #include <RiscvEmu/riscv_Types.h>
 #include <RiscvEmu/cpu/cpu_Hart.h>
 #include <RiscvEmu/cpu/cpu_Values.h>
+#include <RiscvEmu/cpu/detail/cpu_AtomicCompareSwap128.h>
 #include <RiscvEmu/cpu/detail/cpu_DecoderImpl.h>
 #include <RiscvEmu/cpu/detail/cpu_IntegerMultiply.h>
+#include <atomic>
 #include <bit>
 #include <concepts>
+#include <cstdint>
+#include <type_traits>
 
 namespace riscv {
 namespace cpu {
@@ -23,6 +27,49 @@ constexpr NativeWord MakeValForCSRRC(NativeWord curVal, NativeWord writeVal) noe
     return curVal & ~writeVal;
 }
 
+enum class AmoOp {
+    Swap,
+    Add,
+    Xor,
+    And,
+    Or,
+    Min,
+    Max,
+    MinU,
+    MaxU,
+}; // enum class AmoOp
+
+template<AmoOp Op, std::unsigned_integral T>
+constexpr T ApplyAmoOp(T cur, T src) noexcept {
+    using S = std::make_signed_t<T>;
+
+    if constexpr(Op == AmoOp::Swap) { return src; }
+    else if constexpr(Op == AmoOp::Add) { return cur + src; }
+    else if constexpr(Op == AmoOp::Xor) { return cur ^ src; }
+    else if constexpr(Op == AmoOp::And) { return cur & src; }
+    else if constexpr(Op == AmoOp::Or) { return cur | src; }
+    else if constexpr(Op == AmoOp::Min) { return static_cast<S>(cur) < static_cast<S>(src) ? cur : src; }
+    else if constexpr(Op == AmoOp::Max) { return static_cast<S>(cur) > static_cast<S>(src) ? cur : src; }
+    else if constexpr(Op == AmoOp::MinU) { return cur < src ? cur : src; }
+    else /* if constexpr(Op == AmoOp::MaxU) */ { return cur > src ? cur : src; }
+}
+
+/* Perform an AMO with a single host atomic instruction where one exists, returning the previous value. */
+template<AmoOp Op, std::unsigned_integral T>
+T HostAtomicAmo(std::atomic_ref<T> ref, T src) noexcept {
+    if constexpr(Op == AmoOp::Swap) { return ref.exchange(src); }
+    else if constexpr(Op == AmoOp::Add) { return ref.fetch_add(src); }
+    else if constexpr(Op == AmoOp::Xor) { return ref.fetch_xor(src); }
+    else if constexpr(Op == AmoOp::And) { return ref.fetch_and(src); }
+    else if constexpr(Op == AmoOp::Or) { return ref.fetch_or(src); }
+    else {
+        /* Min/max have no host equivalent, loop on a CAS instead. */
+        T cur = ref.load(std::memory_order_relaxed);
+        while(!ref.compare_exchange_weak(cur, ApplyAmoOp<Op>(cur, src))) {}
+        return cur;
+    }
+}
+
 } // namespace
 
 class Hart::InstructionRunner : public detail::DecoderImpl<Hart::InstructionRunner> {
@@ -99,9 +146,12 @@ private:
     Result InstLoadImpl(auto func, OutRegObject rd, InRegObject rs1, ImmediateObject imm) {
         /* Perform load. */
         T out = 0;
-        Result res = (*m_pParent.*func)(&out, rs1.Get<Address>() + imm.Get<Address>());
+        auto addr = rs1.Get<Address>() + imm.Get<Address>();
+        Result res = (*m_pParent.*func)(&out, addr);
 
         if(res.IsSuccess()) {
+            m_pParent->m_SpinDetector.OnLoad(addr, static_cast<DWord>(out));
+
             /* Sign extend if needed, write to output register. */
             if constexpr(Signed) {
                 rd.Set(util::SignExtend(static_cast<NativeWord>(out), sizeof(T) * 8, NativeWordBitLen));
@@ -149,6 +199,10 @@ private:
          */
         return ResultSuccess();
     }
+    Result ParseInstPAUSE() {
+        m_pParent->OnPauseHint();
+        return ResultSuccess();
+    }
     Result ParseInstFENCEI([[maybe_unused]] OutRegObject rd, [[maybe_unused]] InRegObject rs1, [[maybe_unused]] ImmediateObject imm) {
         /*
          * FENCE.I is used to sync instruction fetches and instructions writes.
@@ -237,25 +291,452 @@ private:
         /* Perform store. */
         Result res = (*m_pParent.*func)(rs2.Get<T>(), addr);
 
-        /* Revoke any reservations at this address aligned to sizeof(NativeWord). */
+        /* Revoke any reservations of the granule(s) written to. */
         if(res.IsSuccess()) {
-            m_pParent->m_MemMonitorCtx.TryRevokeAnyReservation(addr);
+            m_pParent->m_MemMonitorCtx.TryRevokeAnyReservation(addr, sizeof(T));
+            m_pParent->m_SpinDetector.OnSideEffect();
         }
 
         return res;
     }
     Result ParseInstSB(InRegObject rs1, InRegObject rs2, ImmediateObject imm) {
-        return m_pParent->MemWriteByte(rs2.Get<Byte>(), rs1.Get<Address>() + imm.Get<Address>());
+        return this->StoreInstImpl<Byte>(&Hart::MemWriteByte, rs1, rs2, imm);
     }
     Result ParseInstSH(InRegObject rs1, InRegObject rs2, ImmediateObject imm) {
-        return m_pParent->MemWriteHWord(rs2.Get<HWord>(), rs1.Get<Address>() + imm.Get<Address>());
+        return this->StoreInstImpl<HWord>(&Hart::MemWriteHWord, rs1, rs2, imm);
     }
     Result ParseInstSW(InRegObject rs1, InRegObject rs2, ImmediateObject imm) {
-        return m_pParent->MemWriteWord(rs2.Get<Word>(), rs1.Get<Address>() + imm.Get<Address>());
+        return this->StoreInstImpl<Word>(&Hart::MemWriteWord, rs1, rs2, imm);
     }
 #ifdef RISCV_CFG_CPU_ENABLE_RV64
     Result ParseInstSD(InRegObject rs1, InRegObject rs2, ImmediateObject imm) {
-        return m_pParent->MemWriteDWord(rs2.Get<DWord>(), rs1.Get<Address>() + imm.Get<Address>());
+        return this->StoreInstImpl<DWord>(&Hart::MemWriteDWord, rs1, rs2, imm);
+    }
+#endif // RISCV_CFG_CPU_ENABLE_RV64
+
+    /*
+     * Opcode AMO.
+     *
+     * Guest ram is accessed with host atomics directly, anything else is only made atomic
+     * with respect to other AMOs by holding exclusive access of the address.
+     */
+    template<typename T>
+    static auto GetMemCtlrRead() noexcept {
+        if constexpr(sizeof(T) == sizeof(Byte)) { return &mem::MemoryController::ReadByte; }
+        else if constexpr(sizeof(T) == sizeof(HWord)) { return &mem::MemoryController::ReadHWord; }
+        else if constexpr(sizeof(T) == sizeof(Word)) { return &mem::MemoryController::ReadWord; }
+        else { return &mem::MemoryController::ReadDWord; }
+    }
+    template<typename T>
+    static auto GetMemCtlrWrite() noexcept {
+        if constexpr(sizeof(T) == sizeof(Byte)) { return &mem::MemoryController::WriteByte; }
+        else if constexpr(sizeof(T) == sizeof(HWord)) { return &mem::MemoryController::WriteHWord; }
+        else if constexpr(sizeof(T) == sizeof(Word)) { return &mem::MemoryController::WriteWord; }
+        else { return &mem::MemoryController::WriteDWord; }
+    }
+
+    /* Translate the address of an atomic access, *ppHost receives nullptr unless it can be accessed with host atomics. */
+    Result TranslateAmoAddress(Byte** ppHost, Address* pPhysAddr, Address addr, std::size_t size, bool isLoad) {
+        if(addr % size) {
+            return isLoad ? Result(ResultLoadAddressMisaligned()) : Result(ResultStoreAddressMisaligned());
+        }
+
+        /* AMOs need write permission and raise store faults, only LR is a load. */
+        auto& memMgr = m_pParent->m_MemMgr;
+        Result res = isLoad ? memMgr.TranslateLoadAddress(pPhysAddr, addr, m_pParent->m_CurPrivLevel) :
+                              memMgr.TranslateStoreAddress(pPhysAddr, addr, m_pParent->m_CurPrivLevel);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Host atomics only agree with the memory controller's little endian accesses on little endian hosts. */
+        *ppHost = nullptr;
+        if constexpr(std::endian::native == std::endian::little) {
+            std::span<Byte> span;
+            if(m_pParent->m_pSharedCtx->GetMemController()->GetHostSpan(&span, *pPhysAddr, size).IsSuccess() &&
+               reinterpret_cast<std::uintptr_t>(span.data()) % size == 0) {
+                *ppHost = span.data();
+            }
+        }
+
+        return ResultSuccess();
+    }
+
+    /* Read-modify-write memory not backed by host memory, makeVal(cur, pNew) returns whether to write *pNew. */
+    template<typename T>
+    Result MmioAmoImpl(T* pOld, Address physAddr, auto makeVal) {
+        auto* pMemCtlr = m_pParent->m_pSharedCtx->GetMemController();
+
+        m_pParent->m_MemMonitorCtx.AquireExclusiveAccess(physAddr);
+        Result res = (*pMemCtlr.*GetMemCtlrRead<T>())(pOld, physAddr);
+        T val = 0;
+        if(res.IsSuccess() && makeVal(*pOld, &val)) {
+            res = (*pMemCtlr.*GetMemCtlrWrite<T>())(val, physAddr);
+        }
+        m_pParent->m_MemMonitorCtx.ReleaseExclusiveAccess();
+
+        return res;
+    }
+
+    /* Finish an atomic access which wrote to memory. */
+    void OnAmoWritten(Address addr, Address physAddr, std::size_t size) {
+        /* Like any other store, revoke reservations of the granule. */
+        m_pParent->m_pSharedCtx->GetMemController()->MarkDirty(physAddr, size);
+        m_pParent->m_MemMonitorCtx.TryRevokeAnyReservation(addr, size);
+    }
+
+    template<typename T>
+    Result InstLrImpl(OutRegObject rd, InRegObject rs1) {
+        auto addr = rs1.Get<Address>();
+
+        Byte* pHost = nullptr;
+        Address physAddr = 0;
+        Result res = this->TranslateAmoAddress(&pHost, &physAddr, addr, sizeof(T), true);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Reserve before loading so no store can slip in between unnoticed. */
+        m_pParent->m_MemMonitorCtx.AquireReservation(addr);
+
+        /* Perform load. */
+        T val = 0;
+        if(pHost) {
+            val = std::atomic_ref<T>(*reinterpret_cast<T*>(pHost)).load();
+        }
+        else {
+            auto* pMemCtlr = m_pParent->m_pSharedCtx->GetMemController();
+            res = (*pMemCtlr.*GetMemCtlrRead<T>())(&val, physAddr);
+            if(res.IsFailure()) {
+                m_pParent->m_MemMonitorCtx.ReleaseReservation();
+                return res;
+            }
+        }
+
+        /* SC additionally checks memory still holds this value. */
+        m_pParent->m_ReservedValue = val;
+        m_pParent->m_SpinDetector.OnLoad(addr, static_cast<DWord>(val));
+        rd.Set(static_cast<std::make_signed_t<T>>(val));
+        return ResultSuccess();
+    }
+
+    template<typename T>
+    Result InstScImpl(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        auto addr = rs1.Get<Address>();
+        m_pParent->m_SpinDetector.OnSideEffect();
+
+        Byte* pHost = nullptr;
+        Address physAddr = 0;
+        Result res = this->TranslateAmoAddress(&pHost, &physAddr, addr, sizeof(T), false);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Consuming the reservation invalidates any competing reservation of the granule. */
+        bool success = false;
+        if(m_pParent->m_MemMonitorCtx.TryConsumeReservation(addr)) {
+            auto expected = static_cast<T>(m_pParent->m_ReservedValue);
+            auto desired = rs2.Get<T>();
+
+            /* A CAS against the value LR loaded covers stores landing between consuming the reservation and storing. */
+            if(pHost) {
+                success = std::atomic_ref<T>(*reinterpret_cast<T*>(pHost)).compare_exchange_strong(expected, desired);
+            }
+            else {
+                T old = 0;
+                res = this->MmioAmoImpl<T>(&old, physAddr, [&](T cur, T* pNew) {
+                    *pNew = desired;
+                    return success = cur == expected;
+                });
+                if(res.IsFailure()) {
+                    return res;
+                }
+            }
+
+            if(success) {
+                m_pParent->m_pSharedCtx->GetMemController()->MarkDirty(physAddr, sizeof(T));
+            }
+        }
+
+        rd.Set(success ? 0u : 1u);
+        return ResultSuccess();
+    }
+
+    template<AmoOp Op, typename T>
+    Result InstAmoImpl(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        auto addr = rs1.Get<Address>();
+        m_pParent->m_SpinDetector.OnSideEffect();
+
+        Byte* pHost = nullptr;
+        Address physAddr = 0;
+        Result res = this->TranslateAmoAddress(&pHost, &physAddr, addr, sizeof(T), false);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Perform the read-modify-write. */
+        auto src = rs2.Get<T>();
+        T old = 0;
+        if(pHost) {
+            old = HostAtomicAmo<Op>(std::atomic_ref<T>(*reinterpret_cast<T*>(pHost)), src);
+        }
+        else {
+            res = this->MmioAmoImpl<T>(&old, physAddr, [src](T cur, T* pNew) {
+                *pNew = ApplyAmoOp<Op>(cur, src);
+                return true;
+            });
+            if(res.IsFailure()) {
+                return res;
+            }
+        }
+        this->OnAmoWritten(addr, physAddr, sizeof(T));
+
+        rd.Set(static_cast<std::make_signed_t<T>>(old));
+        return ResultSuccess();
+    }
+
+    template<typename T>
+    Result InstCasImpl(OutRegObject rd, InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        auto addr = rs1.Get<Address>();
+        m_pParent->m_SpinDetector.OnSideEffect();
+
+        Byte* pHost = nullptr;
+        Address physAddr = 0;
+        Result res = this->TranslateAmoAddress(&pHost, &physAddr, addr, sizeof(T), false);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* old receives the previous value whether or not the swap happens. */
+        auto expected = rdVal.Get<T>();
+        auto desired = rs2.Get<T>();
+        T old = expected;
+        bool swapped = false;
+        if(pHost) {
+            swapped = std::atomic_ref<T>(*reinterpret_cast<T*>(pHost)).compare_exchange_strong(old, desired);
+        }
+        else {
+            res = this->MmioAmoImpl<T>(&old, physAddr, [&](T cur, T* pNew) {
+                *pNew = desired;
+                return swapped = cur == expected;
+            });
+            if(res.IsFailure()) {
+                return res;
+            }
+        }
+
+        if(swapped) {
+            this->OnAmoWritten(addr, physAddr, sizeof(T));
+        }
+
+        rd.Set(static_cast<std::make_signed_t<T>>(old));
+        return ResultSuccess();
+    }
+
+    /* AMOCAS on an even/odd register pair, each register holding one half of a value twice the register width. */
+    template<typename HalfT>
+    Result InstCasPairImpl(OutRegObject rdLo, OutRegObject rdHi, InRegObject cmpLo, InRegObject cmpHi, InRegObject rs1, InRegObject swapLo, InRegObject swapHi) {
+        auto addr = rs1.Get<Address>();
+        m_pParent->m_SpinDetector.OnSideEffect();
+
+        Byte* pHost = nullptr;
+        Address physAddr = 0;
+        Result res = this->TranslateAmoAddress(&pHost, &physAddr, addr, sizeof(HalfT) * 2, false);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        HalfT oldLo = cmpLo.Get<HalfT>();
+        HalfT oldHi = cmpHi.Get<HalfT>();
+        bool swapped = false;
+        if(pHost) {
+            if constexpr(sizeof(HalfT) == sizeof(DWord)) {
+                /* There's no standard 128-bit atomic guaranteed to be lock free, use the host instruction directly. */
+                uint64_t old[2] = { oldLo, oldHi };
+                swapped = detail::CompareSwap128(reinterpret_cast<uint64_t*>(pHost), old, swapLo.Get<DWord>(), swapHi.Get<DWord>());
+                oldLo = old[0];
+                oldHi = old[1];
+            }
+            else {
+                auto old = static_cast<DWord>(oldHi) << 32 | oldLo;
+                auto desired = static_cast<DWord>(swapHi.Get<Word>()) << 32 | swapLo.Get<Word>();
+                swapped = std::atomic_ref<DWord>(*reinterpret_cast<DWord*>(pHost)).compare_exchange_strong(old, desired);
+                oldLo = static_cast<Word>(old);
+                oldHi = static_cast<Word>(old >> 32);
+            }
+        }
+        else {
+            auto* pMemCtlr = m_pParent->m_pSharedCtx->GetMemController();
+            auto expectedLo = oldLo;
+            auto expectedHi = oldHi;
+
+            m_pParent->m_MemMonitorCtx.AquireExclusiveAccess(physAddr);
+            res = (*pMemCtlr.*GetMemCtlrRead<HalfT>())(&oldLo, physAddr);
+            if(res.IsSuccess()) {
+                res = (*pMemCtlr.*GetMemCtlrRead<HalfT>())(&oldHi, physAddr + sizeof(HalfT));
+            }
+            if(res.IsSuccess() && oldLo == expectedLo && oldHi == expectedHi) {
+                res = (*pMemCtlr.*GetMemCtlrWrite<HalfT>())(swapLo.Get<HalfT>(), physAddr);
+                if(res.IsSuccess()) {
+                    res = (*pMemCtlr.*GetMemCtlrWrite<HalfT>())(swapHi.Get<HalfT>(), physAddr + sizeof(HalfT));
+                }
+                swapped = res.IsSuccess();
+            }
+            m_pParent->m_MemMonitorCtx.ReleaseExclusiveAccess();
+
+            if(res.IsFailure()) {
+                return res;
+            }
+        }
+
+        if(swapped) {
+            this->OnAmoWritten(addr, physAddr, sizeof(HalfT) * 2);
+        }
+
+        rdLo.Set(oldLo);
+        rdHi.Set(oldHi);
+        return ResultSuccess();
+    }
+
+    Result ParseInstAMOCAS_B(OutRegObject rd, InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->InstCasImpl<Byte>(rd, rdVal, rs1, rs2);
+    }
+    Result ParseInstAMOSWAP_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Swap, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOADD_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Add, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOXOR_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Xor, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOAND_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::And, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOOR_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Or, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMIN_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Min, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAX_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Max, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMINU_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MinU, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAXU_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MaxU, Byte>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOCAS_H(OutRegObject rd, InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->InstCasImpl<HWord>(rd, rdVal, rs1, rs2);
+    }
+    Result ParseInstAMOSWAP_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Swap, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOADD_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Add, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOXOR_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Xor, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOAND_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::And, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOOR_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Or, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMIN_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Min, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAX_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Max, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMINU_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MinU, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAXU_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MaxU, HWord>(rd, rs1, rs2);
+    }
+    Result ParseInstLR_W(OutRegObject rd, InRegObject rs1) {
+        return this->InstLrImpl<Word>(rd, rs1);
+    }
+    Result ParseInstSC_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstScImpl<Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOCAS_W(OutRegObject rd, InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->InstCasImpl<Word>(rd, rdVal, rs1, rs2);
+    }
+    Result ParseInstAMOSWAP_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Swap, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOADD_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Add, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOXOR_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Xor, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOAND_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::And, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOOR_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Or, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMIN_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Min, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAX_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Max, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMINU_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MinU, Word>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAXU_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MaxU, Word>(rd, rs1, rs2);
+    }
+#ifdef RISCV_CFG_CPU_ENABLE_RV64
+    Result ParseInstLR_D(OutRegObject rd, InRegObject rs1) {
+        return this->InstLrImpl<DWord>(rd, rs1);
+    }
+    Result ParseInstSC_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstScImpl<DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOCAS_D(OutRegObject rd, InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->InstCasImpl<DWord>(rd, rdVal, rs1, rs2);
+    }
+    Result ParseInstAMOSWAP_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Swap, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOADD_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Add, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOXOR_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Xor, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOAND_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::And, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOOR_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Or, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMIN_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Min, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAX_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::Max, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMINU_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MinU, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOMAXU_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->InstAmoImpl<AmoOp::MaxU, DWord>(rd, rs1, rs2);
+    }
+    Result ParseInstAMOCAS_Q(OutRegObject rdLo, OutRegObject rdHi, InRegObject cmpLo, InRegObject cmpHi, InRegObject rs1, InRegObject swapLo, InRegObject swapHi) {
+        return this->InstCasPairImpl<DWord>(rdLo, rdHi, cmpLo, cmpHi, rs1, swapLo, swapHi);
+    }
+#else
+    Result ParseInstAMOCAS_D(OutRegObject rdLo, OutRegObject rdHi, InRegObject cmpLo, InRegObject cmpHi, InRegObject rs1, InRegObject swapLo, InRegObject swapHi) {
+        return this->InstCasPairImpl<Word>(rdLo, rdHi, cmpLo, cmpHi, rs1, swapLo, swapHi);
     }
 #endif // RISCV_CFG_CPU_ENABLE_RV64
 
@@ -407,8 +888,16 @@ private:
     /*
      * Opcode BRANCH.
      */
+    void OnTakenBranch(Address offset) {
+        auto pc = m_pParent->m_PC;
+        m_pParent->m_SelfLooping = offset == 0;
+        if(m_pParent->m_SpinDetector.OnBranch(pc, pc + offset, m_pParent->m_GPR)) {
+            m_pParent->OnSpinLoop();
+        }
+    }
     Result InstBranchImpl(bool cond, ImmediateObject imm) {
         if(cond) {
+            this->OnTakenBranch(imm.Get<Address>());
             return m_pParent->SignalBranch(imm.Get<Address>());
         }
         return ResultSuccess();
@@ -451,6 +940,7 @@ private:
         rd.Set(m_pParent->m_PC + 4);
 
         /* Signal branch. */
+        this->OnTakenBranch(imm.Get<Address>());
         return m_pParent->SignalBranch(imm.Get<Address>());
     }
 
@@ -509,6 +999,24 @@ private:
 
         return res;
     }
+    Result ParseInstWFI() {
+        /* Execution continues after WFI, whoever runs the hart may stop scheduling it until it's woken. */
+        m_pParent->EnterIdle();
+        return ResultSuccess();
+    }
+    Result ParseInstWRS_NTO() {
+        /* Stalling is optional, harts sharing a host thread with others just retire it like a NOP. */
+        if(m_pParent->m_BlockingWaitEnabled) {
+            m_pParent->m_MemMonitorCtx.WaitForReservationLoss();
+        }
+        return ResultSuccess();
+    }
+    Result ParseInstWRS_STO() {
+        if(m_pParent->m_BlockingWaitEnabled) {
+            m_pParent->m_MemMonitorCtx.WaitForReservationLoss(c_WrsShortTimeout);
+        }
+        return ResultSuccess();
+    }
 private:
     Hart* const m_pParent = 0;
 }; // class Hart::InstructionRunner
@@ -10,6 +10,15 @@ Result Hart::Reset() {
     /* Initialize cycle counter to zero. */
     m_CycleCount = 0;
 
+    /* Drop any reservation from before the reset. */
+    m_MemMonitorCtx.ReleaseReservation();
+
+    /* Start out running. */
+    m_IdleState.store(IdleState::Running, std::memory_order_relaxed);
+    m_YieldRequested = false;
+    m_SelfLooping = false;
+    m_SpinDetector.Reset();
+
     return ResultSuccess();
 }
 
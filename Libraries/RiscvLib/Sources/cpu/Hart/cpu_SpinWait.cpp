@@ -0,0 +1,37 @@
+#include <RiscvEmu/cpu/cpu_Hart.h>
+#include <thread>
+
+namespace riscv {
+namespace cpu {
+
+void Hart::OnSpinLoop() {
+    /* Harts sharing a host thread can't block it, ask the runner to switch to another hart instead. */
+    if(!m_BlockingWaitEnabled) {
+        m_YieldRequested = true;
+        return;
+    }
+
+    /* Arm the watch first, so the loop's next load happens after it. */
+    Address addr = m_SpinDetector.GetWatchAddress();
+    if(!m_SpinDetector.IsWatchArmed()) {
+        m_SpinDetector.ArmWatch(m_MemMonitorCtx.WatchStores(addr));
+        return;
+    }
+
+    /* Park until the watched granule is stored to. */
+    m_MemMonitorCtx.WaitForStore(addr, m_SpinDetector.GetWatchTag(), c_SpinParkTimeout);
+    m_SpinDetector.DisarmWatch();
+}
+
+void Hart::OnPauseHint() {
+    if(!m_BlockingWaitEnabled) {
+        m_YieldRequested = true;
+        return;
+    }
+
+    /* There's no address to watch, just give other host threads a chance to run. */
+    std::this_thread::yield();
+}
+
+} // namespace cpu
+} // namespace riscv
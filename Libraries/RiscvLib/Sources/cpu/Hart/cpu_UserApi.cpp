@@ -21,7 +21,18 @@ Result Hart::ExecuteInstAtPc() {
         return res;
     }
 
-    return this->ExecuteInst(inst);
+    m_PCWritten = false;
+    res = this->ExecuteInst(inst);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Move on to the next instruction if this one didn't change control flow. */
+    if(!m_PCWritten) {
+        m_PC += sizeof(Word);
+    }
+
+    return ResultSuccess();
 }
 
 Result Hart::WriteCSR(CsrId id, NativeWord value) {
@@ -143,6 +143,10 @@ private:
     constexpr Result ParseInstFENCE([[maybe_unused]] OutRegObject rd, [[maybe_unused]] InRegObject rs1, [[maybe_unused]] ImmediateObject imm) {
         return ResultSuccess();
     }
+    constexpr Result ParseInstPAUSE() {
+        m_StrTmp = "PAUSE";
+        return ResultSuccess();
+    }
     constexpr Result ParseInstFENCEI([[maybe_unused]] OutRegObject rd, [[maybe_unused]] InRegObject rs1, [[maybe_unused]] ImmediateObject imm) {
         m_StrTmp = "FENCE.I";
         return ResultSuccess();
@@ -226,6 +230,159 @@ private:
     }
 #endif // RISCV_CFG_CPU_ENABLE_RV64
 
+    /*
+     * Opcode AMO.
+     */
+    constexpr Result FormatAMO(std::string_view name, OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        m_StrTmp = std::format("{} x{}, x{}, (x{})", name, rd.GetId(), rs2.GetId(), rs1.GetId());
+        return ResultSuccess();
+    }
+    constexpr Result ParseInstAMOCAS_B(OutRegObject rd, [[maybe_unused]] InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOCAS.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOSWAP_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOSWAP.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOADD_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOADD.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOXOR_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOXOR.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOAND_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOAND.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOOR_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOOR.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMIN_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMIN.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAX_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAX.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMINU_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMINU.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAXU_B(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAXU.B", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOCAS_H(OutRegObject rd, [[maybe_unused]] InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOCAS.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOSWAP_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOSWAP.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOADD_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOADD.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOXOR_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOXOR.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOAND_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOAND.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOOR_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOOR.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMIN_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMIN.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAX_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAX.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMINU_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMINU.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAXU_H(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAXU.H", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstLR_W(OutRegObject rd, InRegObject rs1) {
+        m_StrTmp = std::format("LR.W x{}, (x{})", rd.GetId(), rs1.GetId());
+        return ResultSuccess();
+    }
+    constexpr Result ParseInstSC_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("SC.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOCAS_W(OutRegObject rd, [[maybe_unused]] InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOCAS.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOSWAP_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOSWAP.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOADD_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOADD.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOXOR_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOXOR.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOAND_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOAND.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOOR_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOOR.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMIN_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMIN.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAX_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAX.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMINU_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMINU.W", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAXU_W(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAXU.W", rd, rs1, rs2);
+    }
+#ifdef RISCV_CFG_CPU_ENABLE_RV64
+    constexpr Result ParseInstLR_D(OutRegObject rd, InRegObject rs1) {
+        m_StrTmp = std::format("LR.D x{}, (x{})", rd.GetId(), rs1.GetId());
+        return ResultSuccess();
+    }
+    constexpr Result ParseInstSC_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("SC.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOCAS_D(OutRegObject rd, [[maybe_unused]] InRegObject rdVal, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOCAS.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOSWAP_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOSWAP.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOADD_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOADD.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOXOR_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOXOR.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOAND_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOAND.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOOR_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOOR.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMIN_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMIN.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAX_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAX.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMINU_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMINU.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOMAXU_D(OutRegObject rd, InRegObject rs1, InRegObject rs2) {
+        return this->FormatAMO("AMOMAXU.D", rd, rs1, rs2);
+    }
+    constexpr Result ParseInstAMOCAS_Q(OutRegObject rdLo, [[maybe_unused]] OutRegObject rdHi, [[maybe_unused]] InRegObject cmpLo, [[maybe_unused]] InRegObject cmpHi,
+        InRegObject rs1, InRegObject swapLo, [[maybe_unused]] InRegObject swapHi) {
+        return this->FormatAMO("AMOCAS.Q", rdLo, rs1, swapLo);
+    }
+#else
+    constexpr Result ParseInstAMOCAS_D(OutRegObject rdLo, [[maybe_unused]] OutRegObject rdHi, [[maybe_unused]] InRegObject cmpLo, [[maybe_unused]] InRegObject cmpHi,
+        InRegObject rs1, InRegObject swapLo, [[maybe_unused]] InRegObject swapHi) {
+        return this->FormatAMO("AMOCAS.D", rdLo, rs1, swapLo);
+    }
+#endif // RISCV_CFG_CPU_ENABLE_RV64
+
     /*
      * Opcode OP.
      */
@@ -388,6 +545,18 @@ private:
     constexpr Result ParseInstCSRRCI(OutRegObject rd, ImmediateObject src, ImmediateObject csr) {
         return this->FormatCSRI("CSRRCI", rd, src, csr);
     }
+    constexpr Result ParseInstWFI() {
+        m_StrTmp = "WFI";
+        return ResultSuccess();
+    }
+    constexpr Result ParseInstWRS_NTO() {
+        m_StrTmp = "WRS.NTO";
+        return ResultSuccess();
+    }
+    constexpr Result ParseInstWRS_STO() {
+        m_StrTmp = "WRS.STO";
+        return ResultSuccess();
+    }
 
 private:
     std::string m_StrTmp;
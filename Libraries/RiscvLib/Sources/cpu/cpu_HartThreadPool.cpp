@@ -0,0 +1,214 @@
+#include <RiscvEmu/cpu/cpu_HartThreadPool.h>
+#include <RiscvEmu/diag.h>
+#include <algorithm>
+
+namespace riscv {
+namespace cpu {
+
+void HartThreadPool::Start(Hart* pHarts, Word hartCount, std::size_t workerCount, DWord quantum) {
+    diag::AssertNotNull(pHarts);
+    diag::Assert(hartCount > 0 && quantum > 0);
+    diag::Assert(!this->IsRunning());
+
+    /* Default to one worker per host core, more workers than harts would never have work. */
+    if(workerCount == 0) {
+        workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    workerCount = std::min<std::size_t>(workerCount, hartCount);
+
+    m_pHarts = pHarts;
+    m_HartCount = hartCount;
+    m_Quantum = quantum;
+    m_WorkerCount = workerCount;
+
+    /* Clear state left over from a previous run. */
+    m_StopRequested.store(false, std::memory_order_relaxed);
+    m_HartResult.store(ResultSuccess().GetValue(), std::memory_order_relaxed);
+    m_QueuedCount.store(0, std::memory_order_relaxed);
+    m_SleepingCount.store(0, std::memory_order_relaxed);
+
+    /* Spread harts evenly across the workers, idle harts start out parked. */
+    m_pQueues = std::make_unique<WorkerQueue[]>(m_WorkerCount);
+    m_pParked = std::make_unique<std::atomic<bool>[]>(m_HartCount);
+    for(Word i = 0; i < m_HartCount; i++) {
+        if(m_pHarts[i].IsIdle()) {
+            this->ParkHart(i % m_WorkerCount, i);
+        }
+        else {
+            this->PushHart(i % m_WorkerCount, i);
+        }
+    }
+
+    /* Start workers. */
+    m_pWorkers = std::make_unique<std::thread[]>(m_WorkerCount);
+    for(std::size_t i = 0; i < m_WorkerCount; i++) {
+        m_pWorkers[i] = std::thread(&HartThreadPool::RunWorker, this, i);
+    }
+
+    /* Let wakes use the pool now it's set up. */
+    m_Running.store(true, std::memory_order_seq_cst);
+}
+
+void HartThreadPool::Stop() noexcept {
+    m_StopRequested.store(true, std::memory_order_seq_cst);
+
+    /* Wake any sleeping workers so they see the request. */
+    std::scoped_lock lk(m_SleepMutex);
+    m_SleepCv.notify_all();
+}
+
+Result HartThreadPool::Join() {
+    diag::Assert(this->IsRunning());
+
+    /* Wait for every worker to exit. */
+    for(std::size_t i = 0; i < m_WorkerCount; i++) {
+        m_pWorkers[i].join();
+    }
+
+    /* Turn new wakes away, then wait out any which saw the pool running before it's torn down. */
+    m_Running.store(false, std::memory_order_seq_cst);
+    while(m_WakesInFlight.load(std::memory_order_seq_cst) > 0) {
+        std::this_thread::yield();
+    }
+    m_pWorkers.reset();
+
+    return Result(m_HartResult.load(std::memory_order_relaxed));
+}
+
+bool HartThreadPool::Wake(Word hartId) {
+    /* Announce ourselves before checking the pool is running, so Join either turns us away or waits for us. */
+    m_WakesInFlight.fetch_add(1, std::memory_order_seq_cst);
+    const bool running = m_Running.load(std::memory_order_seq_cst);
+    if(running) {
+        diag::Assert(hartId < m_HartCount);
+
+        m_pHarts[hartId].Wake();
+
+        /* Only the caller which unparks the hart requeues it. */
+        if(m_pParked[hartId].exchange(false, std::memory_order_seq_cst)) {
+            this->PushHart(hartId % m_WorkerCount, hartId);
+        }
+    }
+    m_WakesInFlight.fetch_sub(1, std::memory_order_seq_cst);
+
+    return running;
+}
+
+void HartThreadPool::RunWorker(std::size_t workerIndex) {
+    while(!m_StopRequested.load(std::memory_order_relaxed)) {
+        /* Get a hart to run, from our own queue first. */
+        Word hartId = 0;
+        if(!this->PopHart(workerIndex, &hartId) && !this->StealHart(workerIndex, &hartId)) {
+            this->WaitForWork();
+            continue;
+        }
+
+        Hart& hart = m_pHarts[hartId];
+        Result res = this->ExecuteQuantum(hart);
+        if(res.IsFailure()) {
+            this->SignalHartFailure(res);
+            break;
+        }
+
+        /* Requeue the hart unless it has nothing to do. */
+        if(hart.IsIdle()) {
+            this->ParkHart(workerIndex, hartId);
+        }
+        else {
+            this->PushHart(workerIndex, hartId);
+        }
+    }
+}
+
+bool HartThreadPool::PopHart(std::size_t workerIndex, Word* pOut) {
+    auto& queue = m_pQueues[workerIndex];
+
+    /* Take from the front so every hart in the queue gets a turn. */
+    std::scoped_lock lk(queue.mutex);
+    if(queue.harts.empty()) {
+        return false;
+    }
+
+    *pOut = queue.harts.front();
+    queue.harts.pop_front();
+    m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool HartThreadPool::StealHart(std::size_t workerIndex, Word* pOut) {
+    for(std::size_t i = 1; i < m_WorkerCount; i++) {
+        auto& queue = m_pQueues[(workerIndex + i) % m_WorkerCount];
+
+        /* Steal from the back, the hart that has waited the least. */
+        std::scoped_lock lk(queue.mutex);
+        if(!queue.harts.empty()) {
+            *pOut = queue.harts.back();
+            queue.harts.pop_back();
+            m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void HartThreadPool::PushHart(std::size_t workerIndex, Word hartId) {
+    auto& queue = m_pQueues[workerIndex];
+    {
+        std::scoped_lock lk(queue.mutex);
+        queue.harts.push_back(hartId);
+    }
+    m_QueuedCount.fetch_add(1, std::memory_order_seq_cst);
+
+    /* Only take the sleep lock when there's someone to wake. */
+    if(m_SleepingCount.load(std::memory_order_seq_cst) > 0) {
+        std::scoped_lock lk(m_SleepMutex);
+        m_SleepCv.notify_one();
+    }
+}
+
+void HartThreadPool::ParkHart(std::size_t workerIndex, Word hartId) {
+    m_pParked[hartId].store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    /* The hart may have been woken before it was marked parked, in which case Wake won't requeue it. */
+    if(!m_pHarts[hartId].IsIdle() && m_pParked[hartId].exchange(false, std::memory_order_seq_cst)) {
+        this->PushHart(workerIndex, hartId);
+    }
+}
+
+void HartThreadPool::WaitForWork() {
+    m_SleepingCount.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::unique_lock lk(m_SleepMutex);
+        m_SleepCv.wait(lk, [this] {
+            return m_QueuedCount.load(std::memory_order_seq_cst) > 0 || m_StopRequested.load(std::memory_order_seq_cst);
+        });
+    }
+    m_SleepingCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+Result HartThreadPool::ExecuteQuantum(Hart& hart) {
+    /* Stop early if the hart goes idle or yields so the worker can move on. */
+    for(DWord i = 0; i < m_Quantum && !hart.IsIdle(); i++) {
+        Result res = hart.ExecuteInstAtPc();
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Requeue spinning harts early so harts with useful work get to run. */
+        if(hart.ConsumeYieldRequest()) {
+            break;
+        }
+    }
+    return ResultSuccess();
+}
+
+void HartThreadPool::SignalHartFailure(Result res) noexcept {
+    /* Record the first failure and bring down the remaining workers. */
+    Word expected = ResultSuccess().GetValue();
+    m_HartResult.compare_exchange_strong(expected, res.GetValue(), std::memory_order_relaxed);
+    this->Stop();
+}
+
+} // namespace cpu
+} // namespace riscv
@@ -0,0 +1,76 @@
+#include <RiscvEmu/cpu/cpu_Pacer.h>
+#include <RiscvEmu/diag.h>
+#include <RiscvEmu/util/util_Frequency.h>
+#include <algorithm>
+#include <thread>
+
+namespace riscv {
+namespace cpu {
+
+namespace {
+
+constexpr DWord NsPerSecond = 1'000'000'000;
+
+constexpr std::chrono::nanoseconds ToDuration(DWord ns) noexcept {
+    return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(ns));
+}
+
+} // namespace
+
+void Pacer::Start(DWord freq, DWord instCount) {
+    diag::Assert(freq > 0);
+
+    m_Freq = freq;
+    m_CheckInterval = std::max<DWord>(util::ScaleCount(SleepGranularity, NsPerSecond, freq), 1);
+    m_SliceInstCount = std::max<DWord>(util::ScaleCount(MaxSleepSlice, NsPerSecond, freq), 1);
+    m_Oversleep = {};
+
+    this->Resync(instCount);
+}
+
+void Pacer::Resync(DWord instCount) {
+    m_BaseTime = Clock::now();
+    m_BaseCount = instCount;
+    m_LastCount = instCount;
+}
+
+void Pacer::Pace(DWord instCount, const std::atomic<bool>& stopRequested) {
+    /* The guest moved its counter backwards, there's no schedule to keep. */
+    if(instCount < m_LastCount) {
+        this->Resync(instCount);
+        return;
+    }
+    m_LastCount = instCount;
+
+    /* Compare guest time to host time on the same schedule. */
+    auto target = m_BaseTime + ToDuration(util::ScaleCount(instCount - m_BaseCount, m_Freq, NsPerSecond));
+    auto now = Clock::now();
+    if(target > now + ToDuration(MaxDrift) || target + ToDuration(MaxDrift) < now) {
+        this->Resync(instCount);
+        return;
+    }
+
+    /* Leads below the granularity are left for a later check, falling behind is made up by not sleeping. */
+    if(target - now < ToDuration(SleepGranularity)) {
+        return;
+    }
+
+    /* Sleep off the lead in slices, waking early by the host's usual oversleep. */
+    while(!stopRequested.load(std::memory_order_relaxed)) {
+        auto wake = target - m_Oversleep;
+        if(wake <= now) {
+            break;
+        }
+
+        auto sliceEnd = std::min(wake, now + ToDuration(MaxSleepSlice));
+        std::this_thread::sleep_until(sliceEnd);
+        now = Clock::now();
+
+        /* Track the oversleep as a moving average, bounded so an outlier can't make us wake far too early. */
+        m_Oversleep += ((now - sliceEnd) - m_Oversleep) / 8;
+        m_Oversleep = std::clamp<Clock::duration>(m_Oversleep, Clock::duration::zero(), ToDuration(SleepGranularity) / 2);
+    }
+}
+
+} // namespace cpu
+} // namespace riscv
@@ -0,0 +1,15 @@
+#include <RiscvEmu/cpu/detail/cpu_AtomicCompareSwap128.h>
+
+extern "C" bool __riscvCpuCompareSwap128Impl(uint64_t* pMem, uint64_t* pExpected, uint64_t desiredLow, uint64_t desiredHigh);
+
+namespace riscv {
+namespace cpu {
+namespace detail {
+
+bool CompareSwap128(uint64_t* pMem, uint64_t* pExpected, uint64_t desiredLow, uint64_t desiredHigh) {
+    return __riscvCpuCompareSwap128Impl(pMem, pExpected, desiredLow, desiredHigh);
+}
+
+} // namespace detail
+} // namespace cpu
+} // namespace riscv
@@ -1,39 +1,164 @@
 #include <RiscvEmu/cpu/detail/cpu_ClkTime.h>
+#include <RiscvEmu/diag.h>
+#include <RiscvEmu/util/util_Frequency.h>
+#include <algorithm>
 #include <time.h>
 
+extern "C" uint64_t __riscvCpuReadCycleCounterImpl();
+
 namespace riscv {
 namespace cpu {
 namespace detail {
 
 namespace {
 
-DWord GetCurrentTimeImpl() {
+constexpr DWord NsPerSecond = 1'000'000'000;
+
+/* Calibration window at startup, the first interval refines it. */
+constexpr DWord InitialCalibrationNs = 1'000'000;
+
+DWord GetMonotonicNs() {
+    /* CLOCK_MONOTONIC is served from the vDSO, without entering the kernel. */
     timespec time;
-    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
-    return static_cast<DWord>(time.tv_nsec);
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<DWord>(time.tv_sec) * NsPerSecond + static_cast<DWord>(time.tv_nsec);
+}
+
+struct CycleCounterInfo {
+    /* Host cycles per second, 0 if the counter can't be used. */
+    DWord freq;
+
+    /* Clock and counter at the same instant, shared by all instances so harts agree on time. */
+    DWord epochNs;
+    DWord epochCycles;
+}; // struct CycleCounterInfo
+
+const CycleCounterInfo& GetCycleCounterInfo() {
+    /* Measure the counter's frequency once per process. */
+    static const CycleCounterInfo s_Info = [] {
+        DWord startNs = GetMonotonicNs();
+        DWord startCycles = __riscvCpuReadCycleCounterImpl();
+
+        DWord endNs = startNs;
+        while(endNs - startNs < InitialCalibrationNs) {
+            endNs = GetMonotonicNs();
+        }
+        DWord endCycles = __riscvCpuReadCycleCounterImpl();
+
+        /* Fall back to the clock if the counter doesn't advance. */
+        DWord cycles = endCycles - startCycles;
+        DWord freq = cycles > 0 ? util::ScaleCount(cycles, endNs - startNs, NsPerSecond) : 0;
+        return CycleCounterInfo{ freq, endNs, endCycles };
+    }();
+
+    return s_Info;
 }
 
 } // namespace
 
-Result ClkTime::Initialize() {
-    /* Set offset to current time. */
-    m_Offset = GetCurrentTimeImpl();
+Result ClkTime::Initialize(DWord freq) {
+    /* Scales are 32.32 fixed point. */
+    diag::Assert(freq > 0 && freq <= 0xFFFFFFFF);
+
+    m_Mode = Mode::Instret;
+    m_Freq = freq;
+    m_InstFreq = freq;
+    m_pSource = nullptr;
+
+    /* Use the counter calibration shared between harts as the starting point. */
+    const auto& info = GetCycleCounterInfo();
+    m_UseCycleCounter = info.freq > 0;
+    m_BaseCycles = info.epochCycles;
+    m_BaseTime = 0;
+    m_CycleScale = m_UseCycleCounter ? (util::ScaleCount(info.freq, info.freq, m_Freq) << 32) / info.freq : 0;
+    m_CalibrationCycles = m_UseCycleCounter ? util::ScaleCount(CalibrationInterval, NsPerSecond, info.freq) : 0;
+
+    /* Time starts at 0. */
+    m_Last = 0;
+    m_Offset = 0;
+    m_Offset = -this->GetSourceTime(0);
 
     return ResultSuccess();
 }
 
-Result ClkTime::GetCurrentTime(DWord* pOut) {
-    /* Take difference between current time and offset. */
-    *pOut = GetCurrentTimeImpl() - m_Offset;
+void ClkTime::SetMode(Mode mode, DWord instret, DWord instFreq) {
+    diag::Assert(mode != Mode::External, "External time needs a source, see SetSource!\n");
+    diag::Assert(instFreq > 0);
+
+    /* Carry the current time over to the new source. */
+    DWord now = 0;
+    this->GetCurrentTime(&now, instret);
+
+    m_Mode = mode;
+    m_InstFreq = instFreq;
+    m_Offset = now - this->GetSourceTime(instret);
+    m_Last = now;
+}
+
+void ClkTime::SetSource(const ITimeSource* pSource) {
+    diag::AssertNotNull(pSource);
+
+    /* The source's time is used as is, it may be behind the current time. */
+    m_Mode = Mode::External;
+    m_pSource = pSource;
+    m_Offset = 0;
+    m_Last = 0;
+}
+
+Result ClkTime::GetCurrentTime(DWord* pOut, DWord instret) {
+    /* Hold time still rather than letting recalibration or a mode switch move it backwards. */
+    m_Last = std::max(m_Last, this->GetSourceTime(instret) + m_Offset);
+    *pOut = m_Last;
     return ResultSuccess();
 }
 
-Result ClkTime::SetCurrentTime(DWord in) {
+Result ClkTime::SetCurrentTime(DWord in, DWord instret) {
     /* Set offset to the difference between the current time and the requested time. */
-    m_Offset = GetCurrentTimeImpl() - in;
+    m_Offset = in - this->GetSourceTime(instret);
+    m_Last = in;
     return ResultSuccess();
 }
 
+DWord ClkTime::GetSourceTime(DWord instret) {
+    switch(m_Mode) {
+    case Mode::Instret:
+        return util::ScaleCount(instret, m_InstFreq, m_Freq);
+    case Mode::HostClock:
+        return this->GetHostTime();
+    case Mode::External:
+        return m_pSource->GetTime();
+    }
+    return 0;
+}
+
+DWord ClkTime::GetHostTime() {
+    if(!m_UseCycleCounter) {
+        return util::ScaleCount(GetMonotonicNs() - GetCycleCounterInfo().epochNs, NsPerSecond, m_Freq);
+    }
+
+    /* Correct drift against the clock once the interval passed, this also keeps the multiplication in range. */
+    DWord cycles = __riscvCpuReadCycleCounterImpl();
+    if(cycles - m_BaseCycles >= m_CalibrationCycles) {
+        this->Calibrate(cycles);
+    }
+
+    return m_BaseTime + (((cycles - m_BaseCycles) * m_CycleScale) >> 32);
+}
+
+void ClkTime::Calibrate(DWord cycles) {
+    /* Rebase on the clock and scale the counter by the rate time actually advanced at since the last calibration. */
+    DWord time = util::ScaleCount(GetMonotonicNs() - GetCycleCounterInfo().epochNs, NsPerSecond, m_Freq);
+    DWord elapsedCycles = cycles - m_BaseCycles;
+
+    /* After a long gap between reads the old scale is kept, the new one couldn't be computed without overflowing. */
+    if(time > m_BaseTime && elapsedCycles <= 2 * m_CalibrationCycles) {
+        m_CycleScale = ((time - m_BaseTime) << 32) / elapsedCycles;
+    }
+
+    m_BaseCycles = cycles;
+    m_BaseTime = time;
+}
+
 } // namespace detail
 } // namespace cpu
-} // namespace riscv
\ No newline at end of file
+} // namespace riscv
@@ -175,16 +175,12 @@ Result MemoryManager::ReadImpl(auto readFunc, T* pOut, Address addr, PrivilageLe
     diag::AssertNotNull(pOut);
     diag::AssertNotNull(readFunc);
 
-    /* Translate address if in non-machine mode and translation is enabled. */
-    if(level != PrivilageLevel::Machine && m_Mode != AddrTransMode::Bare) {
-        res = this->TranslateForRead(&addr, addr, level);
-        if(res.IsFailure()) {
-            return res;
-        }
+    /* Translate address. */
+    res = this->TranslateLoadAddress(&addr, addr, level);
+    if(res.IsFailure()) {
+        return res;
     }
 
-    /* TODO: PMP: Perform PMP check. */
-
     /* Perform an unmapped read. */
     return (*m_pMemCtlr.*readFunc)(pOut, addr);
 }
@@ -196,16 +192,12 @@ Result MemoryManager::WriteImpl(auto writeFunc, T in, Address addr, PrivilageLev
     /* Assert that write func isn't null. */
     diag::AssertNotNull(writeFunc);
 
-    /* Translate address if in non-machine mode and translation is enabled. */
-    if(level != PrivilageLevel::Machine && m_Mode != AddrTransMode::Bare) {
-        res = this->TranslateForWrite(&addr, addr, level);
-        if(res.IsFailure()) {
-            return res;
-        }
+    /* Translate address. */
+    res = this->TranslateStoreAddress(&addr, addr, level);
+    if(res.IsFailure()) {
+        return res;
     }
 
-    /* TODO: PMP: Perform PMP check. */
-
     /* Perform unmapped write. */
     return (*m_pMemCtlr.*writeFunc)(in, addr);
 }
@@ -417,7 +409,35 @@ Result MemoryManager::InstFetch(Word* pOut, Address addr, PrivilageLevel level)
     /* TODO: PMP: Perform PMP Check. */
 
     /* Perform unmapped fetch. */
-    return m_pMemCtlr->ReadWord(pOut, addr);
+    return m_pMemCtlr->FetchWord(pOut, addr);
+}
+
+Result MemoryManager::TranslateLoadAddress(Address* pOut, Address addr, PrivilageLevel level) {
+    diag::AssertNotNull(pOut);
+
+    /* Translate address if in non-machine mode and translation is enabled. */
+    if(level != PrivilageLevel::Machine && m_Mode != AddrTransMode::Bare) {
+        return this->TranslateForRead(pOut, addr, level);
+    }
+
+    /* TODO: PMP: Perform PMP check. */
+
+    *pOut = addr;
+    return ResultSuccess();
+}
+
+Result MemoryManager::TranslateStoreAddress(Address* pOut, Address addr, PrivilageLevel level) {
+    diag::AssertNotNull(pOut);
+
+    /* Translate address if in non-machine mode and translation is enabled. */
+    if(level != PrivilageLevel::Machine && m_Mode != AddrTransMode::Bare) {
+        return this->TranslateForWrite(pOut, addr, level);
+    }
+
+    /* TODO: PMP: Perform PMP check. */
+
+    *pOut = addr;
+    return ResultSuccess();
 }
 
 template<typename T>
@@ -1,6 +1,7 @@
 #include <RiscvEmu/cpu/detail/cpu_MemoryMonitor.h>
 #include <RiscvEmu/diag.h>
-#include <span>
+#include <RiscvEmu/util/util_SpinWait.h>
+#include <bit>
 
 namespace riscv {
 namespace cpu {
@@ -8,7 +9,17 @@ namespace detail {
 
 namespace {
 
-constexpr Address GetAlignedAddress(Address addr) noexcept { return addr % sizeof(NativeWord); }
+constexpr Address GetAlignedAddress(Address addr) noexcept { return addr & ~static_cast<Address>(sizeof(NativeWord) - 1); }
+
+/* Fibonacci hashing spreads strided granules across the buckets. */
+template<std::size_t BucketCount>
+constexpr std::size_t HashGranule(Address addr) noexcept {
+    static_assert(std::has_single_bit(BucketCount));
+
+    constexpr auto BucketBits = std::countr_zero(BucketCount);
+    auto granule = static_cast<DWord>(addr / sizeof(NativeWord));
+    return static_cast<std::size_t>((granule * 0x9E3779B97F4A7C15ull) >> (64 - BucketBits));
+}
 
 } // namespace
 
@@ -73,30 +84,63 @@ bool MemoryMonitor::Context::IsAddressReserved(Address addr) const noexcept {
     return m_pParent->IsAddressReserved(addr);
 }
 
-bool MemoryMonitor::Context::TryRevokeAnyReservation(Address addr) noexcept {
+bool MemoryMonitor::Context::TryConsumeReservation(Address addr) noexcept {
     diag::AssertNotNull(m_pParent);
-    return m_pParent->TryRevokeReservation(addr);
+    return m_pParent->TryConsumeReservation(m_HartId, addr);
+}
+
+bool MemoryMonitor::Context::TryRevokeAnyReservation(Address addr, std::size_t len) noexcept {
+    diag::AssertNotNull(m_pParent);
+
+    bool revoked = m_pParent->TryRevokeReservation(addr);
+
+    /* Misaligned accesses may also touch the following granule. */
+    Address last = addr + len - 1;
+    if(GetAlignedAddress(last) != GetAlignedAddress(addr)) {
+        revoked |= m_pParent->TryRevokeReservation(last);
+    }
+
+    return revoked;
+}
+
+void MemoryMonitor::Context::WaitForReservationLoss(std::chrono::nanoseconds timeout) {
+    diag::AssertNotNull(m_pParent);
+    m_pParent->WaitForReservationLoss(m_HartId, timeout);
+}
+
+DWord MemoryMonitor::Context::WatchStores(Address addr) noexcept {
+    diag::AssertNotNull(m_pParent);
+    return m_pParent->WatchStores(addr);
+}
+
+void MemoryMonitor::Context::WaitForStore(Address addr, DWord tag, std::chrono::nanoseconds timeout) {
+    diag::AssertNotNull(m_pParent);
+    m_pParent->WaitForBucketChange(m_HartId, m_pParent->GetReservationBucketIndex(GetAlignedAddress(addr)), tag, timeout);
+}
+
+void MemoryMonitor::Context::InterruptReservationWait() {
+    diag::AssertNotNull(m_pParent);
+    m_pParent->InterruptReservationWait(m_HartId);
 }
 
 void MemoryMonitor::Initialize(Word hartCount) {
     m_HartCount = hartCount;
 
-    /* Clear counters. */
-    m_ReserveCount      = 0;
-    m_SharedAccessCount = 0;
-    m_ExclAccessCount   = 0;
-
     /* Setup entries. */
-    m_ReservEntries = std::make_unique<ReservationEntry[]>(hartCount);
-    m_SharedEntries = std::make_unique<SharedAccessEntry[]>(hartCount);
-    m_ExclEntries   = std::make_unique<ExclAccessEntry[]>(hartCount);
+    m_HartEntries   = std::make_unique<HartEntry[]>(hartCount);
+    m_ReservBuckets = std::make_unique<std::atomic<DWord>[]>(ReservationBucketCount);
+    m_WaitEntries   = std::make_unique<WaitEntry[]>(hartCount);
+    m_ReservWaiterCounts = std::make_unique<std::atomic<Word>[]>(ReservationBucketCount);
+    m_AccessStripes = std::make_unique<AccessStripe[]>(AccessStripeCount);
 }
 
 void MemoryMonitor::Finalize() {
     m_HartCount = 0;
-    m_ReservEntries.reset();
-    m_SharedEntries.reset();
-    m_ExclEntries.reset();
+    m_HartEntries.reset();
+    m_ReservBuckets.reset();
+    m_WaitEntries.reset();
+    m_ReservWaiterCounts.reset();
+    m_AccessStripes.reset();
 }
 
 MemoryMonitor::Context MemoryMonitor::GetContext(Word hartId) noexcept { return Context(this, hartId); }
@@ -107,263 +151,224 @@ void MemoryMonitor::AquireReservation(Word hartId, Address addr) noexcept {
     /* Align reservation address. */
     addr = GetAlignedAddress(addr);
 
-    /* Revoke any current reservations of this address. */
-    this->TryRevokeReservation(addr);
-
-    /* Mark entry as active if required. */
-    auto& entry = m_ReservEntries[hartId];
-    if(!entry.active) {
-        m_ReserveCount++;
-        entry.active = true;
-    }
+    /* Mark the bucket reserved, remembering the version we reserved. */
+    DWord tag = this->GetReservationBucket(addr).fetch_or(ReservedFlag, std::memory_order_acq_rel) | ReservedFlag;
 
     /* Reserve address. */
+    auto& entry = m_HartEntries[hartId].reserv;
+    entry.active = true;
     entry.addr = addr;
+    entry.tag = tag;
 }
 
 void MemoryMonitor::ReleaseReservation(Word hartId) noexcept {
     diag::Assert(hartId < m_HartCount);
 
-    auto& entry = m_ReservEntries[hartId];
-    if(entry.active) {
-        entry.active = false;
-        m_ReserveCount--;
-    }
-}
-
-void MemoryMonitor::AquireSharedAccessImpl(Word hartIndex, Address addr) {
-    /* Assert this hart doesn't already have an active shared access reservation. */
-    auto& entry = m_SharedEntries[hartIndex];
-    diag::Assert(!entry.active, "Hart already has active shared access reservation!\n");
-
-    /* Add shared access reservation. */
-    entry.active = true;
-    entry.addr = addr;
-    m_SharedAccessCount++;
+    /* The bucket stays marked reserved, the next store to it just bumps its version. */
+    m_HartEntries[hartId].reserv.active = false;
 }
 
 void MemoryMonitor::AquireSharedAccess(Word hartIndex, Address addr) {
     diag::Assert(hartIndex < m_HartCount);
 
-    std::unique_lock exclLock(m_ExclAccessMutex);
-
-    /* If we have any active exclusive access reservations, check if addr is in one of them. */
-    if(m_ExclAccessCount) {
-        bool foundExcl = true;
-        while(foundExcl) {
-            foundExcl = false;
-            for(auto& entry : std::span(m_ExclEntries.get(), m_HartCount)) {
-                if(entry.active && entry.addr == addr) {
-                    /* Release exclusive access lock. */
-                    exclLock.unlock();
-
-                    /* Indicate that an exclusive access at this address was found and we need to re-iterate. */
-                    foundExcl = true;
-
-                    /* Wait for exclusive access to be released. */
-                    std::unique_lock entryLock(entry.mutex);
-                    while(entry.active) {
-                        entry.cv.wait(entryLock);
-                    }
-                    entryLock.unlock();
-
-                    /* Reaquire exclusive access lock. */
-                    exclLock.lock();
-
-                    break;
-                }
+    /* Assert this hart doesn't already have an active shared access reservation. */
+    auto& entry = m_HartEntries[hartIndex].shared;
+    diag::Assert(!entry.active, "Hart already has active shared access reservation!\n");
+
+    /* Add ourselves as a reader once no writer holds the stripe. */
+    auto stripe = this->GetAccessStripeIndex(addr);
+    auto& state = m_AccessStripes[stripe].state;
+    Word cur = state.load(std::memory_order_relaxed);
+    for(int spins = 0;;) {
+        if(!(cur & AccessWriterFlag)) {
+            if(state.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
             }
+            continue;
         }
+        this->WaitForAccessStripe(state, &cur, &spins);
     }
 
-    /* Aquire shared access mutex. */
-    std::scoped_lock sharedLock(m_SharedAccessMutex);
-
-    /* Release exclusive access mutex. */
-    exclLock.unlock();
-
-    /* Aquire shared access reservation. */
-    this->AquireSharedAccessImpl(hartIndex, addr);
+    entry.active = true;
+    entry.stripe = stripe;
 }
 
 bool MemoryMonitor::TryAquireSharedAccess(Word hartIndex, Address addr) {
     diag::Assert(hartIndex < m_HartCount);
 
-    std::unique_lock exclLock(m_ExclAccessMutex);
+    /* Assert this hart doesn't already have an active shared access reservation. */
+    auto& entry = m_HartEntries[hartIndex].shared;
+    diag::Assert(!entry.active, "Hart already has active shared access reservation!\n");
 
-    /* If we have any active exclusive access reservations, check if addr is in one of them. */
-    if(m_ExclAccessCount) {
-        for(auto& entry : std::span(m_ExclEntries.get(), m_HartCount)) {
-            if(entry.active && entry.addr == addr) {
-                return false;
-            }
+    /* Add ourselves as a reader unless a writer holds the stripe, CAS failures from other readers are retried. */
+    auto stripe = this->GetAccessStripeIndex(addr);
+    auto& state = m_AccessStripes[stripe].state;
+    Word cur = state.load(std::memory_order_relaxed);
+    do {
+        if(cur & AccessWriterFlag) {
+            return false;
         }
-    }
-
-    /* Aquire shared access mutex. */
-    std::scoped_lock sharedLock(m_SharedAccessMutex);
-
-    /* Release exclusive access mutex. */
-    exclLock.unlock();
-
-    /* Aquire shared access reservation. */
-    this->AquireSharedAccessImpl(hartIndex, addr);
+    } while(!state.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire, std::memory_order_relaxed));
 
+    entry.active = true;
+    entry.stripe = stripe;
     return true;
 }
 
 void MemoryMonitor::ReleaseSharedAccess(Word hartIndex) {
     diag::Assert(hartIndex < m_HartCount);
-    auto& entry = m_SharedEntries[hartIndex];
-
-    /* Release shared access. */
-    {
-        std::scoped_lock lock(entry.mutex);
-        entry.active = false;
-    }
-
-    /* Decrement shared access counter. */
-    {
-        std::scoped_lock lock(m_SharedAccessMutex);
-        m_SharedAccessCount--;
+    auto& entry = m_HartEntries[hartIndex].shared;
+    diag::Assert(entry.active);
+    entry.active = false;
+
+    /* Only waiting writers can be blocked by readers, so only the last reader needs to wake them. */
+    auto& state = m_AccessStripes[entry.stripe].state;
+    Word prev = state.fetch_sub(1, std::memory_order_release);
+    if(prev == (AccessWaitersFlag | 1)) {
+        state.fetch_and(~AccessWaitersFlag, std::memory_order_relaxed);
+        state.notify_all();
     }
-
-    /* Signal anyone waiting on us. */
-    entry.cv.notify_one();
-}
-
-void MemoryMonitor::AquireExclusiveAccessImpl(Word hartIndex, Address addr) {
-    /* Assert this hart doesn't already have an active exclusive access reservation. */
-    auto& entry = m_ExclEntries[hartIndex];
-    diag::Assert(!entry.active, "Hart already has active exclusive access reservation!\n");
-
-    /* Add exclusive access reservation. */
-    entry.active = true;
-    entry.addr = addr;
-    m_ExclAccessCount++;
 }
 
 void MemoryMonitor::AquireExclusiveAccess(Word hartIndex, Address addr) {
     diag::Assert(hartIndex < m_HartCount);
 
-    /* Aquire both locks. */
-    std::unique_lock exclLock(m_ExclAccessMutex);
-    std::unique_lock sharedLock(m_SharedAccessMutex);
-
-    /* If we have any shared access reservations, check if addr is in one of them. */
-    while(m_SharedAccessCount) {
-        bool foundShared = true;
-        while(foundShared) {
-            foundShared = false;
-            for(auto& entry : std::span(m_SharedEntries.get(), m_HartCount)) {
-                if(entry.active && entry.addr == addr) {
-                    /* Release both locks. */
-                    exclLock.unlock();
-                    sharedLock.unlock();
-
-                    /* Indicate that a shared access reservation was found at this address and we'll need to reiterate. */
-                    foundShared = true;
-
-                    /* Wait for shared access reservation to be released. */
-                    std::unique_lock entryLock(entry.mutex);
-                    while(entry.active) {
-                        entry.cv.wait(entryLock);
-                    }
-                    entryLock.unlock();
-
-                    /* Reaquire locks. */
-                    exclLock.lock();
-                    sharedLock.lock();
-
-                    break;
-                }
+    /* Assert this hart doesn't already have an active exclusive access reservation. */
+    auto& entry = m_HartEntries[hartIndex].excl;
+    diag::Assert(!entry.active, "Hart already has active exclusive access reservation!\n");
+
+    /* Take the stripe once it has neither readers nor a writer. */
+    auto stripe = this->GetAccessStripeIndex(addr);
+    auto& state = m_AccessStripes[stripe].state;
+    Word cur = state.load(std::memory_order_relaxed);
+    for(int spins = 0;;) {
+        if(!(cur & (AccessReaderMask | AccessWriterFlag))) {
+            if(state.compare_exchange_weak(cur, cur | AccessWriterFlag, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
             }
+            continue;
         }
+        this->WaitForAccessStripe(state, &cur, &spins);
     }
 
-    /* Add exclusive access reservation. */
-    this->AquireExclusiveAccessImpl(hartIndex, addr);
+    entry.active = true;
+    entry.stripe = stripe;
 }
 
 bool MemoryMonitor::TryAquireExclusiveAccess(Word hartIndex, Address addr) {
     diag::Assert(hartIndex < m_HartCount);
 
-    /* Aquire both locks. */
-    std::unique_lock exclLock(m_ExclAccessMutex);
-    std::unique_lock sharedLock(m_SharedAccessMutex);
+    /* Assert this hart doesn't already have an active exclusive access reservation. */
+    auto& entry = m_HartEntries[hartIndex].excl;
+    diag::Assert(!entry.active, "Hart already has active exclusive access reservation!\n");
 
-    /* If we have any shared access reservations, check if addr is in one of them. */
-    while(m_SharedAccessCount) {
-        for(auto& entry : std::span(m_SharedEntries.get(), m_HartCount)) {
-            if(entry.active && entry.addr == addr) {
-                return false;
-            }
+    /* Take the stripe only if it's free. */
+    auto stripe = this->GetAccessStripeIndex(addr);
+    auto& state = m_AccessStripes[stripe].state;
+    Word cur = state.load(std::memory_order_relaxed);
+    do {
+        if(cur & (AccessReaderMask | AccessWriterFlag)) {
+            return false;
         }
-    }
-
-    /* Add exclusive access reservation. */
-    this->AquireExclusiveAccessImpl(hartIndex, addr);
+    } while(!state.compare_exchange_weak(cur, cur | AccessWriterFlag, std::memory_order_acquire, std::memory_order_relaxed));
 
+    entry.active = true;
+    entry.stripe = stripe;
     return true;
 }
 
 void MemoryMonitor::ReleaseExclusiveAccess(Word hartIndex) {
     diag::Assert(hartIndex < m_HartCount);
-    auto& entry = m_ExclEntries[hartIndex];
+    auto& entry = m_HartEntries[hartIndex].excl;
+    diag::Assert(entry.active);
+    entry.active = false;
+
+    /* Drop the stripe and wake everyone who went to sleep on it. */
+    auto& state = m_AccessStripes[entry.stripe].state;
+    Word prev = state.fetch_and(~(AccessWriterFlag | AccessWaitersFlag), std::memory_order_release);
+    if(prev & AccessWaitersFlag) {
+        state.notify_all();
+    }
+}
 
-    /* Release exclusive access reservation. */
-    {
-        std::scoped_lock lock(entry.mutex);
-        entry.active = false;
+void MemoryMonitor::WaitForAccessStripe(std::atomic<Word>& state, Word* pCur, int* pSpins) noexcept {
+    /* Short critical sections are usually over before a sleep would pay off. */
+    if(*pSpins < AccessSpinCount) {
+        (*pSpins)++;
+        util::SpinPause();
+        *pCur = state.load(std::memory_order_relaxed);
+        return;
     }
 
-    /* Decrement exclusive access reservation count. */
-    {
-        std::scoped_lock lock(m_ExclAccessMutex);
-        m_ExclAccessCount--;
+    /* Ask the holder to wake us, if the state changed in the meantime the caller rechecks it. */
+    Word cur = *pCur;
+    if(!(cur & AccessWaitersFlag) && !state.compare_exchange_weak(*pCur, cur | AccessWaitersFlag, std::memory_order_relaxed)) {
+        return;
     }
 
-    /* Signal anyone waiting on us. */
-    entry.cv.notify_one();
+    /* Sleep until the state changes. */
+    state.wait(cur | AccessWaitersFlag, std::memory_order_relaxed);
+    *pCur = state.load(std::memory_order_relaxed);
 }
 
 bool MemoryMonitor::HartHasReservation(Word hartId) const noexcept {
     diag::Assert(hartId < m_HartCount);
-    return m_ReservEntries[hartId].active;
+
+    /* A reservation is only valid while its bucket hasn't moved on to a new version. */
+    const auto& entry = m_HartEntries[hartId].reserv;
+    return entry.active && this->GetReservationBucket(entry.addr).load(std::memory_order_acquire) == entry.tag;
 }
 Address MemoryMonitor::HartGetReservedAddress(Word hartId) const noexcept {
     diag::Assert(hartId < m_HartCount);
-    return m_ReservEntries[hartId].addr;
+    return m_HartEntries[hartId].reserv.addr;
 }
 
 bool MemoryMonitor::IsAddressReserved(Address addr) const noexcept {
-    /* Align address. */
-    addr = GetAlignedAddress(addr);
+    /* This may report granules sharing a bucket with a reserved one. */
+    return this->GetReservationBucket(GetAlignedAddress(addr)).load(std::memory_order_acquire) & ReservedFlag;
+}
 
-    /* Search for an active entry using this address. */
-    for(const auto& entry : std::span(m_ReservEntries.get(), m_HartCount)) {
-        if(entry.active && entry.addr == addr) {
-            return true;
-        }
+bool MemoryMonitor::TryConsumeReservation(Word hartId, Address addr) noexcept {
+    diag::Assert(hartId < m_HartCount);
+
+    /* Make sure we hold a reservation for this granule. */
+    auto& entry = m_HartEntries[hartId].reserv;
+    if(!entry.active || entry.addr != GetAlignedAddress(addr)) {
+        return false;
     }
 
-    return false;
+    /* SC always ends the reservation, successful or not. */
+    entry.active = false;
+
+    /* Swap in the next version, this fails if anyone wrote to the bucket since we reserved it. */
+    auto index = this->GetReservationBucketIndex(entry.addr);
+    DWord expected = entry.tag;
+    if(!m_ReservBuckets[index].compare_exchange_strong(expected, (entry.tag & ~ReservedFlag) + VersionIncrement,
+        std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        return false;
+    }
+
+    this->NotifyReservationWaiters(index);
+    return true;
 }
 
 bool MemoryMonitor::TryRevokeReservation(Address addr) noexcept {
-    /* Align address. */
-    addr = GetAlignedAddress(addr);
+    return this->TryRevokeBucket(this->GetReservationBucketIndex(GetAlignedAddress(addr)));
+}
+
+bool MemoryMonitor::TryRevokeBucket(std::size_t index) noexcept {
+    auto& bucket = m_ReservBuckets[index];
 
-    /* Simply quit if we have no active entries. */
-    if(!m_ReserveCount) {
+    /* Fast path, nobody has a reservation here. */
+    DWord cur = bucket.load(std::memory_order_acquire);
+    if(!(cur & ReservedFlag)) {
         return false;
     }
 
-    /* Search for any active entry using this address and revoke it. */
-    for(auto& entry : std::span(m_ReservEntries.get(), m_HartCount)) {
-        if(entry.active && entry.addr == addr) {
-            entry.active = false;
-            m_ReserveCount--;
+    /* Move to the next version, invalidating every reservation of the bucket. */
+    while(cur & ReservedFlag) {
+        if(bucket.compare_exchange_weak(cur, (cur & ~ReservedFlag) + VersionIncrement, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            this->NotifyReservationWaiters(index);
             return true;
         }
     }
@@ -371,6 +376,93 @@ bool MemoryMonitor::TryRevokeReservation(Address addr) noexcept {
     return false;
 }
 
+void MemoryMonitor::WaitForReservationLoss(Word hartId, std::chrono::nanoseconds timeout) {
+    diag::Assert(hartId < m_HartCount);
+
+    /* There's nothing to wait for without a reservation, but a pending interrupt is still consumed. */
+    const auto& entry = m_HartEntries[hartId].reserv;
+    auto index = entry.active ? this->GetReservationBucketIndex(entry.addr) : NoWaitBucket;
+    this->WaitForBucketChange(hartId, index, entry.tag, timeout);
+}
+
+DWord MemoryMonitor::WatchStores(Address addr) noexcept {
+    /* Stores only bump the version of reserved buckets. */
+    return this->GetReservationBucket(GetAlignedAddress(addr)).fetch_or(ReservedFlag, std::memory_order_acq_rel) | ReservedFlag;
+}
+
+void MemoryMonitor::WaitForBucketChange(Word hartId, std::size_t index, DWord tag, std::chrono::nanoseconds timeout) {
+    diag::Assert(hartId < m_HartCount);
+
+    /* Announce which bucket we wait on before checking it, so revokers can't miss us. */
+    auto& wait = m_WaitEntries[hartId];
+    if(index != NoWaitBucket) {
+        wait.bucket.store(index, std::memory_order_seq_cst);
+        m_ReservWaiterCounts[index].fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    {
+        std::unique_lock lk(wait.mutex);
+
+        /* An interrupt also ends a wait that hadn't started yet. */
+        if(!wait.interrupted && index != NoWaitBucket) {
+            auto& bucket = m_ReservBuckets[index];
+            auto isDone = [&] { return wait.interrupted || bucket.load(std::memory_order_seq_cst) != tag; };
+
+            if(timeout == NoTimeout) {
+                wait.cv.wait(lk, isDone);
+            }
+            else {
+                wait.cv.wait_for(lk, timeout, isDone);
+            }
+        }
+
+        wait.interrupted = false;
+    }
+
+    if(index != NoWaitBucket) {
+        m_ReservWaiterCounts[index].fetch_sub(1, std::memory_order_relaxed);
+        wait.bucket.store(NoWaitBucket, std::memory_order_relaxed);
+    }
+}
+
+void MemoryMonitor::InterruptReservationWait(Word hartId) {
+    diag::Assert(hartId < m_HartCount);
+
+    auto& wait = m_WaitEntries[hartId];
+    std::scoped_lock lk(wait.mutex);
+    wait.interrupted = true;
+    wait.cv.notify_one();
+}
+
+void MemoryMonitor::NotifyReservationWaiters(std::size_t index) {
+    /* Pairs with waiters counting themselves before checking the bucket. */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(m_ReservWaiterCounts[index].load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    /* Only wake the harts waiting on this bucket, taking their lock so the wake can't slip in before they sleep. */
+    for(Word i = 0; i < m_HartCount; i++) {
+        auto& wait = m_WaitEntries[i];
+        if(wait.bucket.load(std::memory_order_seq_cst) == index) {
+            std::scoped_lock lk(wait.mutex);
+            wait.cv.notify_one();
+        }
+    }
+}
+
+std::size_t MemoryMonitor::GetReservationBucketIndex(Address addr) const noexcept {
+    return HashGranule<ReservationBucketCount>(addr);
+}
+
+std::atomic<DWord>& MemoryMonitor::GetReservationBucket(Address addr) const noexcept {
+    return m_ReservBuckets[this->GetReservationBucketIndex(addr)];
+}
+
+std::size_t MemoryMonitor::GetAccessStripeIndex(Address addr) const noexcept {
+    return HashGranule<AccessStripeCount>(GetAlignedAddress(addr));
+}
+
 } // namespace detail
 } // namespace cpu
 } // namespace riscv
@@ -0,0 +1,69 @@
+#include <RiscvEmu/hw/hw_AsyncWorkerPool.h>
+#include <RiscvEmu/diag.h>
+
+namespace riscv {
+namespace hw {
+
+AsyncWorkerPool::~AsyncWorkerPool() {
+    if(this->IsRunning()) {
+        this->Stop();
+    }
+}
+
+void AsyncWorkerPool::Start(std::size_t workerCount) {
+    diag::Assert(workerCount > 0);
+    diag::Assert(!this->IsRunning());
+
+    m_StopRequested = false;
+
+    m_WorkerCount = workerCount;
+    m_pWorkers = std::make_unique<std::thread[]>(workerCount);
+    for(std::size_t i = 0; i < workerCount; i++) {
+        m_pWorkers[i] = std::thread(&AsyncWorkerPool::RunWorker, this);
+    }
+}
+
+void AsyncWorkerPool::Stop() {
+    diag::Assert(this->IsRunning());
+
+    {
+        std::scoped_lock lk(m_Mutex);
+        m_StopRequested = true;
+    }
+    m_Cv.notify_all();
+
+    /* Workers drain the queue before exiting, so every submitted job completes. */
+    for(std::size_t i = 0; i < m_WorkerCount; i++) {
+        m_pWorkers[i].join();
+    }
+    m_pWorkers.reset();
+}
+
+void AsyncWorkerPool::Submit(Job job) {
+    {
+        std::scoped_lock lk(m_Mutex);
+        m_Jobs.push_back(std::move(job));
+    }
+    m_Cv.notify_one();
+}
+
+void AsyncWorkerPool::RunWorker() {
+    while(true) {
+        Job job;
+        {
+            std::unique_lock lk(m_Mutex);
+            m_Cv.wait(lk, [this] { return m_StopRequested || !m_Jobs.empty(); });
+            if(m_Jobs.empty()) {
+                return;
+            }
+
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+} // namespace hw
+} // namespace riscv
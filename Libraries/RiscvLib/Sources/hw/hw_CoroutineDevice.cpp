@@ -0,0 +1,67 @@
+#include <RiscvEmu/hw/hw_CoroutineDevice.h>
+#include <algorithm>
+
+namespace riscv {
+namespace hw {
+
+void DeviceEvent::Signal() {
+    if(m_pWaiter != nullptr) {
+        std::exchange(m_pWaiter, nullptr)->Wake();
+    }
+    else {
+        m_Signaled = true;
+    }
+}
+
+void CoroutineDevice::DelayAwaiter::await_suspend(std::coroutine_handle<>) const noexcept {
+    m_pDev->m_WakeTick = m_pDev->GetTime() + std::max<DWord>(m_Ticks, 1);
+}
+
+bool CoroutineDevice::EventAwaiter::await_ready() const noexcept {
+    /* Consume a signal which arrived before the wait. */
+    return std::exchange(m_pEvent->m_Signaled, false);
+}
+
+void CoroutineDevice::EventAwaiter::await_suspend(std::coroutine_handle<>) const noexcept {
+    diag::Assert(m_pEvent->m_pWaiter == nullptr, "Event already has a waiter!\n");
+
+    m_pEvent->m_pWaiter = m_pDev;
+    m_pDev->m_WakeTick = NoDeadline;
+}
+
+CoroutineDevice::CoroutineDevice(DeviceScheduler* pScheduler) noexcept :
+    IDevice(static_cast<DWordS>(DeviceScheduler::TickFreq)),
+    m_pScheduler(pScheduler),
+    m_WakeTick(NoDeadline) {
+    diag::AssertNotNull(pScheduler);
+}
+
+Result CoroutineDevice::ProcessCycle() {
+    /* Start the model on the first cycle. */
+    if(!m_Task.IsValid()) {
+        m_Task = this->Run();
+    }
+
+    if(m_Task.IsDone()) {
+        return ResultSuccess();
+    }
+
+    /* Run until the next await, which sets the next deadline. */
+    m_WakeTick = NoDeadline;
+    m_Task.Resume();
+
+    return m_Task.IsDone() ? m_Task.GetResult() : ResultSuccess();
+}
+
+DWord CoroutineDevice::GetNextDeadline([[maybe_unused]] DWord now, [[maybe_unused]] DWord periodicTick) const {
+    return m_WakeTick;
+}
+
+void CoroutineDevice::Wake() {
+    /* Resume at the current tick. */
+    m_WakeTick = m_pScheduler->GetTime();
+    m_pScheduler->ScheduleDevice(this, m_WakeTick);
+}
+
+} // namespace hw
+} // namespace riscv
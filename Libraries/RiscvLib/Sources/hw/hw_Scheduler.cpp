@@ -1,66 +1,301 @@
 #include <RiscvEmu/hw/hw_Scheduler.h>
+#include <RiscvEmu/diag.h>
+#include <algorithm>
 
 namespace riscv {
 namespace hw {
 
 DeviceScheduler::DeviceScheduler() :
-    m_Queue(CompareImpl(this)),
     m_Timer(0) {}
 
+DeviceScheduler::~DeviceScheduler() {
+    /* Workers post to us, make sure none outlive us. */
+    if(m_AsyncPool.IsRunning()) {
+        m_AsyncPool.Stop();
+    }
+}
+
 DeviceScheduler::SchdResult DeviceScheduler::ProcessCycle() {
-    while(this->GetTopCycle() == m_Timer) {
-        auto pDev = this->GetTopDevice();
+    return this->Advance(1);
+}
 
-        /* Process the current device. */
-        Result res = pDev->ProcessCycle();
-        if(res.IsFailure()) {
-            return { res, pDev };
+DeviceScheduler::SchdResult DeviceScheduler::Advance(DWord tickCount) {
+    /* Saturate instead of wrapping, 2^64 ticks is far beyond any run. */
+    DWord end = tickCount > NoDeadline - m_Timer ? NoDeadline : m_Timer + tickCount;
+
+    while(true) {
+        /* Pick up work which completed since the last deadline. */
+        if(m_HasAsyncDone.load(std::memory_order_acquire)) {
+            this->CollectAsyncEvents();
         }
 
-        /* Remove the device from the scheduler. */
-        m_Queue.pop();
+        DWord deviceTick = m_Queue.IsEmpty() ? NoDeadline : this->GetTopCycle();
+        DWord eventTick = m_AsyncEvents.IsEmpty() ? NoDeadline : m_AsyncEvents.GetTop().tick;
+        if(std::min(deviceTick, eventTick) >= end) {
+            break;
+        }
 
-        /* Re-add to scheduler. */
-        res = this->AddDevice(pDev);
+        /* Completions go first, devices due at the same tick see their effects. */
+        SchdResult res = eventTick <= deviceTick ? this->ProcessAsyncEvent() : this->ProcessDevice();
         if(res.IsFailure()) {
-            return { res, pDev };
+            return res;
         }
     }
 
-    /* Increment timer. */
-    m_Timer++;
+    /* Idle time in between deadlines costs nothing. */
+    m_Timer = end;
+
+    return ResultSuccess();
+}
 
-    /* Reset timer if needed. */
-    if(m_Timer >= c_TimerFreq) {
-        m_Timer = 0;
+DeviceScheduler::SchdResult DeviceScheduler::AdvanceToNextDeadline(DWord maxTicks) {
+    DWord next = this->GetNextDeadline();
+    if(next == NoDeadline) {
+        return maxTicks == NoDeadline ? SchdResult() : this->Advance(maxTicks);
     }
 
-    return ResultSuccess();
+    /* Deadlines in the past are due immediately. */
+    DWord ticks = next < m_Timer ? 1 : next - m_Timer + 1;
+    return this->Advance(std::min(ticks, maxTicks));
+}
+
+DWord DeviceScheduler::GetNextDeadline() const {
+    DWord deviceTick = m_Queue.IsEmpty() ? NoDeadline : this->GetTopCycle();
+    DWord eventTick = m_AsyncEvents.IsEmpty() ? NoDeadline : m_AsyncEvents.GetTop().tick;
+    return std::min(deviceTick, eventTick);
 }
 
 Result DeviceScheduler::AddDevice(IDevice* pDev) {
+    diag::AssertNotNull(pDev);
+    diag::Assert(!m_Devices.contains(pDev), "Device was already added!\n");
+
     /* Calculate the first cycle we'll need to process this device. */
-    auto nextCycle = this->CalculateNextCycle(pDev->GetFreq());
+    auto nextCycle = this->CalculatePeriodicCycle(m_Timer, pDev->GetFreq());
 
     /* Add to scheduler. */
-    m_Queue.emplace(pDev, nextCycle);
+    m_Devices.emplace(pDev, DeviceEntry{ m_Queue.Push({ pDev, nextCycle }), false, NoDeadline });
 
     return ResultSuccess();
 }
 
 Result DeviceScheduler::RemoveDevice(IDevice* pDev) {
+    auto iter = m_Devices.find(pDev);
+    if(iter == m_Devices.end()) {
+        return ResultSuccess();
+    }
+
     /* Remove device. */
-    m_Queue.remove({pDev});
+    if(iter->second.handle != DeviceQueue::InvalidHandle) {
+        m_Queue.Remove(iter->second.handle);
+    }
+    m_Devices.erase(iter);
+
+    /* Work may still be using the device, wait for it and drop the device's completions. */
+    this->WaitForAsync();
+
+    std::vector<AsyncEvent> kept;
+    while(!m_AsyncEvents.IsEmpty()) {
+        if(m_AsyncEvents.GetTop().pDev != pDev) {
+            kept.push_back(m_AsyncEvents.GetTop());
+        }
+        m_AsyncEvents.Pop();
+    }
+    for(auto& event : kept) {
+        m_AsyncEvents.Push(std::move(event));
+    }
 
     return ResultSuccess();
 }
 
-IDevice* DeviceScheduler::GetTopDevice() const { return m_Queue.top().GetDevice(); }
+Result DeviceScheduler::ScheduleDevice(IDevice* pDev, DWord tick) {
+    diag::AssertNotNull(pDev);
 
-DWordS DeviceScheduler::GetTopCycle() const { return m_Queue.top().GetNextCycle(); }
+    auto iter = m_Devices.find(pDev);
+    diag::Assert(iter != m_Devices.end(), "Device was never added!\n");
 
-DWordS DeviceScheduler::CalculateNextCycle(DWordS freq) const noexcept { return m_Timer + (c_TimerFreq / freq); }
+    /* Devices running an async cycle are requeued once it completes. */
+    auto& entry = iter->second;
+    if(entry.isBusy) {
+        entry.requestedTick = std::min(entry.requestedTick, tick);
+        return ResultSuccess();
+    }
 
+    /* The device isn't queued if it reported NoDeadline. */
+    auto& handle = entry.handle;
+    if(handle != DeviceQueue::InvalidHandle) {
+        m_Queue.Update(handle, { pDev, tick });
+    }
+    else {
+        handle = m_Queue.Push({ pDev, tick });
+    }
+
+    return ResultSuccess();
+}
+
+void DeviceScheduler::SetAsyncWorkerCount(std::size_t workerCount) {
+    /* Stopping the pool completes the work already started. */
+    if(m_AsyncPool.IsRunning()) {
+        m_AsyncPool.Stop();
+    }
+
+    if(workerCount > 0) {
+        m_AsyncPool.Start(workerCount);
+    }
+}
+
+Result DeviceScheduler::RunAsync(IDevice* pDev, AsyncWork work, AsyncCompletion completion, DWord latency) {
+    diag::AssertNotNull(pDev);
+
+    /* Completions fire at the virtual time the work takes, unless the host is slower. */
+    AsyncEvent event{
+        .tick = latency > NoDeadline - m_Timer ? NoDeadline : m_Timer + latency,
+        .seq = m_AsyncSeq++,
+        .pDev = pDev,
+        .result = ResultSuccess(),
+        .completion = std::move(completion)
+    };
+
+    {
+        std::scoped_lock lk(m_AsyncMutex);
+        m_AsyncInFlight++;
+    }
+
+    /* Without workers the work runs right away, which keeps runs reproducible. */
+    if(!m_AsyncPool.IsRunning()) {
+        event.result = work();
+        this->PostAsyncEvent(std::move(event));
+        return ResultSuccess();
+    }
+
+    m_AsyncPool.Submit([this, work = std::move(work), event = std::move(event)]() mutable {
+        event.result = work();
+        this->PostAsyncEvent(std::move(event));
+    });
+
+    return ResultSuccess();
+}
+
+void DeviceScheduler::WaitForAsync() {
+    {
+        std::unique_lock lk(m_AsyncMutex);
+        m_AsyncCv.wait(lk, [this] { return m_AsyncInFlight == 0; });
+    }
+
+    this->CollectAsyncEvents();
+}
+
+DeviceScheduler::SchdResult DeviceScheduler::ProcessDevice() {
+    auto pDev = this->GetTopDevice();
+
+    /* Devices see the time they're due at, late deadlines from ScheduleDevice run now. */
+    m_Timer = std::max(m_Timer, this->GetTopCycle());
+
+    /* Async devices leave the queue until their cycle completes. */
+    if(pDev->GetExecPolicy() == IDevice::ExecPolicy::Asynchronous) {
+        this->StartAsyncCycle(pDev);
+        return ResultSuccess();
+    }
+
+    /* Process the current device. */
+    Result res = pDev->ProcessCycle();
+    if(res.IsFailure()) {
+        return { res, pDev };
+    }
+
+    /* Move the device to its next deadline in place, or drop it from the queue if it has nothing to do. */
+    auto handle = m_Queue.GetTopHandle();
+    DWord next = pDev->GetNextDeadline(m_Timer, this->CalculatePeriodicCycle(m_Timer, pDev->GetFreq()));
+    if(next != NoDeadline) {
+        m_Queue.Update(handle, { pDev, std::max(next, m_Timer + 1) });
+    }
+    else {
+        m_Queue.Remove(handle);
+        m_Devices[pDev].handle = DeviceQueue::InvalidHandle;
+    }
+
+    return ResultSuccess();
+}
+
+DeviceScheduler::SchdResult DeviceScheduler::ProcessAsyncEvent() {
+    /* Take the event out first, the completion may start more work. */
+    AsyncEvent event = m_AsyncEvents.GetTop();
+    m_AsyncEvents.Pop();
+
+    m_Timer = std::max(m_Timer, event.tick);
+
+    Result res = event.completion(event.result);
+    if(res.IsFailure()) {
+        return { res, event.pDev };
+    }
+
+    return ResultSuccess();
+}
+
+void DeviceScheduler::StartAsyncCycle(IDevice* pDev) {
+    auto& entry = m_Devices[pDev];
+    m_Queue.Remove(entry.handle);
+    entry.handle = DeviceQueue::InvalidHandle;
+    entry.isBusy = true;
+    entry.requestedTick = NoDeadline;
+
+    DWord due = m_Timer;
+    this->RunAsync(pDev, [pDev] { return pDev->ProcessCycle(); }, [this, pDev, due](Result res) {
+        return this->CompleteAsyncCycle(pDev, due, res);
+    });
+}
+
+Result DeviceScheduler::CompleteAsyncCycle(IDevice* pDev, DWord due, Result res) {
+    auto& entry = m_Devices[pDev];
+    entry.isBusy = false;
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* The next deadline counts from when the cycle was due, ScheduleDevice calls made meanwhile may move it earlier. */
+    DWord next = pDev->GetNextDeadline(due, this->CalculatePeriodicCycle(due, pDev->GetFreq()));
+    next = std::min(next, entry.requestedTick);
+    if(next != NoDeadline) {
+        entry.handle = m_Queue.Push({ pDev, std::max(next, m_Timer + 1) });
+    }
+
+    return ResultSuccess();
+}
+
+void DeviceScheduler::PostAsyncEvent(AsyncEvent&& event) {
+    {
+        std::scoped_lock lk(m_AsyncMutex);
+        m_AsyncDone.push_back(std::move(event));
+        m_HasAsyncDone.store(true, std::memory_order_release);
+        m_AsyncInFlight--;
+    }
+    m_AsyncCv.notify_all();
+}
+
+void DeviceScheduler::CollectAsyncEvents() {
+    std::vector<AsyncEvent> done;
+    {
+        std::scoped_lock lk(m_AsyncMutex);
+        done.swap(m_AsyncDone);
+        m_HasAsyncDone.store(false, std::memory_order_relaxed);
+    }
+
+    /* Work noticed after its tick completes now. */
+    for(auto& event : done) {
+        event.tick = std::max(event.tick, m_Timer);
+        m_AsyncEvents.Push(std::move(event));
+    }
+}
+
+IDevice* DeviceScheduler::GetTopDevice() const { return m_Queue.GetTop().GetDevice(); }
+
+DWord DeviceScheduler::GetTopCycle() const { return m_Queue.GetTop().GetNextCycle(); }
+
+DWord DeviceScheduler::CalculatePeriodicCycle(DWord from, DWordS freq) const noexcept {
+    diag::Assert(freq > 0);
+
+    /* Devices faster than the timer run every tick. */
+    return from + std::max<DWord>(TickFreq / static_cast<DWord>(freq), 1);
+}
 
 } // namespace hw
 } // namespace riscv
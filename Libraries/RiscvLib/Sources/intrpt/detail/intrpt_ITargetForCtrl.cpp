@@ -17,6 +17,18 @@ ITargetForCtrl::~ITargetForCtrl() = default;
 void ITargetForCtrl::Initialize(std::shared_ptr<ITarget>&& pTarget) {
     diag::Assert(!this->IsInitialized(), "Should not be initialized");
     m_pTarget = pTarget;
+
+    /* Let the target reach us for its queries. */
+    m_pTarget->InitializeForController(this);
+}
+
+void ITargetForCtrl::Finalize() { m_pTarget.reset(); }
+
+bool ITargetForCtrl::IsInitialized() const noexcept { return m_pTarget != nullptr; }
+
+Result ITargetForCtrl::NotifyAvailableIRQ() {
+    diag::Assert(this->IsInitialized());
+    return m_pTarget->NotifyAvailableIRQImpl();
 }
 
 } // namespace detail
@@ -0,0 +1,288 @@
+#include <RiscvEmu/intrpt/intrpt_CLINT.h>
+#include <RiscvEmu/intrpt/intrpt_Result.h>
+#include <RiscvEmu/mem/mem_Result.h>
+#include <RiscvEmu/diag.h>
+#include <RiscvEmu/util/util_Frequency.h>
+#include <algorithm>
+
+namespace riscv {
+namespace intrpt {
+
+namespace {
+
+constexpr NativeWord AddrSpaceSize = 0x10000;
+
+constexpr Address SoftwarePendingStart = 0x0;
+constexpr Address TimeCompareStart = 0x4000;
+constexpr Address TimeStart = 0xBFF8;
+
+constexpr DWord TickFreq = hw::DeviceScheduler::TickFreq;
+constexpr DWord NoDeadline = hw::DeviceScheduler::NoDeadline;
+
+/* Replace the 32 bit half of a register an access of size bytes at addr covers. */
+constexpr DWord MergeRegister(DWord reg, DWord val, Address addr, std::size_t size) noexcept {
+    if(size == sizeof(DWord)) {
+        return val;
+    }
+
+    unsigned shift = (addr % sizeof(DWord)) ? 32 : 0;
+    return (reg & ~(0xFFFFFFFFull << shift)) | ((val & 0xFFFFFFFF) << shift);
+}
+
+constexpr DWord ExtractRegister(DWord reg, Address addr, std::size_t size) noexcept {
+    if(size == sizeof(DWord)) {
+        return reg;
+    }
+
+    return (addr % sizeof(DWord)) ? reg >> 32 : reg & 0xFFFFFFFF;
+}
+
+} // namespace
+
+CLINT::TimerDevice::TimerDevice(CLINT* pParent) noexcept :
+    IDevice(static_cast<DWordS>(TickFreq)),
+    m_pParent(pParent) {}
+
+Result CLINT::TimerDevice::ProcessCycle() {
+    m_pParent->ProcessTimers();
+    return ResultSuccess();
+}
+
+DWord CLINT::TimerDevice::GetNextDeadline([[maybe_unused]] DWord now, [[maybe_unused]] DWord periodicTick) const {
+    return m_pParent->m_NextDeadline;
+}
+
+CLINT::CLINT() noexcept :
+    m_pScheduler(nullptr),
+    m_pTarget(nullptr),
+    m_TimebaseFreq(DefaultTimebaseFreq),
+    m_TimeOffset(0),
+    m_NextDeadline(NoDeadline),
+    m_TimerDevice(this),
+    m_TimeSource(this) {}
+
+CLINT::~CLINT() {
+    if(m_pScheduler != nullptr) {
+        m_pScheduler->RemoveDevice(&m_TimerDevice);
+    }
+}
+
+Result CLINT::Initialize(Word hartCount, hw::DeviceScheduler* pScheduler, DWord timebaseFreq) {
+    diag::AssertNotNull(pScheduler);
+    diag::Assert(m_pScheduler == nullptr, "CLINT was already initialized!\n");
+    diag::Assert(timebaseFreq > 0);
+
+    if(hartCount == 0 || hartCount > MaxHartCount) {
+        return ResultCLINTInvalidHartCount();
+    }
+
+    m_pScheduler = pScheduler;
+    m_TimebaseFreq = timebaseFreq;
+
+    /* mtime starts at 0 and mtimecmp at its maximum, so no timer is pending. */
+    m_TimeOffset = -this->TicksToTime(pScheduler->GetTime());
+    m_Harts.assign(hartCount, HartState{ ~static_cast<DWord>(0), NoDeadline, false, false });
+
+    /* The timer has no deadline until mtimecmp is written. */
+    m_NextDeadline = NoDeadline;
+    return m_pScheduler->AddDevice(&m_TimerDevice);
+}
+
+DWord CLINT::ReadTime() const noexcept {
+    return this->TicksToTime(m_pScheduler->GetTime()) + m_TimeOffset;
+}
+
+void CLINT::WriteTime(DWord val) {
+    m_TimeOffset = val - this->TicksToTime(m_pScheduler->GetTime());
+
+    /* Every deadline moves with mtime. */
+    for(Word i = 0; i < this->GetHartCount(); i++) {
+        this->UpdateTimer(i);
+    }
+}
+
+DWord CLINT::ReadTimeCompare(Word hartId) const noexcept {
+    diag::Assert(hartId < this->GetHartCount());
+    return m_Harts[hartId].timeCompare;
+}
+
+void CLINT::WriteTimeCompare(Word hartId, DWord val) {
+    diag::Assert(hartId < this->GetHartCount());
+
+    m_Harts[hartId].timeCompare = val;
+    this->UpdateTimer(hartId);
+}
+
+bool CLINT::ReadSoftwarePending(Word hartId) const noexcept {
+    diag::Assert(hartId < this->GetHartCount());
+    return m_Harts[hartId].softwarePending;
+}
+
+void CLINT::WriteSoftwarePending(Word hartId, bool val) {
+    diag::Assert(hartId < this->GetHartCount());
+
+    auto& hart = m_Harts[hartId];
+    if(hart.softwarePending != val) {
+        hart.softwarePending = val;
+        if(m_pTarget != nullptr) {
+            m_pTarget->NotifySoftwareInterrupt(hartId, val);
+        }
+    }
+}
+
+bool CLINT::IsTimerPending(Word hartId) const noexcept {
+    diag::Assert(hartId < this->GetHartCount());
+    return m_Harts[hartId].timerPending;
+}
+
+NativeWord CLINT::GetMappedSize() { return AddrSpaceSize; }
+
+/* Registers are only accessible as words and double words. */
+Result CLINT::ReadByte(Byte* pOut, [[maybe_unused]] Address addr) {
+    *pOut = 0;
+    return ResultSuccess();
+}
+
+Result CLINT::ReadHWord(HWord* pOut, [[maybe_unused]] Address addr) {
+    *pOut = 0;
+    return ResultSuccess();
+}
+
+Result CLINT::WriteByte([[maybe_unused]] Byte in, [[maybe_unused]] Address addr) { return ResultSuccess(); }
+Result CLINT::WriteHWord([[maybe_unused]] HWord in, [[maybe_unused]] Address addr) { return ResultSuccess(); }
+
+Result CLINT::ReadWord(Word* pOut, Address addr) {
+    DWord val = 0;
+    if(!this->ReadRegister(&val, addr, sizeof(Word))) {
+        return mem::ResultBadMisalignedAddress();
+    }
+
+    *pOut = static_cast<Word>(val);
+    return ResultSuccess();
+}
+
+Result CLINT::ReadDWord(DWord* pOut, Address addr) {
+    return this->ReadRegister(pOut, addr, sizeof(DWord)) ? Result(ResultSuccess()) : Result(mem::ResultBadMisalignedAddress());
+}
+
+Result CLINT::WriteWord(Word in, Address addr) {
+    return this->WriteRegister(in, addr, sizeof(Word)) ? Result(ResultSuccess()) : Result(mem::ResultBadMisalignedAddress());
+}
+
+Result CLINT::WriteDWord(DWord in, Address addr) {
+    return this->WriteRegister(in, addr, sizeof(DWord)) ? Result(ResultSuccess()) : Result(mem::ResultBadMisalignedAddress());
+}
+
+DWord CLINT::TicksToTime(DWord ticks) const noexcept {
+    return util::ScaleCount(ticks, TickFreq, m_TimebaseFreq);
+}
+
+DWord CLINT::TimeToTicks(DWord time) const noexcept {
+    /* Find the first tick TicksToTime reaches time at, NoDeadline if that's beyond the scheduler's range. */
+    DWord seconds = time / m_TimebaseFreq;
+    if(seconds > NoDeadline / TickFreq - 1) {
+        return NoDeadline;
+    }
+
+    DWord remainder = time % m_TimebaseFreq;
+    return seconds * TickFreq + (remainder * TickFreq + m_TimebaseFreq - 1) / m_TimebaseFreq;
+}
+
+void CLINT::UpdateTimer(Word hartId) {
+    auto& hart = m_Harts[hartId];
+
+    /* The interrupt is pending for as long as mtime >= mtimecmp, otherwise it fires once mtime gets there. */
+    DWord time = this->ReadTime();
+    bool pending = time >= hart.timeCompare;
+    hart.deadline = NoDeadline;
+    if(!pending) {
+        /* Go by the time left rather than mtimecmp - offset, which wraps when mtime was moved. */
+        DWord baseTime = this->TicksToTime(m_pScheduler->GetTime());
+        DWord remaining = hart.timeCompare - time;
+        if(remaining <= ~static_cast<DWord>(0) - baseTime) {
+            hart.deadline = this->TimeToTicks(baseTime + remaining);
+        }
+    }
+    this->SetTimerPending(hartId, pending);
+
+    /* A stale deadline left in the scheduler just finds nothing to do. */
+    this->UpdateNextDeadline();
+    if(m_NextDeadline != NoDeadline) {
+        m_pScheduler->ScheduleDevice(&m_TimerDevice, m_NextDeadline);
+    }
+}
+
+void CLINT::UpdateNextDeadline() {
+    m_NextDeadline = NoDeadline;
+    for(const auto& hart : m_Harts) {
+        m_NextDeadline = std::min(m_NextDeadline, hart.deadline);
+    }
+}
+
+void CLINT::ProcessTimers() {
+    DWord now = m_pScheduler->GetTime();
+    for(Word i = 0; i < this->GetHartCount(); i++) {
+        if(m_Harts[i].deadline <= now) {
+            m_Harts[i].deadline = NoDeadline;
+            this->SetTimerPending(i, true);
+        }
+    }
+
+    this->UpdateNextDeadline();
+}
+
+void CLINT::SetTimerPending(Word hartId, bool pending) {
+    auto& hart = m_Harts[hartId];
+    if(hart.timerPending != pending) {
+        hart.timerPending = pending;
+        if(m_pTarget != nullptr) {
+            m_pTarget->NotifyTimerInterrupt(hartId, pending);
+        }
+    }
+}
+
+bool CLINT::ReadRegister(DWord* pOut, Address addr, std::size_t size) const noexcept {
+    if(addr % size) {
+        return false;
+    }
+
+    /* Unused registers read as zero. */
+    *pOut = 0;
+    if(addr >= TimeStart && addr < TimeStart + sizeof(DWord)) {
+        *pOut = ExtractRegister(this->ReadTime(), addr, size);
+    }
+    else if(addr >= TimeCompareStart && addr < TimeCompareStart + this->GetHartCount() * sizeof(DWord)) {
+        Word hartId = static_cast<Word>((addr - TimeCompareStart) / sizeof(DWord));
+        *pOut = ExtractRegister(m_Harts[hartId].timeCompare, addr, size);
+    }
+    else if(addr >= SoftwarePendingStart && addr < SoftwarePendingStart + this->GetHartCount() * sizeof(Word) && size == sizeof(Word)) {
+        Word hartId = static_cast<Word>((addr - SoftwarePendingStart) / sizeof(Word));
+        *pOut = m_Harts[hartId].softwarePending ? 1 : 0;
+    }
+
+    return true;
+}
+
+bool CLINT::WriteRegister(DWord val, Address addr, std::size_t size) {
+    if(addr % size) {
+        return false;
+    }
+
+    /* Writes to unused registers are ignored. */
+    if(addr >= TimeStart && addr < TimeStart + sizeof(DWord)) {
+        this->WriteTime(MergeRegister(this->ReadTime(), val, addr, size));
+    }
+    else if(addr >= TimeCompareStart && addr < TimeCompareStart + this->GetHartCount() * sizeof(DWord)) {
+        Word hartId = static_cast<Word>((addr - TimeCompareStart) / sizeof(DWord));
+        this->WriteTimeCompare(hartId, MergeRegister(m_Harts[hartId].timeCompare, val, addr, size));
+    }
+    else if(addr >= SoftwarePendingStart && addr < SoftwarePendingStart + this->GetHartCount() * sizeof(Word) && size == sizeof(Word)) {
+        Word hartId = static_cast<Word>((addr - SoftwarePendingStart) / sizeof(Word));
+        this->WriteSoftwarePending(hartId, (val & 1) != 0);
+    }
+
+    return true;
+}
+
+} // namespace intrpt
+} // namespace riscv
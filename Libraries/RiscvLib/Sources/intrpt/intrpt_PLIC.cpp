@@ -2,6 +2,8 @@
 #include <RiscvEmu/intrpt/intrpt_Result.h>
 #include <RiscvEmu/diag.h>
 #include <RiscvEmu/util/util_Bitfields.h>
+#include <algorithm>
+#include <bit>
 
 namespace riscv {
 namespace intrpt {
@@ -37,7 +39,10 @@ constexpr Word GetEnabledTarget(Word val) noexcept { return val / EnabledWordsPe
 constexpr Word GetEnabledSource(Word val) noexcept { return val % EnabledWordsPerContext; }
 
 constexpr Word GetContextTarget(Word val) noexcept { return val / ContextRegWordCount; }
-constexpr Word GetContextRegId (Word val) noexcept { return val % ContextSize; }
+constexpr Word GetContextRegId (Word val) noexcept { return val % ContextRegWordCount; }
+
+constexpr Word GetSourceWord(Word source) noexcept { return source / WordBitLen; }
+constexpr Word GetSourceBit (Word source) noexcept { return source % WordBitLen; }
 
 } // namespace
 
@@ -51,13 +56,14 @@ Result PLIC::MmioInterface::WriteByte([[maybe_unused]] Byte, [[maybe_unused]] Ad
 Result PLIC::MmioInterface::WriteHWord([[maybe_unused]] HWord, [[maybe_unused]] Address) { return ResultSuccess(); }
 Result PLIC::MmioInterface::WriteDWord([[maybe_unused]] DWord, [[maybe_unused]] Address) { return ResultSuccess(); }
 
+/* Accesses are word aligned by AlignedMmioDev, registers are indexed by word. */
 Result PLIC::MmioInterface::ReadWord(Word* pOut, Address addr) {
-    *pOut = m_pParent->ReadRegister(static_cast<Word>(addr));
+    *pOut = m_pParent->ReadRegister(static_cast<Word>(addr / sizeof(Word)));
     return ResultSuccess();
 }
 
 Result PLIC::MmioInterface::WriteWord(Word in, Address addr) {
-    m_pParent->WriteRegister(static_cast<Word>(addr), in);
+    m_pParent->WriteRegister(static_cast<Word>(addr / sizeof(Word)), in);
     return ResultSuccess();
 }
 
@@ -67,59 +73,40 @@ PLIC::Target::~Target() = default;
 void PLIC::Target::Initialize(PLIC* pParent, TargetPtrT&& pTarget, Word id, Word pending) {
     diag::AssertNotNull(pParent);
     diag::AssertNotNull(pTarget);
-    m_pTarget = std::move(pTarget);
+    ITargetForCtrl::Initialize(std::move(pTarget));
     m_EnableBits.resize(pending);
     m_pParent = pParent;
     m_PrioThreshold = 0;
     m_Id = id;
 }
 
-void PLIC::Target::Finalize() { m_pTarget.reset(); }
-
-bool PLIC::Target::IsInitialized() const noexcept { return m_pTarget != nullptr; }
-
 Word PLIC::Target::ReadEnableReg(Word index) const {
-    diag::Assert(m_Id < m_EnableBits.size());
+    diag::Assert(index < m_EnableBits.size());
     return m_EnableBits[index];
 }
 
 void PLIC::Target::WriteEnableReg(Word index, Word val) {
-    diag::Assert(m_Id < m_EnableBits.size());
+    diag::Assert(index < m_EnableBits.size());
     m_EnableBits[index] = val;
 }
 
 Word PLIC::Target::ReadPrioThreshold() const noexcept { return m_PrioThreshold; }
-void PLIC::Target::WritePrioThreshold(Word val) noexcept { m_PrioThreshold = val; }
+void PLIC::Target::WritePrioThreshold(Word val) noexcept { m_PrioThreshold = std::min(val, MaxPriority); }
 
-bool PLIC::Target::HasEnabledIRQ(Word src) {
-    auto reg = this->ReadEnableReg(src / sizeof(m_EnableBits[0]) * 8);
-    return util::ExtractBitfield(reg, src % 32, 1);
+bool PLIC::Target::HasClaimableIRQ() const noexcept {
+    Word id = 0;
+    return this->IsInitialized() && m_pParent->FindClaimable(&id, *this);
 }
 
-bool PLIC::Target::CanTakeTopIRQ() {
-    auto& top = m_pParent->GetQueueTop();
-
-    /* Return false if this target isn't initialized. */
-    if(!this->IsInitialized()) {
-        return false;
-    }
-
-    /* Return false if the source priority is too low for this target. */
-    if(top.priority < m_PrioThreshold) {
-        return false;
-    }
-
-    /* Return false if this target doesn't have this interrupt enabled. */
-    if(!this->HasEnabledIRQ(top.pSrc->GetId())) {
-        return false;
-    }
+bool PLIC::Target::HasPendingIRQ() { return this->HasClaimableIRQ(); }
 
-    return true;
-}
+/* Targets are always notified, these hints aren't needed. */
+Result PLIC::Target::EnableInterrupts() { return ResultSuccess(); }
+Result PLIC::Target::DisableInterrupts() { return ResultSuccess(); }
 
 Result PLIC::Target::NotifyAvailableIRQImpl() {
-    /* Check if we can take the top IRQ. */
-    if(!this->CanTakeTopIRQ()) {
+    /* Check if there's an IRQ we can take. */
+    if(!this->HasClaimableIRQ()) {
         return ResultSuccess();
     }
 
@@ -143,7 +130,20 @@ void PLIC::Source::Finalize() noexcept { m_pParent = nullptr; }
 bool PLIC::Source::IsInitialized() const noexcept { return m_pParent != nullptr; }
 
 Word PLIC::Source::ReadPriority() const noexcept { return m_Priority; }
-void PLIC::Source::WritePriority(Word val) noexcept { m_Priority = val; }
+
+void PLIC::Source::WritePriority(Word val) noexcept {
+    /* Move pending requests to the new priority level. */
+    bool isClaimable = m_State == InterruptState::Pending;
+    if(isClaimable) {
+        m_pParent->SetClaimable(*this, false);
+    }
+
+    m_Priority = std::min(val, MaxPriority);
+
+    if(isClaimable) {
+        m_pParent->SetClaimable(*this, true);
+    }
+}
 
 PLIC::InterruptState PLIC::Source::GetState() const noexcept { return m_State; }
 
@@ -168,7 +168,7 @@ Word PLIC::Source::NotifyClaimed() noexcept {
 
 void PLIC::Source::NotifyComplete() noexcept {
     /* Do nothing if we aren't initialized. */
-    if(this->IsInitialized()) {
+    if(!this->IsInitialized()) {
         return;
     }
 
@@ -183,9 +183,9 @@ void PLIC::Source::NotifyComplete() noexcept {
         return;
     }
 
-    /* If we do have more pending interrupts, set our state to pending and add ourself to the queue.. */
+    /* If we do have more pending interrupts, set our state to pending and become claimable again. */
     m_State = PLIC::InterruptState::Pending;
-    m_pParent->AddSourceToQueue(this);
+    m_pParent->AddClaimableSource(this);
 }
 
 Word PLIC::Source::GetId() const noexcept {
@@ -202,20 +202,15 @@ Result PLIC::Source::SignalInterrupt() {
     /* Increment pending count. */
     m_PendingCount++;
 
-    /* If our pending count is 1 and status is waiting, add ourself to our parent's queue. */
+    /* If our pending count is 1 and status is waiting, become claimable. */
     if (m_PendingCount == 1 && m_State == InterruptState::Waiting) {
-        m_pParent->AddSourceToQueue(this);
         m_State = PLIC::InterruptState::Pending;
+        m_pParent->AddClaimableSource(this);
     }
 
     return ResultSuccess();
 }
 
-PLIC::QueueData::QueueData(Source* p, Word prio) noexcept :
-    pSrc(p), priority(prio) {}
-
-auto PLIC::QueueData::operator<=>(const QueueData& rhs) const noexcept { return this->priority <=> rhs.priority; }
-
 Result PLIC::Initialize(int sourceCount, int targetCount) {
     /* Make sure source count is valid. */
     if (sourceCount >= MaxSourceCount || sourceCount < MinSourceCount) {
@@ -243,6 +238,10 @@ Result PLIC::Initialize(int sourceCount, int targetCount) {
 
     m_PendingBits.resize(m_PendingCount);
 
+    /* Nothing can be claimed yet. */
+    m_Levels = {};
+    m_NonEmptyLevels = 0;
+
     return ResultSuccess();
 }
 
@@ -271,7 +270,7 @@ Result PLIC::RegisterSource(ISource** ppSrc, Word id) {
     this->AssertSourceIdValid(id);
     diag::AssertNotNull(ppSrc);
 
-    auto src = m_Sources[id];
+    auto& src = m_Sources[id];
 
     if(src.IsInitialized()) {
         return ResultPLICSourceAlreadyTaken();
@@ -311,10 +310,10 @@ bool PLIC::GetEnabled(int source, int target) const noexcept {
 
     /* Read enabled register. */
     Word reg = 0;
-    this->ReadEnabledRegImpl(&reg, static_cast<Word>(target * EnabledWordsPerContext + source));
+    this->ReadEnabledRegImpl(&reg, static_cast<Word>(target * EnabledWordsPerContext) + GetSourceWord(static_cast<Word>(source)));
 
     /* Extract bit. */
-    return util::ExtractBitfield(reg, static_cast<Word>(source) % WordBitLen, 1);
+    return util::ExtractBitfield(reg, GetSourceBit(static_cast<Word>(source)), 1);
 }
 
 void PLIC::SetEnabled(int source, int target, bool enable) noexcept {
@@ -323,14 +322,14 @@ void PLIC::SetEnabled(int source, int target, bool enable) noexcept {
     this->AssertSourceIdValid(static_cast<Word>(source));
 
     /* Read enabled register. */
-    auto regId = static_cast<Word>(target * EnabledWordsPerContext + source);
+    auto regId = static_cast<Word>(target * EnabledWordsPerContext) + GetSourceWord(static_cast<Word>(source));
     Word reg = 0;
     if (!this->ReadEnabledRegImpl(&reg, regId)) {
         return;
     }
 
     /* Write bit. */
-    reg = util::AssignBitfield(reg, static_cast<Word>(source) % WordBitLen, 1, static_cast<Word>(enable));
+    reg = util::AssignBitfield(reg, GetSourceBit(static_cast<Word>(source)), 1, static_cast<Word>(enable));
 
     /* Write register back. */
     this->WriteEnabledReg(regId, reg);
@@ -363,7 +362,7 @@ void PLIC::WriteRegister(Word index, Word val) {
         return;
     }
     else /* if (index >= PriorityRegStart) */ {
-        this->WriteRegister(index - PriorityRegStart, val);
+        this->WritePriorityReg(index - PriorityRegStart, val);
     }
 }
 
@@ -380,12 +379,9 @@ void PLIC::WritePriorityReg(Word index, Word val) noexcept {
         return;
     }
 
-    /* Write priority for the appropriate source. */
+    /* Write priority for the appropriate source, this moves it between priority levels. */
     this->WritePriorityRegImpl(index, val);
 
-    /* Readd to queue. */
-    this->AddSourceToQueue(m_Sources.data() + index);
-
     /* Attempt to interrupt all target. */
     this->NotifyAllTargetsIRQAvailable();
 }
@@ -403,9 +399,11 @@ Word PLIC::ReadEnabledReg(Word index) const noexcept {
 }
 
 void PLIC::WriteEnabledReg(Word index, Word val) noexcept {
-    /* Read current value. */
+    /* Read current value, noop if the target or source word is bad. */
     Word cur = 0;
-    this->ReadEnabledRegImpl(&cur, index);
+    if (!this->ReadEnabledRegImpl(&cur, index)) {
+        return;
+    }
 
     /* Write new value. */
     this->WriteEnabledRegImpl(index, val);
@@ -421,6 +419,11 @@ Word PLIC::ReadContextReg(Word index) {
     auto target = GetContextTarget(index);
     auto regId = GetContextRegId(index);
 
+    /* Contexts past the last target read as zero. */
+    if (!this->TargetIdValid(target)) {
+        return 0;
+    }
+
     /* Handle reading from priority threshold. */
     if (regId == ContextPriorityThresholdReg) {
         return m_Targets[target].ReadPrioThreshold();
@@ -432,11 +435,17 @@ Word PLIC::ReadContextReg(Word index) {
     }
 
     /* Claim top request. */
-    return this->ClaimTopRequest();
+    return this->ClaimRequest(m_Targets[target]);
 }
 
 void PLIC::WriteContextReg(Word index, Word val) {
-    auto& target = m_Targets[GetContextTarget(index)];
+    /* Writes to contexts past the last target are ignored. */
+    auto targetId = GetContextTarget(index);
+    if (!this->TargetIdValid(targetId)) {
+        return;
+    }
+
+    auto& target = m_Targets[targetId];
     auto regId = GetContextRegId(index);
 
     /* Handle writing to priority threshold. */
@@ -453,7 +462,9 @@ void PLIC::WriteContextReg(Word index, Word val) {
     }
 
     /* Signal that we've finished handling the interrupt. */
-    m_Sources[val].NotifyComplete();
+    if (this->SourceIdValid(val)) {
+        m_Sources[val].NotifyComplete();
+    }
 }
 
 bool PLIC::ReadPriorityRegImpl(Word* pOut, Word index) const noexcept {
@@ -494,75 +505,92 @@ bool PLIC::WritePendingRegImpl(Word index, Word val) noexcept {
 
 bool PLIC::ReadEnabledRegImpl(Word* pOut, Word index) const noexcept {
     auto target = GetEnabledTarget(index);
-    auto source = GetEnabledSource(index);
+    auto sourceWord = GetEnabledSource(index);
 
-    if (!this->TargetIdValid(target) || !this->SourceIdValid(source)) {
+    if (!this->TargetIdValid(target) || sourceWord >= m_PendingCount) {
         return false;
     }
 
-    *pOut = m_Targets[target].ReadEnableReg(source);
+    *pOut = m_Targets[target].ReadEnableReg(sourceWord);
     return true;
 }
 
 bool PLIC::WriteEnabledRegImpl(Word index, Word val) noexcept {
     auto target = GetEnabledTarget(index);
-    auto source = GetEnabledSource(index);
+    auto sourceWord = GetEnabledSource(index);
 
-    if (!this->TargetIdValid(target) || !this->SourceIdValid(source)) {
+    if (!this->TargetIdValid(target) || sourceWord >= m_PendingCount) {
         return false;
     }
 
-    m_Targets[target].WriteEnableReg(val, source);
+    m_Targets[target].WriteEnableReg(sourceWord, val);
     return true;
 }
 
-void PLIC::CleanupQueue() {
-    /* Remove any entries with incorrect priority or non-pending status. */
-    const auto* pTop = &m_Queue.top();
-    while ((pTop->priority != pTop->pSrc->ReadPriority() ||
-        pTop->pSrc->GetState() != InterruptState::Pending) &&
-        !m_Queue.empty()) {
-        m_Queue.pop();
-        pTop = &m_Queue.top();
+void PLIC::SetClaimable(const Source& src, bool claimable) noexcept {
+    auto id = src.GetId();
+    auto word = GetSourceWord(id);
+    auto priority = src.ReadPriority();
+    auto& level = m_Levels[priority];
+
+    /* Update the source's bit, then the masks of non-empty words and levels above it. */
+    level.claimable[word] = util::AssignBitfield(level.claimable[word], GetSourceBit(id), 1, static_cast<Word>(claimable));
+    level.nonEmptyWords = util::AssignBitfield(level.nonEmptyWords, word, 1, static_cast<Word>(level.claimable[word] != 0));
+    m_NonEmptyLevels = util::AssignBitfield(m_NonEmptyLevels, priority, 1, static_cast<Word>(level.nonEmptyWords != 0));
+}
+
+bool PLIC::FindClaimable(Word* pOut, const Target& target) const noexcept {
+    /* Only levels above the target's threshold can interrupt it, priority 0 never does. */
+    Word levels = m_NonEmptyLevels & ~((Word{ 2 } << target.ReadPrioThreshold()) - 1);
+
+    /* Search from the highest level, within a level the lowest source id wins. */
+    while (levels) {
+        auto priority = static_cast<Word>(std::bit_width(levels) - 1);
+        const auto& level = m_Levels[priority];
+
+        for (Word words = level.nonEmptyWords; words; words &= words - 1) {
+            auto word = static_cast<Word>(std::countr_zero(words));
+            Word bits = level.claimable[word] & target.ReadEnableReg(word);
+            if (bits) {
+                *pOut = word * static_cast<Word>(WordBitLen) + static_cast<Word>(std::countr_zero(bits));
+                return true;
+            }
+        }
+
+        levels &= ~(Word{ 1 } << priority);
     }
+
+    return false;
 }
 
-void PLIC::AddSourceToQueue(Source* pSrc) {
+void PLIC::AddClaimableSource(Source* pSrc) {
     /* Assert that source is not null. */
     diag::AssertNotNull(pSrc);
 
-    /* Add source to queue. */
-    m_Queue.emplace(pSrc, pSrc->ReadPriority());
+    /* Mark source claimable at its priority. */
+    this->SetClaimable(*pSrc, true);
 
-    /* Notify targets if the queue was previously empty. */
-    if(m_Queue.size() == 1) {
-        this->NotifyAllTargetsIRQAvailable();
-    }
+    /* Notify targets which can take it. */
+    this->NotifyAllTargetsIRQAvailable();
 }
 
-Word PLIC::ClaimTopRequest() {
+Word PLIC::ClaimRequest(Target& target) {
     /* Set claimed flag. */
     m_Claimed = true;
 
-    /* Cleanup queue to be safe. */
-    this->CleanupQueue();
-
-    /* Return 0 if we have no requests. */
-    if (m_Queue.empty()) {
+    /* Return 0 if we have no requests for this target. */
+    Word id = 0;
+    if (!target.IsInitialized() || !this->FindClaimable(&id, target)) {
         return 0;
     }
 
-    /* Get top entry. */
-    auto* pTop = m_Queue.top().pSrc;
-
-    /* Remove from queue. */
-    m_Queue.pop();
-
-    /* Notify source it's been claimed. */
-    auto id = pTop->NotifyClaimed();
+    /* Notify source it's been claimed, it's no longer claimable until it completes. */
+    auto& src = m_Sources[id];
+    this->SetClaimable(src, false);
+    src.NotifyClaimed();
 
     /* Notify targets if any other interrupts are available. */
-    if(!m_Queue.empty()) {
+    if (m_NonEmptyLevels) {
         this->NotifyAllTargetsIRQAvailable();
     }
 
@@ -570,11 +598,8 @@ Word PLIC::ClaimTopRequest() {
 }
 
 void PLIC::NotifyAllTargetsIRQAvailable() {
-    /* Cleanup queue. */
-    this->CleanupQueue();
-
-    /* Return if queue is empty. */
-    if (m_Queue.empty()) {
+    /* Return if nothing can be claimed. */
+    if (!m_NonEmptyLevels) {
         return;
     }
 
@@ -607,7 +632,5 @@ void PLIC::AssertSourceIdValid(Word id, const std::source_location& location) co
     diag::Assert(this->SourceIdValid(id), diag::FormatString("Invalid Source ID (max = %u; provided = %u)\n", location), m_SourceCount - 1, id);
 }
 
-const PLIC::QueueData& PLIC::GetQueueTop() const { return m_Queue.top(); }
-
 } // namespace intrpt
 } // namespace riscv
@@ -0,0 +1,113 @@
+#include <RiscvEmu/mem/detail/mem_HostMemory.h>
+#include <RiscvEmu/mem/mem_Result.h>
+#include <RiscvEmu/diag.h>
+#include <algorithm>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace riscv {
+namespace mem {
+namespace detail {
+
+HostMemory::HostMemory() noexcept :
+    m_pMem(nullptr), m_Length(0) {}
+
+HostMemory::HostMemory(HostMemory&& other) noexcept :
+    m_pMem(std::exchange(other.m_pMem, nullptr)),
+    m_Length(std::exchange(other.m_Length, 0)) {}
+
+HostMemory::~HostMemory() { this->Finalize(); }
+
+HostMemory& HostMemory::operator=(HostMemory&& other) noexcept {
+    if(this != &other) {
+        this->Finalize();
+        m_pMem = std::exchange(other.m_pMem, nullptr);
+        m_Length = std::exchange(other.m_Length, 0);
+    }
+    return *this;
+}
+
+Result HostMemory::Initialize(std::size_t length) {
+    this->Finalize();
+
+    /* Anonymous mappings are zero filled on first touch, so untouched memory costs nothing. */
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(p == MAP_FAILED) {
+        return ResultHostMapFailed();
+    }
+
+    m_pMem = static_cast<Byte*>(p);
+    m_Length = length;
+
+    return ResultSuccess();
+}
+
+Result HostMemory::InitializeFromFile(std::size_t length, const char* pFilePath, FileMapMode mode) {
+    diag::AssertNotNull(pFilePath);
+    diag::Assert(mode != FileMapMode::None);
+
+    /* Start with zero filled memory, the file is mapped over the start of it. */
+    Result res = this->Initialize(length);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Open the file, shared mappings need to be able to write back. */
+    int fd = open(pFilePath, mode == FileMapMode::Shared ? O_RDWR : O_RDONLY);
+    if(fd < 0) {
+        this->Finalize();
+        return ResultFileOpenFailed();
+    }
+
+    /* Get the file's size. */
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        this->Finalize();
+        return ResultFileOpenFailed();
+    }
+
+    auto fileSize = static_cast<std::size_t>(st.st_size);
+
+    /* Shared regions extend the file so the entire region is written back. */
+    if(mode == FileMapMode::Shared && fileSize < length) {
+        if(ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            close(fd);
+            this->Finalize();
+            return ResultFileOpenFailed();
+        }
+        fileSize = length;
+    }
+
+    /* Map the file over the start of the region. Pages past the end of the file stay anonymous. */
+    auto mapLen = std::min(fileSize, length);
+    if(mapLen) {
+        int flags = MAP_FIXED | (mode == FileMapMode::Shared ? MAP_SHARED : MAP_PRIVATE);
+        void* p = mmap(m_pMem, mapLen, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if(p == MAP_FAILED) {
+            close(fd);
+            this->Finalize();
+            return ResultHostMapFailed();
+        }
+    }
+
+    /* The mapping keeps its own reference to the file. */
+    close(fd);
+
+    return ResultSuccess();
+}
+
+void HostMemory::Finalize() noexcept {
+    if(m_pMem) {
+        munmap(m_pMem, m_Length);
+        m_pMem = nullptr;
+        m_Length = 0;
+    }
+}
+
+} // namespace detail
+} // namespace mem
+} // namespace riscv
@@ -1,34 +1,57 @@
 #include <RiscvEmu/mem/mem_MemoryController.h>
+#include <RiscvEmu/diag.h>
 
 namespace riscv {
 namespace mem {
 
 Result MemoryController::Initialize(const RegionInfo* pRegions, std::size_t regionCount) {
+    /* Validate every region up front, so a bad entry leaves the existing regions untouched. */
+    const RegionInfo* pMemInfo = nullptr;
     for(std::size_t i = 0; i < regionCount; i++) {
         const auto& curRegion = pRegions[i];
 
-        /* Check if this new regions conflicts with any currently existing regions. */
-        if (m_MemRegion.Includes(curRegion.GetStart()) ||
-            m_MemRegion.Includes(curRegion.GetEnd() - 1) ||
-            this->FindIoRegion(curRegion.GetStart()) != nullptr ||
-            this->FindIoRegion(curRegion.GetEnd() - 1) != nullptr) {
-            return ResultRegionAlreadyExists();
+        /* Check the region isn't empty and doesn't wrap around the address space. */
+        if(curRegion.GetLength() == 0 || curRegion.GetEnd() < curRegion.GetStart()) {
+            return ResultInvalidRegionSize();
         }
 
-        /* Add new mem region if the current region is a mem region. */
-        if(curRegion.GetType() == RegionType::Memory) {
-            /* Setup the new MemRegion. */
-            m_MemRegion.Initialize(curRegion);
+        /* Check if this new region conflicts with another new region. */
+        for(std::size_t j = 0; j < i; j++) {
+            if(pRegions[j].Overlaps(curRegion)) {
+                return ResultRegionAlreadyExists();
+            }
         }
-        else if(curRegion.GetType() == RegionType::IO) {
-            /* Setup the new IoRegion. */
-            m_IoRegions.emplace_back(curRegion);
+
+        if(curRegion.GetType() == RegionType::Memory) {
+            pMemInfo = &curRegion;
         }
-        else {
+        else if(curRegion.GetType() != RegionType::IO) {
             return ResultInvalidRegionType();
         }
     }
 
+    /* Setup the new MemRegion first, it's the only step that may fail and it leaves the old one intact if it does. */
+    if(pMemInfo) {
+        Result res = m_MemRegion.Initialize(*pMemInfo);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+    else {
+        m_MemRegion.Finalize();
+    }
+
+    /* Drop the old IoRegions along with any execute in place ranges of their devices. */
+    m_IoRegions.clear();
+    m_ExecRegions.clear();
+
+    /* Setup the new IoRegions. */
+    for(std::size_t i = 0; i < regionCount; i++) {
+        if(pRegions[i].GetType() == RegionType::IO) {
+            m_IoRegions.emplace_back(pRegions[i]);
+        }
+    }
+
     return ResultSuccess();
 }
 
@@ -40,19 +63,93 @@ Result MemoryController::AddMmioDev(IMmioDev* pDev, Address addr) {
     }
 
     /* Make sure this new device doesn't overlap with an existing one. */
-    auto len = pDev->GetMappedSize();
+    detail::IoDev newDev(addr, pDev->GetMappedSize(), pDev);
     for(const auto& dev : pRegion->GetDevList()) {
-        if(dev.Includes(addr) || dev.Includes(addr + len)) {
+        if(dev.Overlaps(newDev)) {
             return ResultDeviceAlreadyExists();
         }
     }
 
     /* Add the new device. */
-    pRegion->GetDevList().emplace_back(addr, len, pDev);
+    auto len = newDev.GetLength();
+    pRegion->GetDevList().push_back(newDev);
+
+    /* Record any range the device allows executing in place. */
+    std::span<const Byte> backing;
+    NativeWord offset = 0;
+    if(pDev->GetReadOnlyBacking(&backing, &offset).IsSuccess() && !backing.empty()) {
+        diag::Assert(offset <= len && backing.size() <= len - offset);
+        m_ExecRegions.emplace_back(addr + offset, static_cast<NativeWord>(backing.size()), backing.data());
+    }
+
+    return ResultSuccess();
+}
+
+Result MemoryController::GetHostSpan(std::span<Byte>* pOut, Address addr, NativeWord len) {
+    diag::AssertNotNull(pOut);
+
+    /* Only main memory is guaranteed to be backed by contiguous host memory. */
+    if(!m_MemRegion.IncludesRange(addr, len)) {
+        return ResultNotRamBacked();
+    }
+
+    *pOut = std::span<Byte>(m_MemRegion.GetHostPointer(addr - m_MemRegion.GetStart()), len);
+    return ResultSuccess();
+}
+
+Result MemoryController::GetExecSpan(std::span<const Byte>* pOut, Address addr, NativeWord len) {
+    diag::AssertNotNull(pOut);
+
+    /* Main memory is always executable. */
+    if(m_MemRegion.IncludesRange(addr, len)) {
+        *pOut = std::span<const Byte>(m_MemRegion.GetHostPointer(addr - m_MemRegion.GetStart()), len);
+        return ResultSuccess();
+    }
 
+    /* Otherwise check for a device range that may be executed in place. */
+    detail::ExecRegion* pRegion = this->FindExecRegion(addr, len);
+    if(!pRegion) {
+        return ResultNotRamBacked();
+    }
+
+    *pOut = std::span<const Byte>(pRegion->GetHostPointer(addr - pRegion->GetStart()), len);
     return ResultSuccess();
 }
 
+Result MemoryController::FetchWord(Word* pOut, Address addr) {
+    /* First let's check if this address is in main memory. */
+    if(m_MemRegion.IncludesRange(addr, sizeof(Word))) {
+        return m_MemRegion.ReadWord(pOut, addr - m_MemRegion.GetStart());
+    }
+
+    /* Next try fetching directly from a device's backing memory. */
+    detail::ExecRegion* pRegion = this->FindExecRegion(addr, sizeof(Word));
+    if(pRegion) {
+        return pRegion->ReadWord(pOut, addr - pRegion->GetStart());
+    }
+
+    /* Finally fall back to a regular read. */
+    return this->ReadWord(pOut, addr);
+}
+
+void MemoryController::EnableDirtyPageTracking() {
+    m_MemRegion.EnableDirtyPageTracking();
+}
+
+std::size_t MemoryController::GetDirtyPageWordCount() const noexcept {
+    return m_MemRegion.GetDirtyPageWordCount();
+}
+
+void MemoryController::FetchAndClearDirtyPages(std::span<DWord> out) {
+    m_MemRegion.FetchAndClearDirtyPages(out);
+}
+
+void MemoryController::MarkDirty(Address addr, NativeWord len) noexcept {
+    if(m_MemRegion.IncludesRange(addr, len)) {
+        m_MemRegion.MarkDirty(addr - m_MemRegion.GetStart(), len);
+    }
+}
+
 Result MemoryController::ReadByte(Byte* pOut, Address addr) {
     return this->ReadWriteImpl<&decltype(m_MemRegion)::ReadByte, &IMmioDev::ReadByte>(pOut, addr);
 }
@@ -111,12 +208,14 @@ Result MemoryController::WriteNativeWord(NativeWord in, Address addr) {
 
 template<auto MemRead, auto IoRead, typename T>
 Result MemoryController::ReadWriteImpl(T pOut, Address addr) {
-    /* First let's check if this address is in main memory. */
-    if(m_MemRegion.Includes(addr)) {
+    constexpr NativeWord AccessSize = sizeof(std::remove_pointer_t<T>);
+
+    /* First let's check if this access is in main memory. */
+    if(m_MemRegion.IncludesRange(addr, AccessSize)) {
         return (m_MemRegion.*MemRead)(pOut, addr - m_MemRegion.GetStart());
     }
     /* Next if that fails let's try reading/writing from/to an IO device. */
-    detail::IoDev* pDev = this->FindIoDevice(addr, sizeof(std::remove_pointer_t<T>));
+    detail::IoDev* pDev = this->FindIoDevice(addr, AccessSize);
     if(pDev) {
         return (*pDev->GetDevice().*IoRead)(pOut, addr - pDev->GetStart());
     }
@@ -152,12 +251,21 @@ detail::IoDev* MemoryController::FindIoDevice(Address addr, NativeWord len) {
     }
 
     /* Finally let's make sure our access doesn't go out of bounds. */
-    if(!pDev->Includes(relAddr + len)) {
+    if(!pDev->IncludesRange(relAddr, len)) {
         return nullptr;
     }
 
     return pDev;
 }
 
+detail::ExecRegion* MemoryController::FindExecRegion(Address addr, NativeWord len) {
+    for(auto& region : m_ExecRegions) {
+        if(region.IncludesRange(addr, len)) {
+            return &region;
+        }
+    }
+    return nullptr;
+}
+
 } // namespace mem
 } // namespace riscv
@@ -1,22 +1,464 @@
 #include <RiscvEmu/riscv_System.h>
+#include <algorithm>
 
 namespace riscv {
 
-Result System::Initialize() {
-    /* Initialize Hart(s). */
-    Hart::SharedContext hartShared(&m_MemCtlr);
-    Result res = m_Hart.Initialize(hartShared);
-    if(res.IsFailure()) {
-        return res;
+namespace {
+
+/* Largest batch whose conversion to ticks can't overflow. */
+constexpr DWord MaxBatchInstCount = hw::DeviceScheduler::NoDeadline / hw::DeviceScheduler::TickFreq / 2;
+
+} // namespace
+
+System::~System() {
+    /* Make sure no hart threads outlive us. */
+    if(this->IsRunning()) {
+        this->Stop();
+        this->Join();
+    }
+}
+
+Result System::Initialize(Word hartCount) {
+    diag::Assert(hartCount > 0);
+    diag::Assert(!this->IsRunning());
+
+    /* Initialize state shared between harts. */
+    m_HartSharedState.Initialize(hartCount, &m_MemCtlr);
+
+    /* Create Hart(s). */
+    m_HartCount = hartCount;
+    m_pHarts = std::make_unique<cpu::Hart[]>(hartCount);
+
+    for(Word i = 0; i < hartCount; i++) {
+        /* Initialize Hart. */
+        Result res = m_pHarts[i].Initialize(&m_HartSharedState, i);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Reset Hart. */
+        res = m_pHarts[i].Reset();
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    /* Select the time source. */
+    if(m_TimeMode == cpu::Hart::TimeMode::External) {
+        this->SetTimeSource(m_pTimeSource);
+    }
+    else {
+        this->SetTimeMode(m_TimeMode);
+    }
+
+    return ResultSuccess();
+}
+
+void System::SetExecMode(ExecMode mode, DWord quantum, std::size_t workerCount) noexcept {
+    diag::Assert(quantum > 0);
+    diag::Assert(!this->IsRunning());
+
+    m_ExecMode = mode;
+    m_Quantum = quantum;
+    m_WorkerCount = workerCount;
+}
+
+void System::SetGuestFrequency(DWord freq) noexcept {
+    diag::Assert(freq > 0);
+    diag::Assert(!this->IsRunning());
+
+    m_GuestFreq = freq;
+
+    /* Instret time counts at the guest frequency. */
+    if(m_TimeMode != cpu::Hart::TimeMode::External) {
+        this->SetTimeMode(m_TimeMode);
+    }
+}
+
+void System::SetTimeMode(cpu::Hart::TimeMode mode) {
+    diag::Assert(mode != cpu::Hart::TimeMode::External, "External time needs a source, see SetTimeSource!\n");
+    diag::Assert(!this->IsRunning());
+
+    m_TimeMode = mode;
+    m_pTimeSource = nullptr;
+    for(Word i = 0; i < m_HartCount; i++) {
+        m_pHarts[i].SetTimeMode(mode, m_GuestFreq);
+    }
+}
+
+void System::SetTimeSource(const cpu::ITimeSource* pSource) {
+    diag::AssertNotNull(pSource);
+    diag::Assert(!this->IsRunning());
+
+    m_TimeMode = cpu::Hart::TimeMode::External;
+    m_pTimeSource = pSource;
+    for(Word i = 0; i < m_HartCount; i++) {
+        m_pHarts[i].SetTimeSource(pSource);
+    }
+}
+
+void System::SetRealTimePacing(bool enable) noexcept {
+    diag::Assert(!this->IsRunning());
+    m_RealTimePacing = enable;
+}
+
+Result System::Run(DWord instCount) {
+    diag::Assert(m_HartCount > 0);
+    diag::Assert(!this->IsRunning());
+
+    m_StopRequested.store(false, std::memory_order_relaxed);
+
+    /* Devices see virtual time, so that's what gets paced. */
+    cpu::Pacer pacer;
+    DWord pacedCount = 0;
+    DWord quantum = m_Quantum;
+    if(m_RealTimePacing) {
+        pacer.Start(m_GuestFreq, pacedCount);
+
+        /* Leads beyond the pacer's drift limit aren't slept off, keep batches well below it. */
+        quantum = std::min(quantum, pacer.GetSliceInstCount());
+    }
+
+    while(instCount > 0 && !m_StopRequested.load(std::memory_order_relaxed)) {
+        /* Nothing happens until a device is due while every hart waits, skip straight to the deadline. */
+        if(this->AreAllHartsWaiting()) {
+            /* Paced skips are slept through, keep them short enough that devices see host events in time. */
+            DWord maxSkip = m_RealTimePacing ? pacer.GetSliceInstCount() : MaxBatchInstCount;
+            DWord skip = this->GetBatchInstCount(std::min(instCount, maxSkip));
+            for(Word i = 0; i < m_HartCount; i++) {
+                if(m_pHarts[i].IsIdle()) {
+                    m_pHarts[i].CountIdleCycles(skip);
+                }
+                else {
+                    m_pHarts[i].RetireSelfLoop(skip);
+                }
+            }
+            instCount -= skip;
+            pacedCount += skip;
+
+            /* Wait for wall clock time to reach the devices' deadline before processing them. */
+            if(m_RealTimePacing && pacer.IsDue(pacedCount)) {
+                pacer.Pace(pacedCount, m_StopRequested);
+            }
+
+            Result res = this->AdvanceDevices(skip);
+            if(res.IsFailure()) {
+                return res;
+            }
+            continue;
+        }
+
+        /* Run every hart up to the next deadline, never past the largest batch virtual time can advance by. */
+        DWord batch = this->GetBatchInstCount(std::min({ instCount, quantum, MaxBatchInstCount }));
+        for(Word i = 0; i < m_HartCount; i++) {
+            cpu::Hart& hart = m_pHarts[i];
+            DWord startCount = hart.GetCycleCount();
+            if(!hart.IsIdle()) {
+                Result res = this->ExecuteBatch(hart, batch);
+                if(res.IsFailure()) {
+                    return res;
+                }
+            }
+
+            /* Harts idle for all or the rest of the batch, or which yielded it, still count its cycles. */
+            DWord executed = hart.GetCycleCount() - startCount;
+            if(executed < batch) {
+                if(hart.IsIdle()) {
+                    hart.CountIdleCycles(batch - executed);
+                }
+                else {
+                    hart.CountYieldedCycles(batch - executed);
+                }
+            }
+        }
+        instCount -= batch;
+        pacedCount += batch;
+
+        if(m_RealTimePacing && pacer.IsDue(pacedCount)) {
+            pacer.Pace(pacedCount, m_StopRequested);
+        }
+
+        Result res = this->AdvanceDevices(batch);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    return ResultSuccess();
+}
+
+Result System::Start() {
+    diag::Assert(m_HartCount > 0);
+    diag::Assert(!this->IsRunning());
+    diag::Assert(!m_RealTimePacing || m_ExecMode != ExecMode::ThreadPool);
+
+    /* Devices would never be processed, and aren't safe to access from several hart threads. */
+    diag::Assert(m_DevScheduler.GetDeviceCount() == 0, "Start can't run devices, use Run!\n");
+
+    /* Clear state left over from a previous run. */
+    m_StopRequested.store(false, std::memory_order_relaxed);
+    m_HartResult.store(ResultSuccess().GetValue(), std::memory_order_relaxed);
+
+    /* Harts sharing host threads must never block them. */
+    for(Word i = 0; i < m_HartCount; i++) {
+        m_pHarts[i].SetBlockingWaitEnabled(m_ExecMode == ExecMode::ThreadPerHart);
+    }
+
+    if(m_ExecMode == ExecMode::ThreadPool) {
+        /* The pool manages its own threads. */
+        m_HartPool.Start(m_pHarts.get(), m_HartCount, m_WorkerCount, m_Quantum);
+    }
+    else if(m_ExecMode == ExecMode::RoundRobin) {
+        /* Start a single thread for all harts. */
+        m_ThreadCount = 1;
+        m_pHartThreads = std::make_unique<std::thread[]>(m_ThreadCount);
+        m_pHartThreads[0] = std::thread(&System::RunRoundRobin, this);
+    }
+    else {
+        /* Start a thread for each hart. */
+        m_ThreadCount = m_HartCount;
+        m_pHartThreads = std::make_unique<std::thread[]>(m_ThreadCount);
+        for(Word i = 0; i < m_HartCount; i++) {
+            m_pHartThreads[i] = std::thread(&System::RunHart, this, i);
+        }
+    }
+
+    return ResultSuccess();
+}
+
+Result System::Step(DWord roundCount) {
+    diag::Assert(!this->IsRunning());
+
+    for(DWord round = 0; round < roundCount; round++) {
+        for(Word i = 0; i < m_HartCount; i++) {
+            Result res = this->ExecuteQuantum(m_pHarts[i]);
+            if(res.IsFailure()) {
+                return res;
+            }
+        }
+    }
+
+    return ResultSuccess();
+}
+
+void System::Stop() noexcept {
+    m_StopRequested.store(true, std::memory_order_relaxed);
+    m_HartPool.Stop();
+
+    /* Harts blocked in WRS or idle in WFI wouldn't notice the request otherwise. */
+    for(Word i = 0; i < m_HartCount; i++) {
+        m_pHarts[i].Wake();
     }
+    this->NotifyWake();
+}
 
-    /* Reset Hart(s). */
-    res = m_Hart.Reset();
-    if(res.IsFailure()) {
-        return res;
+void System::WakeHart(Word hartId) {
+    diag::Assert(hartId < m_HartCount);
+
+    /* The pool needs to know about wakes to requeue parked harts, it turns them away unless it's running. */
+    if(!m_HartPool.Wake(hartId)) {
+        m_pHarts[hartId].Wake();
     }
+    this->NotifyWake();
+}
+
+std::shared_ptr<intrpt::ITarget> System::CreateIrqTarget(Word hartId) {
+    diag::Assert(hartId < m_HartCount);
+    return std::make_shared<HartIrqTarget>(this, hartId);
+}
+
+Result System::Join() {
+    diag::Assert(this->IsRunning());
+
+    if(m_HartPool.IsRunning()) {
+        return m_HartPool.Join();
+    }
+
+    /* Wait for every hart thread to exit. */
+    for(std::size_t i = 0; i < m_ThreadCount; i++) {
+        m_pHartThreads[i].join();
+    }
+    m_pHartThreads.reset();
+
+    /* Step runs harts on the calling thread, which must not block. */
+    for(Word i = 0; i < m_HartCount; i++) {
+        m_pHarts[i].SetBlockingWaitEnabled(false);
+    }
+
+    return Result(m_HartResult.load(std::memory_order_relaxed));
+}
+
+Result System::ExecuteQuantum(cpu::Hart& hart) {
+    return this->ExecuteBatch(hart, m_Quantum);
+}
 
+Result System::ExecuteBatch(cpu::Hart& hart, DWord instCount) {
+    /* Harts stop at WFI until they're woken. */
+    for(DWord i = 0; i < instCount && !hart.IsIdle(); i++) {
+        Result res = hart.ExecuteInstAtPc();
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Spinning harts give the remainder of their quantum to the next hart. */
+        if(hart.ConsumeYieldRequest()) {
+            break;
+        }
+    }
     return ResultSuccess();
 }
 
+bool System::AreAllHartsWaiting() const noexcept {
+    for(Word i = 0; i < m_HartCount; i++) {
+        if(!m_pHarts[i].IsIdle() && !m_pHarts[i].IsSelfLooping()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Result System::AdvanceDevices(DWord instCount) {
+    /* Convert the instructions to ticks, carrying the fraction over to the next call. */
+    DWord total = instCount * hw::DeviceScheduler::TickFreq + m_TickRemainder;
+    m_TickRemainder = total % m_GuestFreq;
+
+    /* Process the devices due within them. */
+    return m_DevScheduler.Advance(total / m_GuestFreq);
+}
+
+DWord System::GetBatchInstCount(DWord maxInstCount) const noexcept {
+    DWord deadline = m_DevScheduler.GetNextDeadline();
+    if(deadline == hw::DeviceScheduler::NoDeadline) {
+        return maxInstCount;
+    }
+
+    /* Deadlines already passed are due after a single tick, like hw::DeviceScheduler::AdvanceToNextDeadline. */
+    DWord now = m_DevScheduler.GetTime();
+    DWord ticks = deadline > now ? deadline - now + 1 : 1;
+
+    /* Deadlines beyond the largest batch don't limit it, this also keeps the conversion below from overflowing. */
+    DWord maxTicks = (maxInstCount * hw::DeviceScheduler::TickFreq + m_TickRemainder) / m_GuestFreq;
+    if(ticks > maxTicks) {
+        return maxInstCount;
+    }
+
+    /* Find the fewest instructions which run for the ticks, rounding up. */
+    DWord needed = ticks * m_GuestFreq - m_TickRemainder;
+    return (needed + hw::DeviceScheduler::TickFreq - 1) / hw::DeviceScheduler::TickFreq;
+}
+
+void System::SignalHartFailure(Result res) noexcept {
+    /* Record the first failure and bring down the remaining harts. */
+    Word expected = ResultSuccess().GetValue();
+    m_HartResult.compare_exchange_strong(expected, res.GetValue(), std::memory_order_relaxed);
+    this->Stop();
+}
+
+void System::NotifyWake() noexcept {
+    m_WakeCount.fetch_add(1, std::memory_order_seq_cst);
+    m_WakeCount.notify_all();
+}
+
+void System::RunHart(Word hartId) {
+    cpu::Hart& hart = m_pHarts[hartId];
+
+    /* Every hart keeps its own schedule, by the instructions it retired. */
+    const bool pacing = m_RealTimePacing;
+    cpu::Pacer pacer;
+    if(pacing) {
+        pacer.Start(m_GuestFreq, hart.GetCycleCount());
+    }
+
+    while(!m_StopRequested.load(std::memory_order_relaxed)) {
+        Result res = hart.ExecuteInstAtPc();
+        if(res.IsFailure()) {
+            this->SignalHartFailure(res);
+            break;
+        }
+
+        if(pacing && pacer.IsDue(hart.GetCycleCount())) {
+            pacer.Pace(hart.GetCycleCount(), m_StopRequested);
+        }
+
+        /* Give the host thread up until an interrupt source or Stop wakes the hart. */
+        if(hart.IsIdle()) {
+            hart.WaitWhileIdle();
+
+            /* Nothing retires while idle, the time spent isn't owed. */
+            if(pacing) {
+                pacer.Resync(hart.GetCycleCount());
+            }
+        }
+    }
+}
+
+void System::RunRoundRobin() {
+    /* Harts run side by side in guest time, so a round lasts as long as the most any hart retired in it. */
+    const bool pacing = m_RealTimePacing;
+    cpu::Pacer pacer;
+    DWord pacedCount = 0;
+    DWord quantum = m_Quantum;
+    if(pacing) {
+        pacer.Start(m_GuestFreq, pacedCount);
+
+        /* Leads beyond the pacer's drift limit aren't slept off, keep rounds well below it. */
+        quantum = std::min(quantum, pacer.GetSliceInstCount());
+    }
+
+    /* Stop requests are only checked between rounds. */
+    while(!m_StopRequested.load(std::memory_order_relaxed)) {
+        /* Take the wake count first, so a wake after the idle check below isn't slept through. */
+        Word wakeCount = m_WakeCount.load(std::memory_order_seq_cst);
+
+        bool allIdle = true;
+        DWord roundCount = 0;
+        for(Word i = 0; i < m_HartCount; i++) {
+            cpu::Hart& hart = m_pHarts[i];
+            if(hart.IsIdle()) {
+                continue;
+            }
+
+            allIdle = false;
+            DWord startCount = hart.GetCycleCount();
+            Result res = this->ExecuteBatch(hart, quantum);
+            if(res.IsFailure()) {
+                this->SignalHartFailure(res);
+                return;
+            }
+            roundCount = std::max(roundCount, hart.GetCycleCount() - startCount);
+        }
+
+        /* Sleep until some hart is woken. */
+        if(allIdle) {
+            m_WakeCount.wait(wakeCount, std::memory_order_seq_cst);
+            if(pacing) {
+                pacer.Resync(pacedCount);
+            }
+            continue;
+        }
+
+        pacedCount += roundCount;
+        if(pacing && pacer.IsDue(pacedCount)) {
+            pacer.Pace(pacedCount, m_StopRequested);
+        }
+    }
+}
+
+Result System::HartIrqTarget::NotifyAvailableIRQ() {
+    m_pParent->WakeHart(m_HartId);
+    return ResultSuccess();
+}
+
+void System::ClintTarget::NotifyTimerInterrupt(Word hartId, bool pending) {
+    if(pending) {
+        m_pParent->WakeHart(hartId);
+    }
+}
+
+void System::ClintTarget::NotifySoftwareInterrupt(Word hartId, bool pending) {
+    if(pending) {
+        m_pParent->WakeHart(hartId);
+    }
+}
+
 } // namespace riscv
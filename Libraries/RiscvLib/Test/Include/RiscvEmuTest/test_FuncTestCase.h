@@ -0,0 +1,28 @@
+#pragma once
+#include <RiscvEmu/result.h>
+#include <RiscvEmuTest/test_TestCaseBase.h>
+#include <string_view>
+
+namespace riscv {
+namespace test {
+
+/**
+ * Test case running a plain function, for tests which set up their own objects instead of sharing a hart.
+*/
+template<typename SysT>
+class FuncTestCase : public TestCaseBase<FuncTestCase<SysT>, SysT> {
+public:
+    using FuncType = Result(*)(SysT*);
+
+    constexpr FuncTestCase(std::string_view name, FuncType func) noexcept :
+        TestCaseBase<FuncTestCase<SysT>, SysT>(name),
+        m_Func(func) {}
+private:
+    friend class TestCaseBase<FuncTestCase<SysT>, SysT>;
+    Result RunImpl(SysT* pSys) const { return m_Func(pSys); }
+private:
+    FuncType m_Func;
+}; // class FuncTestCase
+
+} // namespace test
+} // namespace riscv
@@ -9,5 +9,7 @@ class ResultRegValMismatch : public result::ErrorBase<detail::ModuleId, 1> {};
 
 class ResultMemValMismatch : public result::ErrorBase<detail::ModuleId, 2> {};
 
+class ResultValMismatch : public result::ErrorBase<detail::ModuleId, 3> {};
+
 } // namespace test
 } // namespace riscv
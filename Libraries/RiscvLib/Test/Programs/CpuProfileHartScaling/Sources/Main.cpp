@@ -0,0 +1,143 @@
+#include <RiscvEmu/cpu/cpu_EncodeInstruction.h>
+#include <RiscvEmu/cpu/cpu_Hart.h>
+#include <RiscvEmu/mem/mem_MemoryController.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace riscv;
+
+namespace {
+
+constexpr Address MemoryAddress = 0x80000000;
+constexpr NativeWord MemorySize = 0x100000;
+constexpr Address CodeAddress = MemoryAddress;
+constexpr Address DataAddress = MemoryAddress + 0x10000;
+constexpr Address DataStride = 0x1000;
+
+/* Every hart runs the same loop on its own data page: load, increment, store, count. */
+constexpr Word LoopCode[] = {
+    cpu::EncodeITypeInstruction(cpu::Opcode::LOAD, cpu::Function::LW, 3, 2, 0),
+    cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 3, 3, 1),
+    cpu::EncodeSTypeInstruction(cpu::Opcode::STORE, cpu::Function::SW, 2, 3, 0),
+    cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 4, 4, 1),
+    cpu::EncodeJTypeInstruction(cpu::Opcode::JAL, 0, static_cast<Word>(-16)),
+};
+
+void HartThread(cpu::Hart* pHart, DWord instCount, const std::atomic<bool>* pStart, std::atomic<bool>* pFailed) {
+    /* Wait for every thread to be ready so they all start together. */
+    while(!pStart->load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    for(DWord i = 0; i < instCount; i++) {
+        if(pHart->ExecuteInstAtPc().IsFailure()) {
+            pFailed->store(true, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+Result RunHarts(std::chrono::nanoseconds* pOut, Word hartCount, DWord instCount) {
+    /* Setup memory and load the loop. */
+    auto pMemCtlr = std::make_unique<mem::MemoryController>();
+    static constexpr mem::RegionInfo memReg{ MemoryAddress, MemorySize, mem::RegionType::Memory };
+    Result res = pMemCtlr->Initialize(&memReg, 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    for(std::size_t i = 0; i < std::size(LoopCode); i++) {
+        res = pMemCtlr->WriteWord(LoopCode[i], CodeAddress + i * sizeof(Word));
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    /* Setup harts. */
+    auto pSharedState = std::make_unique<cpu::Hart::SharedState>();
+    pSharedState->Initialize(hartCount, pMemCtlr.get());
+
+    auto pHarts = std::make_unique<cpu::Hart[]>(hartCount);
+    for(Word i = 0; i < hartCount; i++) {
+        res = pHarts[i].Initialize(pSharedState.get(), i);
+        if(res.IsSuccess()) {
+            res = pHarts[i].Reset();
+        }
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        pHarts[i].WritePC(CodeAddress);
+        pHarts[i].WriteGPR(2, DataAddress + i * DataStride);
+    }
+
+    /* Start a thread for each hart. */
+    std::atomic<bool> start = false;
+    std::atomic<bool> failed = false;
+    auto pThreads = std::make_unique<std::thread[]>(hartCount);
+    for(Word i = 0; i < hartCount; i++) {
+        pThreads[i] = std::thread(HartThread, &pHarts[i], instCount, &start, &failed);
+    }
+
+    /* Time until the last hart finishes. */
+    auto startTime = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for(Word i = 0; i < hartCount; i++) {
+        pThreads[i].join();
+    }
+    *pOut = std::chrono::steady_clock::now() - startTime;
+
+    return failed.load(std::memory_order_relaxed) ? Result(cpu::ResultInvalidInstruction()) : Result(ResultSuccess());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        std::cout << std::format("Usage: {} [max_hart_count] [inst_count] [min_efficiency=0.8]", argv[0]) << std::endl;
+        return 1;
+    }
+
+    /* Parse arguments. */
+    Word maxHartCount = static_cast<Word>(strtol(argv[1], nullptr, 10));
+    DWord instCount = static_cast<DWord>(strtoll(argv[2], nullptr, 10));
+    double minEfficiency = argc > 3 ? strtod(argv[3], nullptr) : 0.8;
+
+    /* Only check scaling up to the number of host cores, beyond that harts have to share. */
+    Word coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    /*
+     * Each hart executes the same number of instructions independently,
+     * so with perfect scaling every run takes as long as the single hart run.
+    */
+    std::chrono::nanoseconds baseTime{};
+    bool passed = true;
+    for(Word hartCount = 1; hartCount <= maxHartCount; hartCount *= 2) {
+        std::chrono::nanoseconds time{};
+        Result res = RunHarts(&time, hartCount, instCount);
+        if(res.IsFailure()) {
+            std::cout << std::format("Harts: {} Failed: {:#x}", hartCount, res.GetValue()) << std::endl;
+            return 1;
+        }
+
+        if(hartCount == 1) {
+            baseTime = time;
+        }
+
+        double efficiency = static_cast<double>(baseTime.count()) / static_cast<double>(time.count());
+        bool checked = hartCount <= coreCount;
+        if(checked && efficiency < minEfficiency) {
+            passed = false;
+        }
+
+        std::cout << std::format("Harts: {:3} Time: {:>12} Efficiency: {:6.1f}%{}", hartCount,
+            std::chrono::duration_cast<std::chrono::microseconds>(time), efficiency * 100.0, checked ? "" : " (oversubscribed)") << std::endl;
+    }
+
+    return passed ? 0 : 1;
+}
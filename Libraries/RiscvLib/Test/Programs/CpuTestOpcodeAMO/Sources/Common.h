@@ -0,0 +1,154 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/cpu/test_HartTestCase.h>
+#include <RiscvEmuTest/cpu/test_HartTestSystem.h>
+
+namespace riscv {
+namespace test {
+
+constexpr Word EncodeAmoInstruction(cpu::Function width, cpu::AmoFunction func, int rd, int rs1, int rs2) noexcept {
+    return cpu::EncodeRTypeInstruction(cpu::Opcode::AMO, cpu::GetFunction3(width), static_cast<int>(func) << 2, rd, rs1, rs2);
+}
+
+class TestInstAMO : public HartSingleInstTestBase<TestInstAMO> {
+public:
+    using AddrPairT = std::pair<Address, DWord>;
+
+    /**
+     * @param[in] rd  Register and its expected value.
+     * @param[in] rs1  Register and its initial value, the address operated on.
+     * @param[in] rs2  Register and its initial value.
+     * @param[in] memInitial  DWord written to memory before running.
+     * @param[in] memExpect  DWord expected in memory after running.
+     * @param[in] reserve  Execute an LR of the same width on rs1 before running.
+    */
+    constexpr TestInstAMO(std::string_view name, cpu::Function width, cpu::AmoFunction func, RegPairT rd, RegPairT rs1, RegPairT rs2, AddrPairT memInitial, AddrPairT memExpect, bool reserve = false) :
+        HartSingleInstTestBase(cpu::Instruction(EncodeAmoInstruction(width, func, GetPairId(rd), GetPairId(rs1), GetPairId(rs2))), name),
+        m_ReserveInst(EncodeAmoInstruction(width, cpu::AmoFunction::LR, 0, GetPairId(rs1), 0)),
+        m_ExpectedRd(rd),
+        m_InitialRs1(rs1),
+        m_InitialRs2(rs2),
+        m_InitialMemVal(memInitial),
+        m_ExpectedMemVal(memExpect),
+        m_Reserve(reserve) {}
+private:
+    friend class HartSingleInstTestBase<TestInstAMO>;
+    Result Initialize(HartTestSystem* pSys) const {
+        /* Write initial memory value. */
+        Result res = pSys->MemWriteDWord(std::get<1>(m_InitialMemVal), std::get<0>(m_InitialMemVal));
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Write rs1 & rs2. */
+        pSys->WriteGPR(m_InitialRs1);
+        pSys->WriteGPR(m_InitialRs2);
+
+        /* Reserve the address if requested. */
+        if(m_Reserve) {
+            return pSys->ExecuteInst(m_ReserveInst);
+        }
+
+        return ResultSuccess();
+    }
+
+    Result Check(HartTestSystem* pSys) const {
+        /* Check rd value. */
+        Result res = pSys->CheckGPR(m_ExpectedRd);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Read memory. */
+        DWord out = 0;
+        res = pSys->MemReadDWord(&out, std::get<0>(m_ExpectedMemVal));
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Check that the data read is correct. */
+        if(out != std::get<1>(m_ExpectedMemVal)) {
+            return ResultMemValMismatch();
+        }
+
+        return ResultSuccess();
+    }
+private:
+    cpu::Instruction m_ReserveInst;
+    RegPairT m_ExpectedRd;
+    RegPairT m_InitialRs1;
+    RegPairT m_InitialRs2;
+    AddrPairT m_InitialMemVal;
+    AddrPairT m_ExpectedMemVal;
+    bool m_Reserve;
+}; // class TestInstAMO
+
+class TestInstAMOCAS : public HartSingleInstTestBase<TestInstAMOCAS> {
+public:
+    using AddrPairT = std::pair<Address, DWord>;
+
+    /**
+     * @param[in] rdInitial  Register and its initial value, the value compared against.
+     * @param[in] rdExpect  Expected value of the same register, the old memory value.
+     * @param[in] rs1  Register and its initial value, the address operated on.
+     * @param[in] rs2  Register and its initial value, the value swapped in.
+     * @param[in] memInitial  DWord written to memory before running.
+     * @param[in] memExpect  DWord expected in memory after running.
+    */
+    constexpr TestInstAMOCAS(std::string_view name, cpu::Function width, RegPairT rdInitial, NativeWord rdExpect, RegPairT rs1, RegPairT rs2, AddrPairT memInitial, AddrPairT memExpect) :
+        HartSingleInstTestBase(cpu::Instruction(EncodeAmoInstruction(width, cpu::AmoFunction::AMOCAS, GetPairId(rdInitial), GetPairId(rs1), GetPairId(rs2))), name),
+        m_InitialRd(rdInitial),
+        m_ExpectedRd(GetPairId(rdInitial), rdExpect),
+        m_InitialRs1(rs1),
+        m_InitialRs2(rs2),
+        m_InitialMemVal(memInitial),
+        m_ExpectedMemVal(memExpect) {}
+private:
+    friend class HartSingleInstTestBase<TestInstAMOCAS>;
+    Result Initialize(HartTestSystem* pSys) const {
+        /* Write initial memory value. */
+        Result res = pSys->MemWriteDWord(std::get<1>(m_InitialMemVal), std::get<0>(m_InitialMemVal));
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Write rd, rs1 & rs2. */
+        pSys->WriteGPR(m_InitialRd);
+        pSys->WriteGPR(m_InitialRs1);
+        pSys->WriteGPR(m_InitialRs2);
+
+        return ResultSuccess();
+    }
+
+    Result Check(HartTestSystem* pSys) const {
+        /* Check rd value. */
+        Result res = pSys->CheckGPR(m_ExpectedRd);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Read memory. */
+        DWord out = 0;
+        res = pSys->MemReadDWord(&out, std::get<0>(m_ExpectedMemVal));
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Check that the data read is correct. */
+        if(out != std::get<1>(m_ExpectedMemVal)) {
+            return ResultMemValMismatch();
+        }
+
+        return ResultSuccess();
+    }
+private:
+    RegPairT m_InitialRd;
+    RegPairT m_ExpectedRd;
+    RegPairT m_InitialRs1;
+    RegPairT m_InitialRs2;
+    AddrPairT m_InitialMemVal;
+    AddrPairT m_ExpectedMemVal;
+}; // class TestInstAMOCAS
+
+} // namespace test
+} // namespace riscv
@@ -0,0 +1,244 @@
+#include "Common.h"
+
+/* TODO: Misaligned addresses, access/page faults. */
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+constexpr TestFramework g_TestRunner{
+    &HartTestSystem::DefaultReset,
+
+    std::tuple{
+        /* Test LR.W sign extends the loaded word. */
+        TestInstAMO{
+            "LR_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::LR,
+            { 10, static_cast<NativeWord>(static_cast<WordS>(0x80000000)) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 0, 0 },
+            { HartTestSystem::MemoryAddress, 0x5555555580000000 },
+            { HartTestSystem::MemoryAddress, 0x5555555580000000 }
+        },
+
+        /* Test SC.W without a reservation fails and leaves memory untouched. */
+        TestInstAMO{
+            "SC_W_NoReservation",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::SC,
+            { 10, 1 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0xAABBCCDD },
+            { HartTestSystem::MemoryAddress, 0x5555555511223344 },
+            { HartTestSystem::MemoryAddress, 0x5555555511223344 }
+        },
+
+        /* Test SC.W after LR.W succeeds. */
+        TestInstAMO{
+            "SC_W_Reserved",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::SC,
+            { 10, 0 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0xAABBCCDD },
+            { HartTestSystem::MemoryAddress, 0x5555555511223344 },
+            { HartTestSystem::MemoryAddress, 0x55555555AABBCCDD },
+            true
+        },
+
+        /* Test AMOSWAP.W only touches the addressed word. */
+        TestInstAMO{
+            "AMOSWAP_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOSWAP,
+            { 10, 0x11223344 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0xAABBCCDD },
+            { HartTestSystem::MemoryAddress, 0x5555555511223344 },
+            { HartTestSystem::MemoryAddress, 0x55555555AABBCCDD }
+        },
+
+        /* Test AMOADD.W wraps within the word and sign extends rd. */
+        TestInstAMO{
+            "AMOADD_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOADD,
+            { 10, static_cast<NativeWord>(-1) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 1 },
+            { HartTestSystem::MemoryAddress, 0x55555555FFFFFFFF },
+            { HartTestSystem::MemoryAddress, 0x5555555500000000 }
+        },
+
+        /* Test AMOXOR.W. */
+        TestInstAMO{
+            "AMOXOR_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOXOR,
+            { 10, 0x0F0F0F0F },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x00FF00FF },
+            { HartTestSystem::MemoryAddress, 0x0F0F0F0F },
+            { HartTestSystem::MemoryAddress, 0x0FF00FF0 }
+        },
+
+        /* Test AMOAND.W. */
+        TestInstAMO{
+            "AMOAND_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOAND,
+            { 10, 0x0F0F0F0F },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x00FF00FF },
+            { HartTestSystem::MemoryAddress, 0x0F0F0F0F },
+            { HartTestSystem::MemoryAddress, 0x000F000F }
+        },
+
+        /* Test AMOOR.W. */
+        TestInstAMO{
+            "AMOOR_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOOR,
+            { 10, 0x0F0F0F0F },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x00FF00FF },
+            { HartTestSystem::MemoryAddress, 0x0F0F0F0F },
+            { HartTestSystem::MemoryAddress, 0x0FFF0FFF }
+        },
+
+        /* Test AMOMIN.W compares signed. */
+        TestInstAMO{
+            "AMOMIN_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOMIN,
+            { 10, static_cast<NativeWord>(-1) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0xFFFFFFFF },
+            { HartTestSystem::MemoryAddress, 0xFFFFFFFF }
+        },
+
+        /* Test AMOMAX.W compares signed. */
+        TestInstAMO{
+            "AMOMAX_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOMAX,
+            { 10, static_cast<NativeWord>(-1) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0xFFFFFFFF },
+            { HartTestSystem::MemoryAddress, 0x00000005 }
+        },
+
+        /* Test AMOMINU.W compares unsigned. */
+        TestInstAMO{
+            "AMOMINU_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOMINU,
+            { 10, static_cast<NativeWord>(-1) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0xFFFFFFFF },
+            { HartTestSystem::MemoryAddress, 0x00000005 }
+        },
+
+        /* Test AMOMAXU.W compares unsigned. */
+        TestInstAMO{
+            "AMOMAXU_W",
+            cpu::Function::AMO_W,
+            cpu::AmoFunction::AMOMAXU,
+            { 10, static_cast<NativeWord>(-1) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0xFFFFFFFF },
+            { HartTestSystem::MemoryAddress, 0xFFFFFFFF }
+        },
+
+        /* Test AMOCAS.W swaps when memory matches and sign extends the old value. */
+        TestInstAMOCAS{
+            "AMOCAS_W_Match",
+            cpu::Function::AMO_W,
+            { 10, static_cast<NativeWord>(static_cast<WordS>(0x80000001)) },
+            static_cast<NativeWord>(static_cast<WordS>(0x80000001)),
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x12345678 },
+            { HartTestSystem::MemoryAddress, 0x5555555580000001 },
+            { HartTestSystem::MemoryAddress, 0x5555555512345678 }
+        },
+
+        /* Test AMOCAS.W leaves memory untouched on mismatch. */
+        TestInstAMOCAS{
+            "AMOCAS_W_Mismatch",
+            cpu::Function::AMO_W,
+            { 10, 7 },
+            9,
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x12345678 },
+            { HartTestSystem::MemoryAddress, 0x5555555500000009 },
+            { HartTestSystem::MemoryAddress, 0x5555555500000009 }
+        },
+
+        /* Test AMOCAS.B only compares the low byte. */
+        TestInstAMOCAS{
+            "AMOCAS_B",
+            cpu::Function::AMO_B,
+            { 10, 0xFFFFFF80 },
+            static_cast<NativeWord>(-128),
+            { 1, HartTestSystem::MemoryAddress + 1 },
+            { 15, 0x11 },
+            { HartTestSystem::MemoryAddress, 0x5555555555558055 },
+            { HartTestSystem::MemoryAddress, 0x5555555555551155 }
+        },
+
+        /* Test AMOADD.B wraps within the byte. */
+        TestInstAMO{
+            "AMOADD_B",
+            cpu::Function::AMO_B,
+            cpu::AmoFunction::AMOADD,
+            { 10, static_cast<NativeWord>(-1) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 2 },
+            { HartTestSystem::MemoryAddress, 0x55555555555555FF },
+            { HartTestSystem::MemoryAddress, 0x5555555555555501 }
+        },
+
+        /* Test AMOMAX.H compares signed halfwords. */
+        TestInstAMO{
+            "AMOMAX_H",
+            cpu::Function::AMO_H,
+            cpu::AmoFunction::AMOMAX,
+            { 10, static_cast<NativeWord>(static_cast<HWordS>(0x8000)) },
+            { 1, HartTestSystem::MemoryAddress + 2 },
+            { 15, 0xFFFF },
+            { HartTestSystem::MemoryAddress, 0x5555555580005555 },
+            { HartTestSystem::MemoryAddress, 0x55555555FFFF5555 }
+        },
+
+        /* Test AMOMAXU.H compares unsigned halfwords. */
+        TestInstAMO{
+            "AMOMAXU_H",
+            cpu::Function::AMO_H,
+            cpu::AmoFunction::AMOMAXU,
+            { 10, static_cast<NativeWord>(static_cast<HWordS>(0x8000)) },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x7FFF },
+            { HartTestSystem::MemoryAddress, 0x5555555555558000 },
+            { HartTestSystem::MemoryAddress, 0x5555555555558000 }
+        },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args args) {
+    static HartTestSystem sys;
+
+    sys.Initialize();
+
+    return g_TestRunner.RunAll(&sys);
+}
+
+} // namespace test
+} // namespace riscv
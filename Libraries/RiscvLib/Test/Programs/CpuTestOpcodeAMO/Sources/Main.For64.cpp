@@ -0,0 +1,194 @@
+#include "Common.h"
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+constexpr TestFramework g_TestRunner{
+    &HartTestSystem::DefaultReset,
+
+    std::tuple{
+        /* Test LR.D. */
+        TestInstAMO{
+            "LR_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::LR,
+            { 10, 0x8000000011223344 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 0, 0 },
+            { HartTestSystem::MemoryAddress, 0x8000000011223344 },
+            { HartTestSystem::MemoryAddress, 0x8000000011223344 }
+        },
+
+        /* Test SC.D without a reservation fails and leaves memory untouched. */
+        TestInstAMO{
+            "SC_D_NoReservation",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::SC,
+            { 10, 1 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0xAABBCCDDEEFF0011 },
+            { HartTestSystem::MemoryAddress, 0x1122334455667788 },
+            { HartTestSystem::MemoryAddress, 0x1122334455667788 }
+        },
+
+        /* Test SC.D after LR.D succeeds. */
+        TestInstAMO{
+            "SC_D_Reserved",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::SC,
+            { 10, 0 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0xAABBCCDDEEFF0011 },
+            { HartTestSystem::MemoryAddress, 0x1122334455667788 },
+            { HartTestSystem::MemoryAddress, 0xAABBCCDDEEFF0011 },
+            true
+        },
+
+        /* Test AMOSWAP.D. */
+        TestInstAMO{
+            "AMOSWAP_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOSWAP,
+            { 10, 0x1122334455667788 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0xAABBCCDDEEFF0011 },
+            { HartTestSystem::MemoryAddress, 0x1122334455667788 },
+            { HartTestSystem::MemoryAddress, 0xAABBCCDDEEFF0011 }
+        },
+
+        /* Test AMOADD.D carries into the upper word. */
+        TestInstAMO{
+            "AMOADD_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOADD,
+            { 10, 0x00000000FFFFFFFF },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 1 },
+            { HartTestSystem::MemoryAddress, 0x00000000FFFFFFFF },
+            { HartTestSystem::MemoryAddress, 0x0000000100000000 }
+        },
+
+        /* Test AMOXOR.D. */
+        TestInstAMO{
+            "AMOXOR_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOXOR,
+            { 10, 0x0F0F0F0F0F0F0F0F },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x00FF00FF00FF00FF },
+            { HartTestSystem::MemoryAddress, 0x0F0F0F0F0F0F0F0F },
+            { HartTestSystem::MemoryAddress, 0x0FF00FF00FF00FF0 }
+        },
+
+        /* Test AMOAND.D. */
+        TestInstAMO{
+            "AMOAND_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOAND,
+            { 10, 0x0F0F0F0F0F0F0F0F },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x00FF00FF00FF00FF },
+            { HartTestSystem::MemoryAddress, 0x0F0F0F0F0F0F0F0F },
+            { HartTestSystem::MemoryAddress, 0x000F000F000F000F }
+        },
+
+        /* Test AMOOR.D. */
+        TestInstAMO{
+            "AMOOR_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOOR,
+            { 10, 0x0F0F0F0F0F0F0F0F },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x00FF00FF00FF00FF },
+            { HartTestSystem::MemoryAddress, 0x0F0F0F0F0F0F0F0F },
+            { HartTestSystem::MemoryAddress, 0x0FFF0FFF0FFF0FFF }
+        },
+
+        /* Test AMOMIN.D compares signed. */
+        TestInstAMO{
+            "AMOMIN_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOMIN,
+            { 10, 0x8000000000000000 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000000 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000000 }
+        },
+
+        /* Test AMOMAX.D compares signed. */
+        TestInstAMO{
+            "AMOMAX_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOMAX,
+            { 10, 0x8000000000000000 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000000 },
+            { HartTestSystem::MemoryAddress, 0x0000000000000005 }
+        },
+
+        /* Test AMOMINU.D compares unsigned. */
+        TestInstAMO{
+            "AMOMINU_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOMINU,
+            { 10, 0x8000000000000000 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000000 },
+            { HartTestSystem::MemoryAddress, 0x0000000000000005 }
+        },
+
+        /* Test AMOMAXU.D compares unsigned. */
+        TestInstAMO{
+            "AMOMAXU_D",
+            cpu::Function::AMO_D,
+            cpu::AmoFunction::AMOMAXU,
+            { 10, 0x8000000000000000 },
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 5 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000000 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000000 }
+        },
+
+        /* Test AMOCAS.D swaps when memory matches. */
+        TestInstAMOCAS{
+            "AMOCAS_D_Match",
+            cpu::Function::AMO_D,
+            { 10, 0x8000000000000001 },
+            0x8000000000000001,
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x1122334455667788 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000001 },
+            { HartTestSystem::MemoryAddress, 0x1122334455667788 }
+        },
+
+        /* Test AMOCAS.D leaves memory untouched on mismatch. */
+        TestInstAMOCAS{
+            "AMOCAS_D_Mismatch",
+            cpu::Function::AMO_D,
+            { 10, 0x8000000000000001 },
+            0x8000000000000002,
+            { 1, HartTestSystem::MemoryAddress },
+            { 15, 0x1122334455667788 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000002 },
+            { HartTestSystem::MemoryAddress, 0x8000000000000002 }
+        },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args args) {
+    static HartTestSystem sys;
+
+    sys.Initialize();
+
+    return g_TestRunner.RunAll(&sys);
+}
+
+} // namespace test
+} // namespace riscv
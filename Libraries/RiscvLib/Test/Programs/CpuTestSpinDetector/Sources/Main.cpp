@@ -0,0 +1,146 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_TestCaseBase.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/cpu/test_HartTestSystem.h>
+#include <RiscvEmu/cpu/cpu_EncodeInstruction.h>
+#include <RiscvEmu/cpu/detail/cpu_SpinDetector.h>
+#include <array>
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+constexpr Address DataAddress = HartTestSystem::MemoryAddress + 0x100;
+
+/* lw t0, 0(a0) */
+constexpr Word LoadData = cpu::EncodeITypeInstruction(cpu::Opcode::LOAD, cpu::Function::LW, 5, 10, 0);
+
+/* addi t1, t1, -1 */
+constexpr Word DecrementCounter = cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 6, 6, static_cast<Word>(-1));
+
+/* Loops are short enough to be recognized, so tests run them for well past the spin threshold. */
+constexpr DWord IterationCount = cpu::detail::SpinDetector::SpinIterationCount * 4;
+
+class TestSpinLoop : public TestCaseBase<TestSpinLoop, HartTestSystem> {
+public:
+    using LoopT = std::array<Word, 3>;
+
+    /**
+     * @param[in] loop  Instructions of the loop, unused entries are left 0.
+     * @param[in] loopLength  Number of instructions in the loop.
+     * @param[in] counter  Initial value of t1.
+     * @param[in] spinExpected  Whether the hart should have asked to yield after running the loop.
+    */
+    constexpr TestSpinLoop(std::string_view name, LoopT loop, DWord loopLength, NativeWord counter, bool spinExpected) noexcept :
+        TestCaseBase(name),
+        m_Loop(loop),
+        m_LoopLength(loopLength),
+        m_Counter(counter),
+        m_SpinExpected(spinExpected) {}
+private:
+    friend class TestCaseBase<TestSpinLoop, HartTestSystem>;
+    Result RunImpl(HartTestSystem* pSys) const {
+        /* Write the loop and the value it polls. */
+        for(std::size_t i = 0; i < m_Loop.size(); i++) {
+            Result res = pSys->MemWriteWord(m_Loop[i], HartTestSystem::MemoryAddress + i * sizeof(Word));
+            if(res.IsFailure()) {
+                return res;
+            }
+        }
+
+        Result res = pSys->MemWriteWord(0, DataAddress);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        pSys->WritePC(HartTestSystem::MemoryAddress);
+        pSys->WriteGPR(10, DataAddress);
+        pSys->WriteGPR(6, m_Counter);
+
+        /* Without blocking waits a spinning hart asks its runner to yield instead of parking. */
+        auto* pHart = pSys->GetHart();
+        pHart->SetBlockingWaitEnabled(false);
+        pHart->ConsumeYieldRequest();
+
+        /* Run the loop. */
+        for(DWord i = 0; i < IterationCount * m_LoopLength; i++) {
+            res = pHart->ExecuteInstAtPc();
+            if(res.IsFailure()) {
+                return res;
+            }
+        }
+
+        /* Check the loop didn't exit early. */
+        if(pSys->ReadPC() >= HartTestSystem::MemoryAddress + m_LoopLength * sizeof(Word)) {
+            return ResultRegValMismatch();
+        }
+
+        if(pHart->ConsumeYieldRequest() != m_SpinExpected) {
+            return ResultValMismatch();
+        }
+
+        return ResultSuccess();
+    }
+private:
+    LoopT m_Loop;
+    DWord m_LoopLength;
+    NativeWord m_Counter;
+    bool m_SpinExpected;
+}; // class TestSpinLoop
+
+constexpr TestFramework g_TestRunner{
+    &HartTestSystem::DefaultReset,
+
+    std::tuple{
+        /* Test a loop polling memory that never changes is spinning. */
+        TestSpinLoop{
+            "PollLoop",
+            {
+                LoadData,
+                cpu::EncodeBTypeInstruction(cpu::Opcode::BRANCH, cpu::Function::BEQ, 5, 0, static_cast<Word>(-4))
+            },
+            2,
+            0,
+            true
+        },
+
+        /* Test a bounded poll loop isn't spinning, it counts down t1 while loading the same value. */
+        TestSpinLoop{
+            "CountedPollLoop",
+            {
+                LoadData,
+                DecrementCounter,
+                cpu::EncodeBTypeInstruction(cpu::Opcode::BRANCH, cpu::Function::BNE, 6, 0, static_cast<Word>(-8))
+            },
+            3,
+            IterationCount * 2,
+            false
+        },
+
+        /* Test a delay loop isn't spinning. */
+        TestSpinLoop{
+            "CountedDelayLoop",
+            {
+                DecrementCounter,
+                cpu::EncodeBTypeInstruction(cpu::Opcode::BRANCH, cpu::Function::BNE, 6, 0, static_cast<Word>(-4))
+            },
+            2,
+            IterationCount * 2,
+            false
+        },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args arg) {
+    HartTestSystem sys;
+
+    sys.Initialize();
+
+    return g_TestRunner.RunAll(&sys);
+}
+
+} // namespace test
+} // namespace riscv
@@ -0,0 +1,81 @@
+#include <RiscvEmu/hw/hw_Scheduler.h>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+
+using namespace riscv;
+
+namespace {
+
+class CountingDevice : public hw::IDevice {
+public:
+    CountingDevice(DWordS freq) noexcept :
+        IDevice(freq) {}
+
+    Result ProcessCycle() override {
+        m_Count++;
+        return ResultSuccess();
+    }
+
+    DWord GetCount() const noexcept { return m_Count; }
+private:
+    DWord m_Count = 0;
+}; // class CountingDevice
+
+void RunScheduler(std::size_t deviceCount, DWord tickCount) {
+    /* Give devices a spread of frequencies, like per-core timers, watchdogs and DMA channels would have. */
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(deviceCount));
+    std::uniform_int_distribution<DWordS> freqDist(1'000, 100'000);
+
+    auto pDevices = std::make_unique<std::unique_ptr<CountingDevice>[]>(deviceCount);
+    hw::DeviceScheduler scheduler;
+    for(std::size_t i = 0; i < deviceCount; i++) {
+        pDevices[i] = std::make_unique<CountingDevice>(freqDist(rng));
+        scheduler.AddDevice(pDevices[i].get());
+    }
+
+    /* Time processing deadlines. */
+    auto start = std::chrono::steady_clock::now();
+    hw::DeviceScheduler::SchdResult res = scheduler.Advance(tickCount);
+    auto advanceTime = std::chrono::steady_clock::now() - start;
+    if(res.IsFailure()) {
+        std::cout << "Advance failed" << std::endl;
+        return;
+    }
+
+    DWord processed = 0;
+    for(std::size_t i = 0; i < deviceCount; i++) {
+        processed += pDevices[i]->GetCount();
+    }
+
+    /* Time rescheduling random devices, e.g. devices woken by guest accesses. */
+    constexpr DWord RescheduleCount = 1'000'000;
+    std::uniform_int_distribution<std::size_t> devDist(0, deviceCount - 1);
+    std::uniform_int_distribution<DWord> tickDist(0, hw::DeviceScheduler::TickFreq);
+    start = std::chrono::steady_clock::now();
+    for(DWord i = 0; i < RescheduleCount; i++) {
+        scheduler.ScheduleDevice(pDevices[devDist(rng)].get(), scheduler.GetTime() + tickDist(rng));
+    }
+    auto rescheduleTime = std::chrono::steady_clock::now() - start;
+
+    auto nsPer = [](auto time, DWord count) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()) / static_cast<double>(count);
+    };
+
+    std::cout << std::format("Devices: {:5} Deadlines: {:10} Advance: {:7.1f}ns/deadline Reschedule: {:7.1f}ns/op",
+        deviceCount, processed, nsPer(advanceTime, std::max<DWord>(processed, 1)), nsPer(rescheduleTime, RescheduleCount)) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    /* Default to one second of virtual time. */
+    DWord tickCount = argc > 1 ? static_cast<DWord>(strtoll(argv[1], nullptr, 10)) : hw::DeviceScheduler::TickFreq;
+
+    for(std::size_t deviceCount : { 10, 100, 1000 }) {
+        RunScheduler(deviceCount, tickCount);
+    }
+}
@@ -0,0 +1,533 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_FuncTestCase.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/test_Result.ext.h>
+#include <RiscvEmu/hw/hw_CoroutineDevice.h>
+#include <RiscvEmu/hw/hw_Scheduler.h>
+#include <algorithm>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+/** A device or completion being processed, identified by the test. */
+struct Event {
+    DWord tick;
+    int id;
+
+    constexpr bool operator==(const Event&) const noexcept = default;
+}; // struct Event
+
+/** Records events in the order they're processed. */
+class EventLog {
+public:
+    void Record(DWord tick, int id) { m_Events.push_back({ tick, id }); }
+
+    void Clear() noexcept { m_Events.clear(); }
+
+    Result Check(std::initializer_list<Event> expected) const {
+        if(!std::equal(m_Events.begin(), m_Events.end(), expected.begin(), expected.end())) {
+            this->Print(expected);
+            return ResultValMismatch();
+        }
+        return ResultSuccess();
+    }
+
+    static Result Reset(EventLog* pLog) {
+        pLog->Clear();
+        return ResultSuccess();
+    }
+private:
+    void Print(std::initializer_list<Event> expected) const {
+        std::cout << "        Expected:";
+        for(const auto& event : expected) {
+            std::cout << std::format(" ({}, {})", event.tick, event.id);
+        }
+        std::cout << "\n        Got:     ";
+        for(const auto& event : m_Events) {
+            std::cout << std::format(" ({}, {})", event.tick, event.id);
+        }
+        std::cout << std::endl;
+    }
+private:
+    std::vector<Event> m_Events;
+}; // class EventLog
+
+using TestCase = FuncTestCase<EventLog>;
+
+Result CheckTime(const hw::DeviceScheduler& scheduler, DWord expected) {
+    if(scheduler.GetTime() != expected) {
+        std::cout << std::format("        Expected time {}, got {}", expected, scheduler.GetTime()) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/** Device logging each cycle at a fixed period, optionally stopping or failing after a number of cycles. */
+class LogDevice : public hw::IDevice {
+public:
+    LogDevice(hw::DeviceScheduler* pScheduler, EventLog* pLog, int id, DWord period, DWord cycleCount = NoDeadline, bool fail = false) noexcept :
+        IDevice(static_cast<DWordS>(hw::DeviceScheduler::TickFreq / period)),
+        m_pScheduler(pScheduler),
+        m_pLog(pLog),
+        m_Id(id),
+        m_CyclesLeft(cycleCount),
+        m_Fail(fail) {}
+
+    Result ProcessCycle() override {
+        m_pLog->Record(m_pScheduler->GetTime(), m_Id);
+        m_CyclesLeft--;
+        if(m_CyclesLeft == 0 && m_Fail) {
+            return ResultValMismatch();
+        }
+        return ResultSuccess();
+    }
+
+    DWord GetNextDeadline([[maybe_unused]] DWord now, DWord periodicTick) const override {
+        return m_CyclesLeft == 0 ? NoDeadline : periodicTick;
+    }
+private:
+    hw::DeviceScheduler* m_pScheduler;
+    EventLog* m_pLog;
+    int m_Id;
+    DWord m_CyclesLeft;
+    bool m_Fail;
+}; // class LogDevice
+
+/** Device whose cycles run on a worker thread, logging the tick each completed cycle was due at. */
+class AsyncLogDevice : public hw::IDevice {
+public:
+    AsyncLogDevice(EventLog* pLog, int id, DWord period) noexcept :
+        IDevice(static_cast<DWordS>(hw::DeviceScheduler::TickFreq / period)),
+        m_pLog(pLog),
+        m_Id(id) {}
+
+    Result ProcessCycle() override {
+        /* Only one cycle runs at a time, the scheduler waits for it before touching these. */
+        m_CycleThread = std::this_thread::get_id();
+        m_CycleCount++;
+        return ResultSuccess();
+    }
+
+    DWord GetNextDeadline(DWord now, DWord periodicTick) const override {
+        /* Called on the scheduler's thread once a cycle completes. */
+        m_pLog->Record(now, m_Id);
+        return periodicTick;
+    }
+
+    ExecPolicy GetExecPolicy() const override { return ExecPolicy::Asynchronous; }
+
+    std::thread::id GetCycleThread() const noexcept { return m_CycleThread; }
+    DWord GetCycleCount() const noexcept { return m_CycleCount; }
+private:
+    EventLog* m_pLog;
+    int m_Id;
+    std::thread::id m_CycleThread;
+    DWord m_CycleCount = 0;
+}; // class AsyncLogDevice
+
+/** Coroutine device logging after each of a list of delays, then returning a result. */
+class DelayDevice : public hw::CoroutineDevice {
+public:
+    DelayDevice(hw::DeviceScheduler* pScheduler, EventLog* pLog, int id, std::initializer_list<DWord> delays, Result result = ResultSuccess()) noexcept :
+        CoroutineDevice(pScheduler),
+        m_pLog(pLog),
+        m_Id(id),
+        m_Delays(delays),
+        m_Result(result) {}
+protected:
+    hw::DeviceTask Run() override {
+        for(DWord delay : m_Delays) {
+            co_await this->Delay(delay);
+            m_pLog->Record(this->GetTime(), m_Id);
+        }
+        co_return m_Result;
+    }
+private:
+    EventLog* m_pLog;
+    int m_Id;
+    std::vector<DWord> m_Delays;
+    Result m_Result;
+}; // class DelayDevice
+
+/** Coroutine device signaling an event after each of a list of delays. */
+class SignalDevice : public hw::CoroutineDevice {
+public:
+    SignalDevice(hw::DeviceScheduler* pScheduler, EventLog* pLog, int id, hw::DeviceEvent* pEvent, std::initializer_list<DWord> delays) noexcept :
+        CoroutineDevice(pScheduler),
+        m_pLog(pLog),
+        m_Id(id),
+        m_pEvent(pEvent),
+        m_Delays(delays) {}
+protected:
+    hw::DeviceTask Run() override {
+        for(DWord delay : m_Delays) {
+            co_await this->Delay(delay);
+            m_pLog->Record(this->GetTime(), m_Id);
+            m_pEvent->Signal();
+        }
+        co_return ResultSuccess();
+    }
+private:
+    EventLog* m_pLog;
+    int m_Id;
+    hw::DeviceEvent* m_pEvent;
+    std::vector<DWord> m_Delays;
+}; // class SignalDevice
+
+/** Coroutine device waiting for an event twice, then again after a delay, logging each wake. */
+class WaitDevice : public hw::CoroutineDevice {
+public:
+    WaitDevice(hw::DeviceScheduler* pScheduler, EventLog* pLog, int id, hw::DeviceEvent* pEvent) noexcept :
+        CoroutineDevice(pScheduler),
+        m_pLog(pLog),
+        m_Id(id),
+        m_pEvent(pEvent) {}
+protected:
+    hw::DeviceTask Run() override {
+        co_await this->WaitFor(*m_pEvent);
+        m_pLog->Record(this->GetTime(), m_Id);
+        co_await this->WaitFor(*m_pEvent);
+        m_pLog->Record(this->GetTime(), m_Id);
+
+        /* The event is signaled while this delays, the wait completes right away. */
+        co_await this->Delay(20);
+        co_await this->WaitFor(*m_pEvent);
+        m_pLog->Record(this->GetTime(), m_Id);
+        co_return ResultSuccess();
+    }
+private:
+    EventLog* m_pLog;
+    int m_Id;
+    hw::DeviceEvent* m_pEvent;
+}; // class WaitDevice
+
+/** Start work logging id in its completion. */
+Result RunLogged(hw::DeviceScheduler* pScheduler, hw::IDevice* pDev, EventLog* pLog, int id, DWord latency) {
+    return pScheduler->RunAsync(pDev, [] { return Result(ResultSuccess()); }, [pScheduler, pLog, id](Result res) {
+        pLog->Record(pScheduler->GetTime(), id);
+        return res;
+    }, latency);
+}
+
+/* Test Advance processes deadlines within [now, now + n) and nothing at now + n. */
+Result TestAdvanceWindow(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    LogDevice dev(&scheduler, pLog, 0, 10);
+    scheduler.AddDevice(&dev);
+
+    /* The first deadline is a period after the device was added, at the end of this window. */
+    scheduler.Advance(10);
+    Result res = pLog->Check({});
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    scheduler.Advance(1);
+    scheduler.Advance(20);
+    res = pLog->Check({ { 10, 0 }, { 20, 0 }, { 30, 0 } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    return CheckTime(scheduler, 31);
+}
+
+/* Test devices of different periods are processed in deadline order. */
+Result TestAdvanceOrder(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    LogDevice devA(&scheduler, pLog, 0, 10);
+    LogDevice devB(&scheduler, pLog, 1, 25);
+    scheduler.AddDevice(&devA);
+    scheduler.AddDevice(&devB);
+
+    scheduler.Advance(46);
+    Result res = pLog->Check({ { 10, 0 }, { 20, 0 }, { 25, 1 }, { 30, 0 }, { 40, 0 } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    return CheckTime(scheduler, 46);
+}
+
+/* Test AdvanceToNextDeadline skips straight to deadlines and stops right after them. */
+Result TestAdvanceToNextDeadline(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    LogDevice dev(&scheduler, pLog, 0, 100, 1);
+    scheduler.AddDevice(&dev);
+
+    /* Process the only deadline, after which the device has none. */
+    scheduler.AdvanceToNextDeadline();
+    Result res = CheckTime(scheduler, 101);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Without deadlines nothing happens, unless a limit is given. */
+    scheduler.AdvanceToNextDeadline();
+    res = CheckTime(scheduler, 101);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    scheduler.AdvanceToNextDeadline(9);
+    res = CheckTime(scheduler, 110);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* A rescheduled device is skipped to, limits stop short of it. */
+    scheduler.ScheduleDevice(&dev, 500);
+    scheduler.AdvanceToNextDeadline(100);
+    res = CheckTime(scheduler, 210);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    scheduler.AdvanceToNextDeadline();
+    res = CheckTime(scheduler, 501);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    return pLog->Check({ { 100, 0 }, { 500, 0 } });
+}
+
+/* Test a device scheduled in the past is processed at the current time. */
+Result TestScheduleInPast(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    LogDevice dev(&scheduler, pLog, 0, 100, 1);
+    scheduler.AddDevice(&dev);
+
+    scheduler.Advance(150);
+    scheduler.ScheduleDevice(&dev, 120);
+    scheduler.Advance(1);
+
+    return pLog->Check({ { 100, 0 }, { 150, 0 } });
+}
+
+/* Test a failing device stops Advance at its deadline and is reported. */
+Result TestAdvanceFailure(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    LogDevice devA(&scheduler, pLog, 0, 10, 2, true);
+    LogDevice devB(&scheduler, pLog, 1, 15);
+    scheduler.AddDevice(&devA);
+    scheduler.AddDevice(&devB);
+
+    auto res = scheduler.Advance(100);
+    if(res.IsSuccess() || res.GetDevice() != &devA) {
+        return ResultValMismatch();
+    }
+
+    Result checkRes = CheckTime(scheduler, 20);
+    if(checkRes.IsFailure()) {
+        return checkRes;
+    }
+
+    return pLog->Check({ { 10, 0 }, { 15, 1 }, { 20, 0 } });
+}
+
+/* Test work runs on a worker thread and its completion on the scheduler's thread, at its latency. */
+Result TestAsyncCompletion(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    scheduler.SetAsyncWorkerCount(2);
+
+    /* The device only owns the work, it isn't due within the test. */
+    LogDevice dev(&scheduler, pLog, 0, 1000, 0);
+    scheduler.AddDevice(&dev);
+
+    const auto mainThread = std::this_thread::get_id();
+    std::thread::id workThread;
+    std::thread::id completionThread;
+    scheduler.RunAsync(&dev, [&workThread] {
+        workThread = std::this_thread::get_id();
+        return Result(ResultSuccess());
+    }, [&scheduler, &completionThread, pLog](Result res) {
+        completionThread = std::this_thread::get_id();
+        pLog->Record(scheduler.GetTime(), 1);
+        return res;
+    }, 10);
+
+    /* Completed work still waits for its tick. */
+    scheduler.WaitForAsync();
+    scheduler.Advance(10);
+    Result res = pLog->Check({});
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    scheduler.Advance(5);
+    res = pLog->Check({ { 10, 1 } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(workThread == mainThread || completionThread != mainThread) {
+        std::cout << "        Work or completion ran on the wrong thread" << std::endl;
+        return ResultValMismatch();
+    }
+
+    return CheckTime(scheduler, 15);
+}
+
+/* Test completions are processed by tick then submission order, before devices due at the same tick. */
+Result TestAsyncOrder(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    LogDevice dev(&scheduler, pLog, 0, 20);
+    scheduler.AddDevice(&dev);
+
+    RunLogged(&scheduler, &dev, pLog, 1, 20);
+    RunLogged(&scheduler, &dev, pLog, 2, 20);
+    RunLogged(&scheduler, &dev, pLog, 3, 10);
+
+    scheduler.Advance(21);
+    return pLog->Check({ { 10, 3 }, { 20, 1 }, { 20, 2 }, { 20, 0 } });
+}
+
+/* Test an asynchronous device runs off the scheduler's thread, one cycle at a time, at its deadlines. */
+Result TestAsyncDevice(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    scheduler.SetAsyncWorkerCount(2);
+
+    AsyncLogDevice dev(pLog, 0, 10);
+    scheduler.AddDevice(&dev);
+
+    /* Wait for each cycle, when its completion is noticed doesn't move the next deadline. */
+    for(int i = 0; i < 3; i++) {
+        scheduler.Advance(i == 0 ? 11 : 10);
+        scheduler.WaitForAsync();
+    }
+    scheduler.Advance(1);
+
+    Result res = pLog->Check({ { 10, 0 }, { 20, 0 }, { 30, 0 } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(dev.GetCycleCount() != 3 || dev.GetCycleThread() == std::this_thread::get_id()) {
+        std::cout << "        Cycles ran on the wrong thread or too often" << std::endl;
+        return ResultValMismatch();
+    }
+
+    scheduler.RemoveDevice(&dev);
+    return ResultSuccess();
+}
+
+/* Test removing a device drops its pending completions only. */
+Result TestAsyncRemove(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    scheduler.SetAsyncWorkerCount(2);
+
+    LogDevice devA(&scheduler, pLog, 0, 1000, 0);
+    LogDevice devB(&scheduler, pLog, 1, 1000, 0);
+    scheduler.AddDevice(&devA);
+    scheduler.AddDevice(&devB);
+
+    RunLogged(&scheduler, &devA, pLog, 0, 10);
+    RunLogged(&scheduler, &devB, pLog, 1, 10);
+    scheduler.RemoveDevice(&devA);
+
+    scheduler.Advance(20);
+    return pLog->Check({ { 10, 1 } });
+}
+
+/* Test a coroutine device resumes at the ticks it delays to, starting on the first tick. */
+Result TestCoroutineDelay(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    DelayDevice dev(&scheduler, pLog, 0, { 10, 0, 5 });
+    scheduler.AddDevice(&dev);
+
+    /* A delay of 0 still moves on to the next tick, a finished device has no deadline. */
+    scheduler.Advance(100);
+    Result res = pLog->Check({ { 11, 0 }, { 12, 0 }, { 17, 0 } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(scheduler.GetNextDeadline() != hw::DeviceScheduler::NoDeadline) {
+        return ResultValMismatch();
+    }
+    return CheckTime(scheduler, 100);
+}
+
+/* Test a coroutine device's returned failure stops the scheduler at the tick it returned at. */
+Result TestCoroutineFailure(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    DelayDevice dev(&scheduler, pLog, 0, { 5 }, ResultValMismatch());
+    scheduler.AddDevice(&dev);
+
+    auto res = scheduler.Advance(100);
+    if(res.IsSuccess() || res.GetDevice() != &dev) {
+        return ResultValMismatch();
+    }
+
+    return CheckTime(scheduler, 6);
+}
+
+/* Test a waiting device resumes at the tick it's signaled at, and consumes signals sent before it waits. */
+Result TestCoroutineEvent(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    hw::DeviceEvent event;
+    WaitDevice waiter(&scheduler, pLog, 0, &event);
+    SignalDevice signaler(&scheduler, pLog, 1, &event, { 20, 10, 10 });
+    scheduler.AddDevice(&waiter);
+    scheduler.AddDevice(&signaler);
+
+    scheduler.Advance(100);
+    Result res = pLog->Check({ { 21, 1 }, { 21, 0 }, { 31, 1 }, { 31, 0 }, { 41, 1 }, { 51, 0 } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(event.IsSignaled()) {
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test two coroutine devices interleave by their resume ticks. */
+Result TestCoroutineInterleave(EventLog* pLog) {
+    hw::DeviceScheduler scheduler;
+    DelayDevice devA(&scheduler, pLog, 0, { 10, 10, 10 });
+    DelayDevice devB(&scheduler, pLog, 1, { 7, 7, 7 });
+    scheduler.AddDevice(&devA);
+    scheduler.AddDevice(&devB);
+
+    scheduler.Advance(100);
+    return pLog->Check({ { 8, 1 }, { 11, 0 }, { 15, 1 }, { 21, 0 }, { 22, 1 }, { 31, 0 } });
+}
+
+constexpr TestFramework g_TestRunner{
+    &EventLog::Reset,
+
+    std::tuple{
+        TestCase{ "AdvanceWindow", &TestAdvanceWindow },
+        TestCase{ "AdvanceOrder", &TestAdvanceOrder },
+        TestCase{ "AdvanceToNextDeadline", &TestAdvanceToNextDeadline },
+        TestCase{ "ScheduleInPast", &TestScheduleInPast },
+        TestCase{ "AdvanceFailure", &TestAdvanceFailure },
+        TestCase{ "AsyncCompletion", &TestAsyncCompletion },
+        TestCase{ "AsyncOrder", &TestAsyncOrder },
+        TestCase{ "AsyncDevice", &TestAsyncDevice },
+        TestCase{ "AsyncRemove", &TestAsyncRemove },
+        TestCase{ "CoroutineDelay", &TestCoroutineDelay },
+        TestCase{ "CoroutineFailure", &TestCoroutineFailure },
+        TestCase{ "CoroutineEvent", &TestCoroutineEvent },
+        TestCase{ "CoroutineInterleave", &TestCoroutineInterleave },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args arg) {
+    EventLog log;
+
+    return g_TestRunner.RunAll(&log);
+}
+
+} // namespace test
+} // namespace riscv
@@ -0,0 +1,458 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_FuncTestCase.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/test_Result.ext.h>
+#include <RiscvEmu/hw/hw_Scheduler.h>
+#include <RiscvEmu/intrpt/intrpt_CLINT.h>
+#include <RiscvEmu/mem/mem_Result.h>
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+constexpr Word HartCount = 2;
+
+/* Register offsets, as laid out in the CLINT's address space. */
+constexpr Address SoftwarePendingReg(Word hartId) { return hartId * sizeof(Word); }
+constexpr Address TimeCompareReg(Word hartId) { return 0x4000 + hartId * sizeof(DWord); }
+constexpr Address TimeReg = 0xBFF8;
+
+/* mtime counts 10 per scheduler tick at the default timebase frequency. */
+constexpr DWord TimePerTick = intrpt::CLINT::DefaultTimebaseFreq / hw::DeviceScheduler::TickFreq;
+
+struct Notification {
+    bool isTimer;
+    Word hartId;
+    bool pending;
+
+    constexpr bool operator==(const Notification&) const = default;
+}; // struct Notification
+
+/** Target recording every interrupt line change in order. */
+class RecordingTarget : public intrpt::CLINT::IHartTarget {
+public:
+    void NotifyTimerInterrupt(Word hartId, bool pending) override { m_Notifications.push_back({ true, hartId, pending }); }
+    void NotifySoftwareInterrupt(Word hartId, bool pending) override { m_Notifications.push_back({ false, hartId, pending }); }
+
+    /** Check the changes since the last call, in order. */
+    Result Check(std::initializer_list<Notification> expected) {
+        bool match = std::equal(m_Notifications.begin(), m_Notifications.end(), expected.begin(), expected.end());
+        if(!match) {
+            std::cout << std::format("        Got {} notifications, expected {}", m_Notifications.size(), expected.size()) << std::endl;
+            for(const auto& n : m_Notifications) {
+                std::cout << std::format("            {} hart {} pending {}", n.isTimer ? "Timer" : "Software", n.hartId, n.pending ? 1 : 0) << std::endl;
+            }
+        }
+
+        m_Notifications.clear();
+        return match ? Result(ResultSuccess()) : Result(ResultValMismatch());
+    }
+
+    void Clear() noexcept { m_Notifications.clear(); }
+private:
+    std::vector<Notification> m_Notifications;
+}; // class RecordingTarget
+
+struct ClintTestSystem {
+    std::unique_ptr<hw::DeviceScheduler> pScheduler;
+    std::unique_ptr<intrpt::CLINT> pClint;
+    RecordingTarget target;
+}; // struct ClintTestSystem
+
+using TestCase = FuncTestCase<ClintTestSystem>;
+
+/** Each test gets a fresh CLINT on a fresh scheduler, at virtual time 0. */
+Result ResetClint(ClintTestSystem* pSys) {
+    /* The CLINT removes its timer from the scheduler, so it goes first. */
+    pSys->pClint.reset();
+    pSys->pScheduler = std::make_unique<hw::DeviceScheduler>();
+    pSys->pClint = std::make_unique<intrpt::CLINT>();
+    pSys->target.Clear();
+
+    Result res = pSys->pClint->Initialize(HartCount, pSys->pScheduler.get());
+    if(res.IsFailure()) {
+        return res;
+    }
+    pSys->pClint->SetTarget(&pSys->target);
+    return ResultSuccess();
+}
+
+Result CheckReg(intrpt::CLINT* pClint, Address addr, DWord expected) {
+    DWord val = 0;
+    Result res = pClint->ReadDWord(&val, addr);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(val != expected) {
+        std::cout << std::format("        Register {:#x}: expected {}, got {}", addr, expected, val) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+Result CheckWordReg(intrpt::CLINT* pClint, Address addr, Word expected) {
+    Word val = 0;
+    Result res = pClint->ReadWord(&val, addr);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(val != expected) {
+        std::cout << std::format("        Register word {:#x}: expected {}, got {}", addr, expected, val) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+Result CheckTimerPending(intrpt::CLINT* pClint, Word hartId, bool expected) {
+    if(pClint->IsTimerPending(hartId) != expected) {
+        std::cout << std::format("        Hart {} timer pending {}, expected {}", hartId, expected ? 0 : 1, expected ? 1 : 0) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test mtime is derived from virtual time, and writes to it or its halves offset it. */
+Result TestTimeDerivation(ClintTestSystem* pSys) {
+    auto* pClint = pSys->pClint.get();
+    Result res = CheckReg(pClint, TimeReg, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* A CLINT with a different timebase, which is left alone. */
+    intrpt::CLINT slowClint;
+    res = slowClint.Initialize(1, pSys->pScheduler.get(), hw::DeviceScheduler::TickFreq * 3 / 2);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* mtime isn't a counter, it follows the scheduler. */
+    res = pSys->pScheduler->Advance(123);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckReg(pClint, TimeReg, 123 * TimePerTick);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Writes move mtime, it keeps following virtual time from there. */
+    res = pClint->WriteDWord(5000, TimeReg);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->pScheduler->Advance(10);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckReg(pClint, TimeReg, 5000 + 10 * TimePerTick);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Word writes replace their half only, reads see each half. */
+    res = pClint->WriteWord(1, TimeReg + sizeof(Word));
+    if(res.IsFailure()) {
+        return res;
+    }
+    constexpr DWord Expected = (DWord{ 1 } << 32) + 5000 + 10 * TimePerTick;
+    res = CheckReg(pClint, TimeReg, Expected);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWordReg(pClint, TimeReg, static_cast<Word>(Expected));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWordReg(pClint, TimeReg + sizeof(Word), 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* The other timebase counted at its own rate, rounding down. */
+    res = pSys->pScheduler->Advance(3);
+    if(res.IsFailure()) {
+        return res;
+    }
+    return CheckReg(&slowClint, TimeReg, 136 * 3 / 2);
+}
+
+/* Test mtimecmp's halves are written separately, and only raise the timer once the whole value is reached. */
+Result TestTimeCompareHalves(ClintTestSystem* pSys) {
+    auto* pClint = pSys->pClint.get();
+
+    /* mtimecmp starts at its maximum, so no timer is pending. */
+    Result res = CheckReg(pClint, TimeCompareReg(0), ~DWord{ 0 });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Writing the low half first leaves the high half at its maximum, still far in the future. */
+    res = pClint->WriteWord(100, TimeCompareReg(0));
+    if(res.IsFailure()) {
+        return res;
+    }
+    constexpr DWord LowHalfWritten = 0xFFFFFFFF'00000064;
+    res = CheckReg(pClint, TimeCompareReg(0), LowHalfWritten);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pSys->pScheduler->GetNextDeadline() != LowHalfWritten / TimePerTick) {
+        std::cout << std::format("        Deadline {}", pSys->pScheduler->GetNextDeadline()) << std::endl;
+        return ResultValMismatch();
+    }
+
+    res = pClint->WriteWord(0, TimeCompareReg(0) + sizeof(Word));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWordReg(pClint, TimeCompareReg(0), 100);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWordReg(pClint, TimeCompareReg(0) + sizeof(Word), 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* The other hart's mtimecmp is untouched. */
+    res = CheckReg(pClint, TimeCompareReg(1), ~DWord{ 0 });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Nothing is pending yet, but the deadline is scheduled. */
+    if(pSys->pScheduler->GetNextDeadline() != 100 / TimePerTick) {
+        std::cout << std::format("        Deadline {}", pSys->pScheduler->GetNextDeadline()) << std::endl;
+        return ResultValMismatch();
+    }
+    return pSys->target.Check({});
+}
+
+/* Test the timer fires at exactly the first tick mtime reaches mtimecmp at. */
+Result TestFiresAtDeadline(ClintTestSystem* pSys) {
+    auto* pClint = pSys->pClint.get();
+
+    /* 1005 isn't a whole tick, mtime passes it at tick 101. */
+    constexpr DWord TimeCompare = 1005;
+    constexpr DWord Deadline = 101;
+    Result res = pClint->WriteDWord(TimeCompare, TimeCompareReg(0));
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pSys->pScheduler->GetNextDeadline() != Deadline) {
+        std::cout << std::format("        Deadline {}", pSys->pScheduler->GetNextDeadline()) << std::endl;
+        return ResultValMismatch();
+    }
+
+    /* Up to and including tick 100 mtime is below mtimecmp. */
+    res = pSys->pScheduler->Advance(Deadline);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckTimerPending(pClint, 0, false);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({});
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Processing tick 101 raises it, for hart 0 only. */
+    res = pSys->pScheduler->Advance(1);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckTimerPending(pClint, 0, true);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckTimerPending(pClint, 1, false);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { true, 0, true } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* It stays pending without further notifications, and nothing else is scheduled. */
+    res = pSys->pScheduler->Advance(1000);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckTimerPending(pClint, 0, true);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pSys->pScheduler->GetNextDeadline() != hw::DeviceScheduler::NoDeadline) {
+        std::cout << std::format("        Deadline {}", pSys->pScheduler->GetNextDeadline()) << std::endl;
+        return ResultValMismatch();
+    }
+    return pSys->target.Check({});
+}
+
+/* Test rewriting mtimecmp or mtime clears and rearms the timer. */
+Result TestRearm(ClintTestSystem* pSys) {
+    auto* pClint = pSys->pClint.get();
+
+    /* mtimecmp at or below mtime is pending right away. */
+    Result res = pSys->pScheduler->Advance(10);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pClint->WriteDWord(10 * TimePerTick, TimeCompareReg(1));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { true, 1, true } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Moving mtimecmp ahead clears it and arms the timer again. */
+    res = pClint->WriteDWord(20 * TimePerTick, TimeCompareReg(1));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { true, 1, false } });
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->pScheduler->Advance(11);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { true, 1, true } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Moving mtime back clears it, and the deadline moves with mtime. */
+    res = pClint->WriteDWord(0, TimeReg);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { true, 1, false } });
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pSys->pScheduler->GetNextDeadline() != pSys->pScheduler->GetTime() + 20) {
+        std::cout << std::format("        Deadline {} at {}", pSys->pScheduler->GetNextDeadline(), pSys->pScheduler->GetTime()) << std::endl;
+        return ResultValMismatch();
+    }
+
+    /* Moving mtime to mtimecmp raises it without waiting for the scheduler. */
+    res = pClint->WriteDWord(20 * TimePerTick, TimeReg);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { true, 1, true } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* The stale deadline left in the scheduler finds nothing to do. */
+    res = pSys->pScheduler->Advance(100);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckTimerPending(pClint, 0, false);
+    if(res.IsFailure()) {
+        return res;
+    }
+    return pSys->target.Check({});
+}
+
+/* Test msip notifies changes of bit 0 only, and registers past the last hart are unused. */
+Result TestSoftwareInterrupt(ClintTestSystem* pSys) {
+    auto* pClint = pSys->pClint.get();
+    Result res = pClint->WriteWord(1, SoftwarePendingReg(1));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWordReg(pClint, SoftwarePendingReg(1), 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Rewriting the same value or other bits changes nothing. */
+    res = pClint->WriteWord(0b11, SoftwarePendingReg(1));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { false, 1, true } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    res = pClint->WriteWord(0b10, SoftwarePendingReg(1));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWordReg(pClint, SoftwarePendingReg(1), 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->target.Check({ { false, 1, false } });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Unused registers read as zero and ignore writes. */
+    res = pClint->WriteWord(1, SoftwarePendingReg(HartCount));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWordReg(pClint, SoftwarePendingReg(HartCount), 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pClint->WriteDWord(0, TimeCompareReg(HartCount));
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckReg(pClint, TimeCompareReg(HartCount), 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Misaligned accesses fault. */
+    DWord val = 0;
+    if(!mem::ResultBadMisalignedAddress().Includes(pClint->ReadDWord(&val, TimeReg + sizeof(Word)))) {
+        return ResultValMismatch();
+    }
+    if(!mem::ResultBadMisalignedAddress().Includes(pClint->WriteWord(1, SoftwarePendingReg(0) + 2))) {
+        return ResultValMismatch();
+    }
+    return pSys->target.Check({});
+}
+
+constexpr TestFramework g_TestRunner{
+    &ResetClint,
+
+    std::tuple{
+        TestCase{ "TimeDerivation", &TestTimeDerivation },
+        TestCase{ "TimeCompareHalves", &TestTimeCompareHalves },
+        TestCase{ "FiresAtDeadline", &TestFiresAtDeadline },
+        TestCase{ "Rearm", &TestRearm },
+        TestCase{ "SoftwareInterrupt", &TestSoftwareInterrupt },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args arg) {
+    ClintTestSystem sys;
+
+    return g_TestRunner.RunAll(&sys);
+}
+
+} // namespace test
+} // namespace riscv
@@ -0,0 +1,367 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_FuncTestCase.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/test_Result.ext.h>
+#include <RiscvEmu/intrpt/intrpt_PLIC.h>
+#include <RiscvEmu/mem/mem_Result.h>
+#include <array>
+#include <memory>
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+constexpr int SourceCount = 8;
+constexpr int TargetCount = 2;
+
+/* Register word indices, as laid out in the PLIC's address space. */
+constexpr Word RegSize = sizeof(Word);
+constexpr Word PriorityReg(Word source) { return source; }
+constexpr Word EnabledReg(Word target, Word word) { return 0x2000 / RegSize + target * 32 + word; }
+constexpr Word ThresholdReg(Word target) { return 0x200000 / RegSize + target * (0x1000 / RegSize); }
+constexpr Word ClaimReg(Word target) { return ThresholdReg(target) + 1; }
+
+/** Target counting how often the PLIC notified it. */
+class CountingTarget : public intrpt::ITarget {
+public:
+    Result NotifyAvailableIRQ() override {
+        m_NotifyCount++;
+        return ResultSuccess();
+    }
+
+    int GetNotifyCount() const noexcept { return m_NotifyCount; }
+private:
+    int m_NotifyCount = 0;
+}; // class CountingTarget
+
+struct PlicTestSystem {
+    std::unique_ptr<intrpt::PLIC> pPlic;
+    std::array<std::shared_ptr<CountingTarget>, TargetCount> targets;
+    std::array<intrpt::ISource*, SourceCount> sources;
+}; // struct PlicTestSystem
+
+using TestCase = FuncTestCase<PlicTestSystem>;
+
+/** Each test gets a fresh PLIC with every source and target registered. */
+Result ResetPlic(PlicTestSystem* pSys) {
+    pSys->pPlic = std::make_unique<intrpt::PLIC>();
+    Result res = pSys->pPlic->Initialize(SourceCount, TargetCount);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    for(Word i = 0; i < TargetCount; i++) {
+        pSys->targets[i] = std::make_shared<CountingTarget>();
+        res = pSys->pPlic->RegisterTarget(pSys->targets[i], i);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    for(Word i = 0; i < SourceCount; i++) {
+        res = pSys->pPlic->RegisterSource(&pSys->sources[i], i);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    return ResultSuccess();
+}
+
+Result CheckReg(intrpt::PLIC* pPlic, Word index, Word expected) {
+    Word val = pPlic->ReadRegister(index);
+    if(val != expected) {
+        std::cout << std::format("        Register {:#x}: expected {}, got {}", index * RegSize, expected, val) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+Result CheckNotifyCount(const PlicTestSystem* pSys, Word target, int expected) {
+    int count = pSys->targets[target]->GetNotifyCount();
+    if(count != expected) {
+        std::cout << std::format("        Target {} notified {} times, expected {}", target, count, expected) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/** Claim from a target, checking the claimed source. */
+Result CheckClaim(intrpt::PLIC* pPlic, Word target, Word expected) {
+    return CheckReg(pPlic, ClaimReg(target), expected);
+}
+
+/* Test claims come highest priority first, and a source is claimable again only once completed. */
+Result TestClaimByPriority(PlicTestSystem* pSys) {
+    auto* pPlic = pSys->pPlic.get();
+    pPlic->WriteRegister(PriorityReg(1), 1);
+    pPlic->WriteRegister(PriorityReg(2), 3);
+    pPlic->WriteRegister(PriorityReg(3), 2);
+    pPlic->WriteRegister(PriorityReg(4), 3);
+
+    /* Nothing is enabled yet, so nothing is notified. */
+    for(Word src = 1; src <= 4; src++) {
+        Result res = pSys->sources[src]->SignalInterrupt();
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+    Result res = CheckNotifyCount(pSys, 0, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Enabling pending sources notifies the target. */
+    pPlic->WriteRegister(EnabledReg(0, 0), 0b11110);
+    res = CheckNotifyCount(pSys, 0, 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Within a priority the lowest source id wins. */
+    res = CheckClaim(pPlic, 0, 2);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Signal the claimed source again, it stays pending but isn't claimable until completed. */
+    res = pSys->sources[2]->SignalInterrupt();
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(!pPlic->GetPending(2)) {
+        return ResultValMismatch();
+    }
+
+    for(Word expected : { 4, 3, 1, 0 }) {
+        res = CheckClaim(pPlic, 0, expected);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    /* Completing source 2 makes its second request claimable. */
+    pPlic->WriteRegister(ClaimReg(0), 2);
+    res = CheckClaim(pPlic, 0, 2);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pPlic->GetPending(2)) {
+        return ResultValMismatch();
+    }
+
+    /* Target 1 has nothing enabled. */
+    res = CheckNotifyCount(pSys, 1, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+    return CheckClaim(pPlic, 1, 0);
+}
+
+/* Test only sources above a target's threshold can be claimed by it. */
+Result TestThresholdMasking(PlicTestSystem* pSys) {
+    auto* pPlic = pSys->pPlic.get();
+    pPlic->WriteRegister(PriorityReg(1), 1);
+    pPlic->WriteRegister(PriorityReg(2), 2);
+    pPlic->WriteRegister(PriorityReg(3), 3);
+    pPlic->WriteRegister(EnabledReg(0, 0), 0b1110);
+    pPlic->WriteRegister(EnabledReg(1, 0), 0b1110);
+
+    /* Thresholds are clamped to the highest priority. */
+    pPlic->WriteRegister(ThresholdReg(0), 100);
+    Result res = CheckReg(pPlic, ThresholdReg(0), intrpt::PLIC::MaxPriority);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    pPlic->WriteRegister(ThresholdReg(0), 2);
+    pPlic->WriteRegister(ThresholdReg(1), 3);
+    res = CheckReg(pPlic, ThresholdReg(0), 2);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    for(Word src = 1; src <= 3; src++) {
+        res = pSys->sources[src]->SignalInterrupt();
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    /* Target 1's threshold masks every source, target 0 only sees source 3. */
+    res = CheckNotifyCount(pSys, 1, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckClaim(pPlic, 1, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckClaim(pPlic, 0, 3);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckClaim(pPlic, 0, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Lowering the threshold notifies target 1 of what it can now claim. */
+    pPlic->WriteRegister(ThresholdReg(1), 0);
+    res = CheckNotifyCount(pSys, 1, 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    for(Word expected : { 2, 1, 0 }) {
+        res = CheckClaim(pPlic, 1, expected);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+    return ResultSuccess();
+}
+
+/* Test contexts and enable words past the last target read as zero and ignore writes. */
+Result TestOutOfRangeContext(PlicTestSystem* pSys) {
+    auto* pPlic = pSys->pPlic.get();
+    pPlic->WriteRegister(PriorityReg(1), 1);
+    pPlic->WriteRegister(ThresholdReg(0), 0);
+    Result res = pSys->sources[1]->SignalInterrupt();
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    for(Word target : { Word{ TargetCount }, Word{ TargetCount + 1 }, Word{ 15000 } }) {
+        /* Writes are ignored and notify nobody. */
+        pPlic->WriteRegister(EnabledReg(target, 0), ~Word{ 0 });
+        pPlic->WriteRegister(ThresholdReg(target), 5);
+        pPlic->WriteRegister(ClaimReg(target), 1);
+
+        /* Reads are zero, claiming takes nothing. */
+        for(Word index : { EnabledReg(target, 0), ThresholdReg(target), ClaimReg(target) }) {
+            res = CheckReg(pPlic, index, 0);
+            if(res.IsFailure()) {
+                return res;
+            }
+        }
+    }
+
+    /* Enable words past the source count of a valid target too. */
+    pPlic->WriteRegister(EnabledReg(0, 5), ~Word{ 0 });
+    res = CheckReg(pPlic, EnabledReg(0, 5), 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    for(Word target = 0; target < TargetCount; target++) {
+        res = CheckNotifyCount(pSys, target, 0);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    /* The real targets are untouched, and the request is still there to claim. */
+    res = CheckReg(pPlic, ThresholdReg(1), 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+    pPlic->WriteRegister(EnabledReg(0, 0), 0b10);
+    res = CheckNotifyCount(pSys, 0, 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+    return CheckClaim(pPlic, 0, 1);
+}
+
+/* Test guest accesses through the MMIO device reach the registers at their byte offsets, and must be aligned. */
+Result TestMmioInterface(PlicTestSystem* pSys) {
+    auto* pPlic = pSys->pPlic.get();
+    mem::IMmioDev* pMmio = pPlic->GetMmioDevice();
+
+    /* Writes land in the register their byte offset names. */
+    Result res = pMmio->WriteWord(2, PriorityReg(3) * RegSize);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckReg(pPlic, PriorityReg(3), 2);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckReg(pPlic, PriorityReg(0), 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    res = pMmio->WriteWord(0b1000, EnabledReg(1, 0) * RegSize);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pSys->sources[3]->SignalInterrupt();
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckNotifyCount(pSys, 1, 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Reads do too, claiming and completing through the claim register. */
+    Word val = 0;
+    res = pMmio->ReadWord(&val, PriorityReg(3) * RegSize);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(val != 2) {
+        std::cout << std::format("        Priority read {}", val) << std::endl;
+        return ResultValMismatch();
+    }
+
+    res = pMmio->ReadWord(&val, ClaimReg(1) * RegSize);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(val != 3) {
+        std::cout << std::format("        Claimed {}", val) << std::endl;
+        return ResultValMismatch();
+    }
+    res = pMmio->WriteWord(3, ClaimReg(1) * RegSize);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pPlic->GetPending(3)) {
+        return ResultValMismatch();
+    }
+
+    /* Misaligned accesses fault without touching any register. */
+    if(!mem::ResultBadMisalignedAddress().Includes(pMmio->WriteWord(1, PriorityReg(3) * RegSize + 1))) {
+        return ResultValMismatch();
+    }
+    if(!mem::ResultBadMisalignedAddress().Includes(pMmio->ReadWord(&val, ClaimReg(1) * RegSize + 2))) {
+        return ResultValMismatch();
+    }
+    return CheckReg(pPlic, PriorityReg(3), 2);
+}
+
+constexpr TestFramework g_TestRunner{
+    &ResetPlic,
+
+    std::tuple{
+        TestCase{ "ClaimByPriority", &TestClaimByPriority },
+        TestCase{ "ThresholdMasking", &TestThresholdMasking },
+        TestCase{ "OutOfRangeContext", &TestOutOfRangeContext },
+        TestCase{ "MmioInterface", &TestMmioInterface },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args arg) {
+    PlicTestSystem sys;
+
+    return g_TestRunner.RunAll(&sys);
+}
+
+} // namespace test
+} // namespace riscv
@@ -0,0 +1,587 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_FuncTestCase.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/test_Result.ext.h>
+#include <RiscvEmu/mem/mem_MemoryController.h>
+#include <RiscvEmu/mem/mem_MemoryDevice.h>
+#include <RiscvEmu/mem/mem_RegionInfo.h>
+#include <RiscvEmu/mem/mem_RomDevice.h>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+constexpr Address IoAddress = 0;
+constexpr NativeWord IoSize = 0x10000;
+constexpr Address DeviceAddress = 0x1000;
+constexpr NativeWord DeviceSize = 0x1000;
+
+constexpr Address MemoryAddress = 0x80000000;
+constexpr NativeWord MemorySize = 0x10000;
+constexpr Address MemoryEnd = MemoryAddress + MemorySize;
+
+/* The IO region starts at 0, so device addresses are the same relative to it. */
+constexpr std::array Regions{
+    mem::RegionInfo(IoAddress, IoSize, mem::RegionType::IO),
+    mem::RegionInfo(MemoryAddress, MemorySize, mem::RegionType::Memory)
+};
+
+/** Memory controller, along with the devices attached to it which it doesn't own. */
+struct MemTestSystem {
+    std::unique_ptr<mem::MemoryController> pMemCtlr;
+    std::vector<std::unique_ptr<mem::IMmioDev>> devices;
+}; // struct MemTestSystem
+
+using TestCase = FuncTestCase<MemTestSystem>;
+
+/** Each test gets a fresh, uninitialized memory controller. */
+Result ResetMemCtlr(MemTestSystem* pSys) {
+    pSys->pMemCtlr = std::make_unique<mem::MemoryController>();
+    pSys->devices.clear();
+    return ResultSuccess();
+}
+
+/** Initialize the default memory map, with a MemoryDevice at DeviceAddress. */
+Result InitializeDefault(MemTestSystem* pSys) {
+    Result res = pSys->pMemCtlr->Initialize(Regions.data(), Regions.size());
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    pSys->devices.push_back(std::make_unique<mem::MemoryDevice>(DeviceSize));
+    return pSys->pMemCtlr->AddMmioDev(pSys->devices.back().get(), DeviceAddress);
+}
+
+/** Temporary file removed once the test is done with it. */
+class TempFile {
+public:
+    explicit TempFile(const char* pName) :
+        m_Path(std::filesystem::temp_directory_path() / pName) {}
+
+    ~TempFile() {
+        std::error_code ec;
+        std::filesystem::remove(m_Path, ec);
+    }
+
+    const char* GetPath() const noexcept { return m_Path.c_str(); }
+
+    void Write(std::span<const Byte> data) const {
+        std::ofstream file(m_Path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::vector<Byte> Read() const {
+        std::ifstream file(m_Path, std::ios::binary);
+        return std::vector<Byte>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+private:
+    std::filesystem::path m_Path;
+}; // class TempFile
+
+/** File contents shorter than the regions mapped from it, each byte holds its offset. */
+constexpr NativeWord FileSize = 0x1800;
+constexpr NativeWord FileRegionSize = 0x4000;
+
+std::vector<Byte> MakeFileImage() {
+    std::vector<Byte> image(FileSize);
+    for(std::size_t i = 0; i < image.size(); i++) {
+        image[i] = static_cast<Byte>(i);
+    }
+    return image;
+}
+
+/** Initialize main memory mapped from a file. */
+Result InitializeFromFile(MemTestSystem* pSys, const TempFile& file, mem::FileMapMode mode) {
+    const std::array regions{ mem::RegionInfo(MemoryAddress, FileRegionSize, file.GetPath(), mode) };
+    return pSys->pMemCtlr->Initialize(regions.data(), regions.size());
+}
+
+/** Check a word of memory. */
+Result CheckWord(mem::MemoryController* pMemCtlr, Address addr, Word expected) {
+    Word val = 0;
+    Result res = pMemCtlr->ReadWord(&val, addr);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(val != expected) {
+        std::cout << std::format("        Word at {:#x}: expected {:#x}, got {:#x}", addr, expected, val) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/** Check a file's contents, expectedWrites are little endian words written over the original image. */
+Result CheckFile(const TempFile& file, std::size_t expectedSize, std::span<const std::pair<NativeWord, Word>> expectedWrites) {
+    auto expected = MakeFileImage();
+    expected.resize(expectedSize);
+    for(auto [offset, val] : expectedWrites) {
+        for(std::size_t i = 0; i < sizeof(Word); i++) {
+            expected[offset + i] = static_cast<Byte>(val >> (i * 8));
+        }
+    }
+
+    auto contents = file.Read();
+    if(contents != expected) {
+        std::cout << std::format("        File contents differ, size {:#x}, expected {:#x}", contents.size(), expected.size()) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/** Check an operation returned the expected result. */
+Result CheckResult(Result res, auto expected) {
+    if(!expected.Includes(res)) {
+        std::cout << std::format("        Unexpected result {:#x}", res.GetValue()) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test host spans cover exactly main memory, and alias it. */
+Result TestHostSpanBounds(MemTestSystem* pSys) {
+    Result res = InitializeDefault(pSys);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    /* The whole of main memory is one span. */
+    std::span<Byte> mem;
+    res = pMemCtlr->GetHostSpan(&mem, MemoryAddress, MemorySize);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(mem.size() != MemorySize) {
+        return ResultValMismatch();
+    }
+
+    /* Writes through the span are seen by guest reads, and the other way around. */
+    mem[0x100] = 0x78;
+    mem[0x101] = 0x56;
+    mem[0x102] = 0x34;
+    mem[0x103] = 0x12;
+    Word val = 0;
+    res = pMemCtlr->ReadWord(&val, MemoryAddress + 0x100);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(val != 0x12345678) {
+        return ResultValMismatch();
+    }
+
+    res = pMemCtlr->WriteByte(0xAB, MemoryEnd - 1);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(mem[MemorySize - 1] != 0xAB) {
+        return ResultValMismatch();
+    }
+
+    /* Ranges reaching outside main memory, wrapping, or in an IO region aren't RAM backed. */
+    struct Range { Address addr; NativeWord len; };
+    for(auto [addr, len] : { Range{ MemoryEnd - 4, 8 }, Range{ MemoryAddress - 4, 8 }, Range{ MemoryEnd, 1 },
+                             Range{ MemoryAddress + 8, ~NativeWord{ 0 } }, Range{ DeviceAddress, 4 } }) {
+        res = CheckResult(pMemCtlr->GetHostSpan(&mem, addr, len), mem::ResultNotRamBacked());
+        if(res.IsFailure()) {
+            std::cout << std::format("        Range {:#x}+{:#x}", addr, len) << std::endl;
+            return res;
+        }
+    }
+
+    /* Nothing is RAM backed without a memory region. */
+    constexpr std::array IoOnly{ mem::RegionInfo(IoAddress, IoSize, mem::RegionType::IO) };
+    res = pMemCtlr->Initialize(IoOnly.data(), IoOnly.size());
+    if(res.IsFailure()) {
+        return res;
+    }
+    return CheckResult(pMemCtlr->GetHostSpan(&mem, MemoryAddress, 4), mem::ResultNotRamBacked());
+}
+
+/* Test exec spans cover main memory, but not devices without a read-only backing. */
+Result TestExecSpanBounds(MemTestSystem* pSys) {
+    Result res = InitializeDefault(pSys);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    std::span<Byte> mem;
+    res = pMemCtlr->GetHostSpan(&mem, MemoryAddress, MemorySize);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Exec spans of main memory point at the same host memory. */
+    std::span<const Byte> exec;
+    res = pMemCtlr->GetExecSpan(&exec, MemoryAddress + 0x200, 0x100);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(exec.data() != mem.data() + 0x200 || exec.size() != 0x100) {
+        return ResultValMismatch();
+    }
+
+    /* A plain MemoryDevice may not be executed in place. */
+    res = CheckResult(pMemCtlr->GetExecSpan(&exec, DeviceAddress, 4), mem::ResultNotRamBacked());
+    if(res.IsFailure()) {
+        return res;
+    }
+    return CheckResult(pMemCtlr->GetExecSpan(&exec, MemoryEnd - 2, 4), mem::ResultNotRamBacked());
+}
+
+/* Test a private file mapping reads the file, zero fills past its end and never writes back. */
+Result TestFilePrivate(MemTestSystem* pSys) {
+    TempFile file("MemTestMemoryController.Private.bin");
+    file.Write(MakeFileImage());
+
+    Result res = InitializeFromFile(pSys, file, mem::FileMapMode::Private);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    for(auto [addr, expected] : { std::pair<Address, Word>{ MemoryAddress, 0x03020100 }, { MemoryAddress + FileSize - 4, 0xFFFEFDFC },
+                                  { MemoryAddress + FileSize, 0 }, { MemoryAddress + FileRegionSize - 4, 0 } }) {
+        res = CheckWord(pMemCtlr, addr, expected);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    /* Writes are only visible to the guest. */
+    res = pMemCtlr->WriteWord(0xDEADBEEF, MemoryAddress);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = pMemCtlr->WriteWord(0xCAFEF00D, MemoryAddress + 0x3000);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckWord(pMemCtlr, MemoryAddress, 0xDEADBEEF);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Unmapping leaves the file as it was. */
+    pSys->pMemCtlr.reset();
+    return CheckFile(file, FileSize, {});
+}
+
+/* Test a shared file mapping extends the file to the region and writes back to it. */
+Result TestFileShared(MemTestSystem* pSys) {
+    TempFile file("MemTestMemoryController.Shared.bin");
+    file.Write(MakeFileImage());
+
+    Result res = InitializeFromFile(pSys, file, mem::FileMapMode::Shared);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    /* The file is extended with zeros up front. */
+    if(file.Read().size() != FileRegionSize) {
+        return ResultValMismatch();
+    }
+    res = CheckWord(pMemCtlr, MemoryAddress + 0x10, 0x13121110);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Writes within the original file and the extension are carried through. */
+    constexpr std::array<std::pair<NativeWord, Word>, 2> Writes{ { { 0x10, 0xDEADBEEF }, { 0x3000, 0xCAFEF00D } } };
+    for(auto [offset, val] : Writes) {
+        res = pMemCtlr->WriteWord(val, MemoryAddress + offset);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    pSys->pMemCtlr.reset();
+    return CheckFile(file, FileRegionSize, Writes);
+}
+
+/* Test a missing file fails without touching the existing memory map. */
+Result TestFileMissing(MemTestSystem* pSys) {
+    Result res = InitializeDefault(pSys);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    res = pMemCtlr->WriteWord(0x12345678, MemoryAddress);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    TempFile file("MemTestMemoryController.Missing.bin");
+    for(auto mode : { mem::FileMapMode::Private, mem::FileMapMode::Shared }) {
+        res = CheckResult(InitializeFromFile(pSys, file, mode), mem::ResultFileOpenFailed());
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    return CheckWord(pMemCtlr, MemoryAddress, 0x12345678);
+}
+
+/* Test accesses reaching past the end of main memory or a device fault instead of running off the host mapping. */
+Result TestAccessAtEnd(MemTestSystem* pSys) {
+    Result res = InitializeDefault(pSys);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    /* The last word of each is accessible. */
+    constexpr Address DeviceEnd = DeviceAddress + DeviceSize;
+    for(Address addr : { MemoryEnd - 4, DeviceEnd - 4 }) {
+        res = pMemCtlr->WriteWord(0x89ABCDEF, addr);
+        if(res.IsFailure()) {
+            return res;
+        }
+        res = CheckWord(pMemCtlr, addr, 0x89ABCDEF);
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+    Word word = 0;
+    res = pMemCtlr->FetchWord(&word, MemoryEnd - 4);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Anything straddling or past the end isn't. */
+    DWord dword = 0;
+    for(Address addr : { MemoryEnd - 2, MemoryEnd, DeviceEnd - 2 }) {
+        if(pMemCtlr->ReadWord(&word, addr).IsSuccess() || pMemCtlr->FetchWord(&word, addr).IsSuccess() ||
+           pMemCtlr->WriteWord(0, addr).IsSuccess()) {
+            std::cout << std::format("        Word access at {:#x} succeeded", addr) << std::endl;
+            return ResultValMismatch();
+        }
+    }
+    for(Address addr : { MemoryEnd - 4, DeviceEnd - 4 }) {
+        if(pMemCtlr->ReadDWord(&dword, addr).IsSuccess() || pMemCtlr->WriteDWord(0, addr).IsSuccess()) {
+            std::cout << std::format("        DWord access at {:#x} succeeded", addr) << std::endl;
+            return ResultValMismatch();
+        }
+    }
+    return ResultSuccess();
+}
+
+/* Test devices may be placed next to each other, but not over each other. */
+Result TestDeviceOverlap(MemTestSystem* pSys) {
+    Result res = InitializeDefault(pSys);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    struct Placement { Address addr; NativeWord len; bool overlaps; };
+    for(auto [addr, len, overlaps] : { Placement{ DeviceAddress - 0x100, 0x100, false }, Placement{ DeviceAddress + DeviceSize, 0x100, false },
+                                       Placement{ DeviceAddress + 0x800, 0x100, true }, Placement{ DeviceAddress - 0x800, 0x1000, true },
+                                       Placement{ DeviceAddress - 0x800, 0x2000, true } }) {
+        pSys->devices.push_back(std::make_unique<mem::MemoryDevice>(len));
+        res = pMemCtlr->AddMmioDev(pSys->devices.back().get(), addr);
+        if(ResultSuccess().Includes(res) == overlaps) {
+            std::cout << std::format("        Device at {:#x}+{:#x}: result {:#x}", addr, len, res.GetValue()) << std::endl;
+            return ResultValMismatch();
+        }
+    }
+    return ResultSuccess();
+}
+
+/* Test fetches from a ROM are served from its backing, until the memory map is replaced. */
+Result TestRomExecInPlace(MemTestSystem* pSys) {
+    Result res = InitializeDefault(pSys);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    /* Place the ROM right after the MemoryDevice. */
+    constexpr Address RomAddress = DeviceAddress + DeviceSize;
+    std::array<Byte, 0x100> image;
+    for(std::size_t i = 0; i < image.size(); i++) {
+        image[i] = static_cast<Byte>(0xFF - i);
+    }
+    pSys->devices.push_back(std::make_unique<mem::RomDevice>(image));
+    res = pMemCtlr->AddMmioDev(pSys->devices.back().get(), RomAddress);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    std::span<const Byte> exec;
+    res = pMemCtlr->GetExecSpan(&exec, RomAddress, image.size());
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(!std::ranges::equal(exec, image)) {
+        return ResultValMismatch();
+    }
+
+    Word word = 0;
+    res = pMemCtlr->FetchWord(&word, RomAddress + 8);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(word != 0xF4F5F6F7) {
+        return ResultValMismatch();
+    }
+
+    /* Fetches straddling the end of the ROM fault, and it can't be written. */
+    res = CheckResult(pMemCtlr->FetchWord(&word, RomAddress + image.size() - 2), mem::ResultReadAccessFault());
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckResult(pMemCtlr->WriteWord(0, RomAddress), mem::ResultWriteAccessFault());
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Replacing the memory map drops the ROM along with its execute in place range. */
+    res = pMemCtlr->Initialize(Regions.data(), Regions.size());
+    if(res.IsFailure()) {
+        return res;
+    }
+    pSys->devices.clear();
+
+    res = CheckResult(pMemCtlr->GetExecSpan(&exec, RomAddress, 4), mem::ResultNotRamBacked());
+    if(res.IsFailure()) {
+        return res;
+    }
+    return CheckResult(pMemCtlr->FetchWord(&word, RomAddress), mem::ResultReadAccessFault());
+}
+
+/** Fetch and clear the dirty page bitmap, checking the pages marked. */
+Result CheckDirtyPages(mem::MemoryController* pMemCtlr, DWord expected) {
+    /* Main memory is 16 pages, a single word. */
+    std::array<DWord, 1> bitmap{};
+    if(pMemCtlr->GetDirtyPageWordCount() != bitmap.size()) {
+        return ResultValMismatch();
+    }
+
+    pMemCtlr->FetchAndClearDirtyPages(bitmap);
+    if(bitmap[0] != expected) {
+        std::cout << std::format("        Dirty pages: expected {:#x}, got {:#x}", expected, bitmap[0]) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test stores mark the pages they touch, straddling stores mark both, and fetching clears the bitmap. */
+Result TestDirtyPages(MemTestSystem* pSys) {
+    Result res = InitializeDefault(pSys);
+    if(res.IsFailure()) {
+        return res;
+    }
+    auto* pMemCtlr = pSys->pMemCtlr.get();
+
+    /* Nothing is tracked until enabled. */
+    res = pMemCtlr->WriteWord(1, MemoryAddress);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pMemCtlr->GetDirtyPageWordCount() != 0) {
+        return ResultValMismatch();
+    }
+
+    pMemCtlr->EnableDirtyPageTracking();
+    res = CheckDirtyPages(pMemCtlr, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Stores of every width, a straddling word and a straddling dword, and loads which mark nothing. */
+    constexpr NativeWord PageSize = 0x1000;
+    res = pMemCtlr->WriteByte(1, MemoryAddress + 0 * PageSize + 5);
+    if(res.IsSuccess()) {
+        res = pMemCtlr->WriteHWord(1, MemoryAddress + 3 * PageSize);
+    }
+    if(res.IsSuccess()) {
+        res = pMemCtlr->WriteWord(1, MemoryAddress + 6 * PageSize - 2);
+    }
+    if(res.IsSuccess()) {
+        res = pMemCtlr->WriteDWord(1, MemoryAddress + 9 * PageSize - 4);
+    }
+    if(res.IsSuccess()) {
+        res = pMemCtlr->WriteDWord(1, MemoryEnd - 8);
+    }
+    if(res.IsFailure()) {
+        return res;
+    }
+    DWord dword = 0;
+    res = pMemCtlr->ReadDWord(&dword, MemoryAddress + 12 * PageSize);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    res = CheckDirtyPages(pMemCtlr, 0b1000'0011'0110'1001);
+    if(res.IsFailure()) {
+        return res;
+    }
+    res = CheckDirtyPages(pMemCtlr, 0);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Stores to devices and faulting stores past the end mark nothing, host span writes are marked explicitly. */
+    res = pMemCtlr->WriteWord(1, DeviceAddress);
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pMemCtlr->WriteDWord(1, MemoryEnd - 4).IsSuccess()) {
+        return ResultValMismatch();
+    }
+    pMemCtlr->MarkDirty(MemoryAddress + 2 * PageSize + 0x10, 0x10);
+    pMemCtlr->MarkDirty(MemoryEnd, 0x10);
+    res = CheckDirtyPages(pMemCtlr, 0b100);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Replacing the memory map resets tracking. */
+    res = pMemCtlr->Initialize(Regions.data(), Regions.size());
+    if(res.IsFailure()) {
+        return res;
+    }
+    if(pMemCtlr->GetDirtyPageWordCount() != 0) {
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+constexpr TestFramework g_TestRunner{
+    &ResetMemCtlr,
+
+    std::tuple{
+        TestCase{ "HostSpanBounds", &TestHostSpanBounds },
+        TestCase{ "ExecSpanBounds", &TestExecSpanBounds },
+        TestCase{ "FilePrivate", &TestFilePrivate },
+        TestCase{ "FileShared", &TestFileShared },
+        TestCase{ "FileMissing", &TestFileMissing },
+        TestCase{ "AccessAtEnd", &TestAccessAtEnd },
+        TestCase{ "DeviceOverlap", &TestDeviceOverlap },
+        TestCase{ "RomExecInPlace", &TestRomExecInPlace },
+        TestCase{ "DirtyPages", &TestDirtyPages },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args arg) {
+    MemTestSystem sys;
+
+    return g_TestRunner.RunAll(&sys);
+}
+
+} // namespace test
+} // namespace riscv
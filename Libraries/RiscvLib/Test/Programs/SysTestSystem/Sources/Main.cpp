@@ -0,0 +1,594 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_FuncTestCase.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/test_Result.ext.h>
+#include <RiscvEmu/riscv_System.h>
+#include <RiscvEmu/cpu/cpu_EncodeInstruction.h>
+#include <RiscvEmu/intrpt/intrpt_CLINT.h>
+#include <RiscvEmu/mem/mem_RegionInfo.h>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+constexpr Address ClintAddress  = 0x2000000;
+constexpr Address MemoryAddress = 0x80000000;
+constexpr NativeWord MemorySize = 0x10000;
+
+/* The IO region starts at 0, so device addresses are the same relative to it. */
+constexpr std::array Regions{
+    mem::RegionInfo(0, ClintAddress + 0x10000, mem::RegionType::IO),
+    mem::RegionInfo(MemoryAddress, MemorySize, mem::RegionType::Memory)
+};
+
+/* nop */
+constexpr Word Nop = cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 0, 0, 0);
+
+/* wfi */
+constexpr Word Wfi = cpu::EncodeITypeInstruction(cpu::Opcode::SYSTEM, cpu::Function::PRIV, 0, 0, static_cast<Word>(cpu::PrivFunction::WFI));
+
+/* j . */
+constexpr Word SelfLoop = cpu::EncodeJTypeInstruction(cpu::Opcode::JAL, 0, 0);
+
+/** Each test gets a freshly constructed system, which it may destroy itself. */
+using SystemPtr = std::unique_ptr<System>;
+using TestCase = FuncTestCase<SystemPtr>;
+
+Result ResetSystem(SystemPtr* ppSys) {
+    *ppSys = std::make_unique<System>();
+    return ResultSuccess();
+}
+
+/** Device reading its scheduler as it's destroyed, like the CLINT removing its timer. */
+class SchedulerProbe : public hw::IDevice {
+public:
+    SchedulerProbe(hw::DeviceScheduler* pScheduler, DWord* pDeadlineOut) noexcept :
+        IDevice(1),
+        m_pScheduler(pScheduler),
+        m_pDeadlineOut(pDeadlineOut) {}
+
+    ~SchedulerProbe() override { *m_pDeadlineOut = m_pScheduler->GetNextDeadline(); }
+
+    Result ProcessCycle() override { return ResultSuccess(); }
+private:
+    hw::DeviceScheduler* m_pScheduler;
+    DWord* m_pDeadlineOut;
+}; // class SchedulerProbe
+
+/** Initialize a system with memory and a CLINT driving its harts' timers, systems which are started go without. */
+Result InitializeSystem(System* pSys, Word hartCount, intrpt::CLINT** ppClint) {
+    Result res = pSys->InitializeMemRegions(Regions.data(), Regions.size());
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    res = pSys->Initialize(hartCount);
+    if(res.IsFailure() || ppClint == nullptr) {
+        return res;
+    }
+
+    auto pClint = std::make_unique<intrpt::CLINT>();
+    res = pClint->Initialize(hartCount, pSys->GetDeviceScheduler());
+    if(res.IsFailure()) {
+        return res;
+    }
+    pClint->SetTarget(pSys->GetClintTarget());
+
+    *ppClint = pClint.get();
+    return pSys->AddMmioPeripheral(std::move(pClint), ClintAddress);
+}
+
+/* Test destroying a system with a CLINT, peripherals must be destroyed while the scheduler is still alive. */
+Result TestDestroyWithClint(SystemPtr* ppSys) {
+    intrpt::CLINT* pClint = nullptr;
+    Result res = InitializeSystem(ppSys->get(), 2, &pClint);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* The probe only has its own deadline, the CLINT's timer has none until mtimecmp is written. */
+    DWord probeDeadline = 0;
+    res = (*ppSys)->AddPeripheral(std::make_unique<SchedulerProbe>((*ppSys)->GetDeviceScheduler(), &probeDeadline));
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    ppSys->reset();
+    if(probeDeadline != hw::DeviceScheduler::TickFreq) {
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/** Write a program to memory and point a hart at it. */
+template<std::size_t N>
+Result LoadProgram(System* pSys, int hartId, Address addr, const std::array<Word, N>& program) {
+    auto memCtlr = pSys->GetMemCtlrAccessor();
+    for(std::size_t i = 0; i < N; i++) {
+        Result res = memCtlr.WriteWord(program[i], addr + i * sizeof(Word));
+        if(res.IsFailure()) {
+            return res;
+        }
+    }
+
+    pSys->GetHartAccessor(hartId).WritePC(addr);
+    return ResultSuccess();
+}
+
+/** Poll until a condition holds, giving up after a generous timeout so a lost wake fails instead of hanging. */
+template<typename F>
+bool WaitUntil(F&& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while(!condition()) {
+        if(std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/* Test the time CSR backed by the CLINT reads the same time as its mtime under Run. */
+Result TestTimeMatchesClint(SystemPtr* ppSys) {
+    System* pSys = ppSys->get();
+    intrpt::CLINT* pClint = nullptr;
+    Result res = InitializeSystem(pSys, 1, &pClint);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Read time and mtime back to back, after the first batch. */
+    constexpr std::array Program{
+        cpu::EncodeUTypeInstruction(cpu::Opcode::LUI, 6, ClintAddress + 0xC000),
+        Nop,
+        Nop,
+        Nop,
+        Nop,
+        Nop,
+        cpu::EncodeITypeInstruction(cpu::Opcode::SYSTEM, cpu::Function::CSRRS, 5, 0, static_cast<Word>(cpu::CsrId::time)),
+        cpu::EncodeITypeInstruction(cpu::Opcode::LOAD, cpu::Function::LW, 7, 6, static_cast<Word>(-8)),
+        SelfLoop
+    };
+    res = LoadProgram(pSys, 0, MemoryAddress, Program);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* An instruction per tick, batches of 4 instructions. */
+    pSys->SetTimeSource(pClint->GetTimeSource());
+    pSys->SetGuestFrequency(hw::DeviceScheduler::TickFreq);
+    pSys->SetExecMode(System::ExecMode::RoundRobin, 4);
+
+    /* Time follows writes to mtime as well. */
+    constexpr DWord StartTime = 1'000'000;
+    pClint->WriteTime(StartTime);
+    res = pSys->Run(100);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Time has passed by the reads, ticks count at a tenth of the timebase frequency. */
+    auto hart = pSys->GetHartAccessor(0);
+    if(hart.ReadGPR(5) <= StartTime || hart.ReadGPR(5) != hart.ReadGPR(7) || pClint->ReadTime() != StartTime + 1000) {
+        std::cout << std::format("        time {}, mtime {}, mtime after run {}", hart.ReadGPR(5), hart.ReadGPR(7), pClint->ReadTime()) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test a hart idle in WFI under Run is woken by its CLINT timer, once virtual time skips to mtimecmp. */
+Result TestClintTimerWakesWfi(SystemPtr* ppSys) {
+    System* pSys = ppSys->get();
+    intrpt::CLINT* pClint = nullptr;
+    Result res = InitializeSystem(pSys, 1, &pClint);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Set mtimecmp to 1000, wait for the timer, then read mtime and mark the wake. */
+    constexpr DWord TimeCompare = 1000;
+    constexpr std::array Program{
+        cpu::EncodeUTypeInstruction(cpu::Opcode::LUI, 6, ClintAddress + 0x4000),
+        cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 5, 0, TimeCompare),
+        cpu::EncodeSTypeInstruction(cpu::Opcode::STORE, cpu::Function::SW, 6, 5, 0),
+        cpu::EncodeSTypeInstruction(cpu::Opcode::STORE, cpu::Function::SW, 6, 0, 4),
+        Wfi,
+        cpu::EncodeUTypeInstruction(cpu::Opcode::LUI, 29, ClintAddress + 0xC000),
+        cpu::EncodeITypeInstruction(cpu::Opcode::LOAD, cpu::Function::LW, 7, 29, static_cast<Word>(-8)),
+        cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 28, 0, 1),
+        SelfLoop
+    };
+    res = LoadProgram(pSys, 0, MemoryAddress, Program);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* An instruction per tick, ticks count at a tenth of the timebase frequency. */
+    pSys->SetGuestFrequency(hw::DeviceScheduler::TickFreq);
+    pSys->SetExecMode(System::ExecMode::RoundRobin, 16);
+    res = pSys->Run(1'000'000);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* The wake came from the timer deadline, not the end of the run. */
+    auto hart = pSys->GetHartAccessor(0);
+    if(hart.ReadGPR(28) != 1 || hart.ReadGPR(7) < TimeCompare || hart.ReadGPR(7) >= TimeCompare + 100 || !pClint->IsTimerPending(0)) {
+        std::cout << std::format("        Woken {}, mtime at wake {}", hart.ReadGPR(28), hart.ReadGPR(7)) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test time advances by default when harts are stepped or started, without any virtual time passing. */
+Result TestTimeAdvancesByDefault(SystemPtr* ppSys) {
+    System* pSys = ppSys->get();
+    Result res = InitializeSystem(pSys, 1, nullptr);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Read time into a0, count, then read it into a1 and publish it. */
+    constexpr std::array Program{
+        cpu::EncodeITypeInstruction(cpu::Opcode::SYSTEM, cpu::Function::CSRRS, 10, 0, static_cast<Word>(cpu::CsrId::time)),
+        cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 5, 0, 100),
+        cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 5, 5, static_cast<Word>(-1)),
+        cpu::EncodeBTypeInstruction(cpu::Opcode::BRANCH, cpu::Function::BNE, 5, 0, static_cast<Word>(-4)),
+        cpu::EncodeITypeInstruction(cpu::Opcode::SYSTEM, cpu::Function::CSRRS, 11, 0, static_cast<Word>(cpu::CsrId::time)),
+        cpu::EncodeSTypeInstruction(cpu::Opcode::STORE, cpu::Function::SW, 12, 11, 0),
+        SelfLoop
+    };
+    constexpr Address PublishAddress = MemoryAddress + 0x800;
+
+    for(System::ExecMode mode : { System::ExecMode::RoundRobin, System::ExecMode::ThreadPerHart }) {
+        res = LoadProgram(pSys, 0, MemoryAddress, Program);
+        if(res.IsFailure()) {
+            return res;
+        }
+        pSys->GetHartAccessor(0).WriteGPR(11, 0);
+        pSys->GetHartAccessor(0).WriteGPR(12, PublishAddress);
+        res = pSys->GetMemCtlrAccessor().WriteWord(0, PublishAddress);
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        /* Round-robin is stepped, the other mode is started until the second read is published. */
+        pSys->SetExecMode(mode, 16);
+        if(mode == System::ExecMode::RoundRobin) {
+            res = pSys->Step(100);
+        }
+        else {
+            res = pSys->Start();
+            if(res.IsFailure()) {
+                return res;
+            }
+
+            Word published = 0;
+            bool done = WaitUntil([&] {
+                return pSys->GetMemCtlrAccessor().ReadWord(&published, PublishAddress).IsSuccess() && published != 0;
+            });
+            pSys->Stop();
+            res = pSys->Join();
+            if(res.IsSuccess() && !done) {
+                res = ResultValMismatch();
+            }
+        }
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        auto hart = pSys->GetHartAccessor(0);
+        if(hart.ReadGPR(11) <= hart.ReadGPR(10)) {
+            std::cout << std::format("        Time went from {} to {}", hart.ReadGPR(10), hart.ReadGPR(11)) << std::endl;
+            return ResultValMismatch();
+        }
+    }
+    return ResultSuccess();
+}
+
+/* Test idle harts' cycle counters keep pace with virtual time, while others run and while time is skipped. */
+Result TestIdleCyclesKeepPace(SystemPtr* ppSys) {
+    System* pSys = ppSys->get();
+    intrpt::CLINT* pClint = nullptr;
+    Result res = InitializeSystem(pSys, 2, &pClint);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Hart 0 idles for good, hart 1 counts in a loop which isn't skipped. */
+    res = LoadProgram(pSys, 0, MemoryAddress, std::array{ Wfi, SelfLoop });
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    constexpr std::array CountLoop{
+        cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 5, 5, 1),
+        cpu::EncodeJTypeInstruction(cpu::Opcode::JAL, 0, static_cast<Word>(-4))
+    };
+    res = LoadProgram(pSys, 1, MemoryAddress + 0x100, CountLoop);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    pSys->SetGuestFrequency(hw::DeviceScheduler::TickFreq);
+    pSys->SetExecMode(System::ExecMode::RoundRobin, 16);
+    res = pSys->Run(1000);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(pSys->GetHartAccessor(0).GetCycleCount() != 1000 || pSys->GetHartAccessor(1).GetCycleCount() != 1000) {
+        std::cout << std::format("        Cycles while running {}, {}", pSys->GetHartAccessor(0).GetCycleCount(), pSys->GetHartAccessor(1).GetCycleCount()) << std::endl;
+        return ResultValMismatch();
+    }
+
+    /* With hart 1 stuck on a self loop as well, the remaining time is skipped. */
+    pSys->GetHartAccessor(1).WritePC(MemoryAddress + sizeof(Word));
+    res = pSys->Run(1000);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(pSys->GetHartAccessor(0).GetCycleCount() != 2000 || pSys->GetHartAccessor(1).GetCycleCount() != 2000 || pSys->GetTime() != 2000) {
+        std::cout << std::format("        Cycles while skipping {}, {}", pSys->GetHartAccessor(0).GetCycleCount(), pSys->GetHartAccessor(1).GetCycleCount()) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test spinning harts which yield the rest of a batch keep pace, and huge quanta don't overflow virtual time. */
+Result TestYieldedCyclesKeepPace(SystemPtr* ppSys) {
+    System* pSys = ppSys->get();
+    intrpt::CLINT* pClint = nullptr;
+    Result res = InitializeSystem(pSys, 2, &pClint);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Hart 0 polls a flag which never gets set, it yields once recognized as spinning. */
+    constexpr Address FlagAddress = MemoryAddress + 0x800;
+    constexpr std::array PollLoop{
+        cpu::EncodeITypeInstruction(cpu::Opcode::LOAD, cpu::Function::LW, 5, 10, 0),
+        cpu::EncodeBTypeInstruction(cpu::Opcode::BRANCH, cpu::Function::BEQ, 5, 0, static_cast<Word>(-4))
+    };
+    res = LoadProgram(pSys, 0, MemoryAddress, PollLoop);
+    if(res.IsFailure()) {
+        return res;
+    }
+    pSys->GetHartAccessor(0).WriteGPR(10, FlagAddress);
+
+    constexpr std::array CountLoop{
+        cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 5, 5, 1),
+        cpu::EncodeJTypeInstruction(cpu::Opcode::JAL, 0, static_cast<Word>(-4))
+    };
+    res = LoadProgram(pSys, 1, MemoryAddress + 0x100, CountLoop);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    pSys->SetGuestFrequency(hw::DeviceScheduler::TickFreq);
+    pSys->SetExecMode(System::ExecMode::RoundRobin, 1000);
+    res = pSys->Run(10000);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(pSys->GetHartAccessor(0).GetCycleCount() != 10000 || pSys->GetHartAccessor(1).GetCycleCount() != 10000 || pSys->GetTime() != 10000) {
+        std::cout << std::format("        Cycles {}, {}, time {}", pSys->GetHartAccessor(0).GetCycleCount(), pSys->GetHartAccessor(1).GetCycleCount(), pSys->GetTime()) << std::endl;
+        return ResultValMismatch();
+    }
+
+    /* With only the spinning hart left, a quantum too large to convert to ticks still advances time exactly. */
+    pSys->GetHartAccessor(1).WritePC(MemoryAddress);
+    pSys->GetHartAccessor(1).WriteGPR(10, FlagAddress);
+    constexpr DWord HugeCount = DWord{ 1 } << 46;
+    pSys->SetExecMode(System::ExecMode::RoundRobin, ~DWord{ 0 });
+    res = pSys->Run(HugeCount);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    if(pSys->GetHartAccessor(0).GetCycleCount() != 10000 + HugeCount || pSys->GetTime() != 10000 + HugeCount) {
+        std::cout << std::format("        Cycles {}, time {}", pSys->GetHartAccessor(0).GetCycleCount(), pSys->GetTime()) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test pacing holds a run back to the guest frequency when the quantum is longer than the pacer's drift limit. */
+Result TestPacingLargeQuantum(SystemPtr* ppSys) {
+    System* pSys = ppSys->get();
+    intrpt::CLINT* pClint = nullptr;
+    Result res = InitializeSystem(pSys, 1, &pClint);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    constexpr std::array CountLoop{
+        cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 5, 5, 1),
+        cpu::EncodeJTypeInstruction(cpu::Opcode::JAL, 0, static_cast<Word>(-4))
+    };
+    res = LoadProgram(pSys, 0, MemoryAddress, CountLoop);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* 200ms of guest time, in a quantum of a whole second. */
+    constexpr DWord GuestFreq = 1'000'000;
+    pSys->SetGuestFrequency(GuestFreq);
+    pSys->SetExecMode(System::ExecMode::RoundRobin, GuestFreq);
+    pSys->SetRealTimePacing(true);
+
+    auto start = std::chrono::steady_clock::now();
+    res = pSys->Run(GuestFreq / 5);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Sleeps only ever overrun, allow for the lead left below the pacer's granularity. */
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if(elapsed < std::chrono::milliseconds(150)) {
+        std::cout << std::format("        Ran for {}ms", std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()) << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+constexpr Word WakeHartCount = 4;
+constexpr Address GenerationAddress = MemoryAddress + 0x700;
+constexpr Address ResultAddress = MemoryAddress + 0x800;
+
+/* Count to 100 every time the generation changes, publishing the total, and idle in WFI in between. */
+constexpr std::array WakeProgram{
+    Wfi,
+    cpu::EncodeITypeInstruction(cpu::Opcode::LOAD, cpu::Function::LW, 5, 11, 0),
+    cpu::EncodeBTypeInstruction(cpu::Opcode::BRANCH, cpu::Function::BEQ, 5, 7, static_cast<Word>(-8)),
+    cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 7, 5, 0),
+    cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 28, 0, 100),
+    cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 6, 6, 1),
+    cpu::EncodeITypeInstruction(cpu::Opcode::OP_IMM, cpu::Function::ADDI, 28, 28, static_cast<Word>(-1)),
+    cpu::EncodeBTypeInstruction(cpu::Opcode::BRANCH, cpu::Function::BNE, 28, 0, static_cast<Word>(-8)),
+    cpu::EncodeSTypeInstruction(cpu::Opcode::STORE, cpu::Function::SW, 10, 6, 0),
+    cpu::EncodeJTypeInstruction(cpu::Opcode::JAL, 0, static_cast<Word>(-36))
+};
+
+/** Wait for every hart to idle, bump the generation and wake them all, then wait for each to publish the total. */
+Result WakeAndCheck(System* pSys, Word generation) {
+    if(!WaitUntil([pSys] {
+        for(Word i = 0; i < WakeHartCount; i++) {
+            if(!pSys->GetHartAccessor(static_cast<int>(i)).IsIdle()) {
+                return false;
+            }
+        }
+        return true;
+    })) {
+        std::cout << "        Harts didn't idle" << std::endl;
+        return ResultValMismatch();
+    }
+
+    Result res = pSys->GetMemCtlrAccessor().WriteWord(generation, GenerationAddress);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    /* Hart 0 is woken by an interrupt controller, hart 1 by the CLINT and the rest from another thread. */
+    res = pSys->CreateIrqTarget(0)->NotifyAvailableIRQ();
+    if(res.IsFailure()) {
+        return res;
+    }
+    pSys->GetClintTarget()->NotifySoftwareInterrupt(1, true);
+    std::thread waker([pSys] {
+        for(Word i = 2; i < WakeHartCount; i++) {
+            pSys->WakeHart(i);
+        }
+    });
+    waker.join();
+
+    /* Harts idle in WFI use no host thread, a lost wake leaves the total unpublished. */
+    for(Word i = 0; i < WakeHartCount; i++) {
+        Word total = 0;
+        if(!WaitUntil([&] {
+            return pSys->GetMemCtlrAccessor().ReadWord(&total, ResultAddress + i * sizeof(Word)).IsSuccess() && total == generation * 100;
+        })) {
+            std::cout << std::format("        Generation {}: hart {} published {}", generation, i, total) << std::endl;
+            return ResultValMismatch();
+        }
+    }
+    return ResultSuccess();
+}
+
+/** Start idle harts in a mode, wake them through every interrupt path twice, stopping and joining in between. */
+Result RunWakeTest(System* pSys, System::ExecMode mode, DWord quantum, std::size_t workerCount) {
+    Result res = InitializeSystem(pSys, WakeHartCount, nullptr);
+    if(res.IsFailure()) {
+        return res;
+    }
+
+    for(Word i = 0; i < WakeHartCount; i++) {
+        auto hart = pSys->GetHartAccessor(static_cast<int>(i));
+        res = LoadProgram(pSys, static_cast<int>(i), MemoryAddress, WakeProgram);
+        if(res.IsFailure()) {
+            return res;
+        }
+        hart.WriteGPR(10, ResultAddress + i * sizeof(Word));
+        hart.WriteGPR(11, GenerationAddress);
+    }
+
+    pSys->SetExecMode(mode, quantum, workerCount);
+    for(Word generation = 1; generation <= 2; generation++) {
+        res = pSys->Start();
+        if(res.IsFailure()) {
+            return res;
+        }
+
+        Result wakeRes = WakeAndCheck(pSys, generation);
+
+        /* Stop has to get idle harts off their host threads for Join to return. */
+        pSys->Stop();
+        res = pSys->Join();
+        if(res.IsFailure()) {
+            return res;
+        }
+        if(wakeRes.IsFailure()) {
+            return wakeRes;
+        }
+
+        /* Registers are only safe to read once joined. */
+        for(Word i = 0; i < WakeHartCount; i++) {
+            NativeWord count = pSys->GetHartAccessor(static_cast<int>(i)).ReadGPR(6);
+            if(count != generation * 100) {
+                std::cout << std::format("        Generation {}: hart {} counted {}", generation, i, count) << std::endl;
+                return ResultValMismatch();
+            }
+        }
+    }
+    return ResultSuccess();
+}
+
+/* Test harts on their own threads are woken from WFI, and Join returns once they're stopped. */
+Result TestThreadPerHartWake(SystemPtr* ppSys) {
+    return RunWakeTest(ppSys->get(), System::ExecMode::ThreadPerHart, System::DefaultQuantum, 0);
+}
+
+/* Test a single thread interleaving harts sleeps while all are idle, and is woken by any of them. */
+Result TestRoundRobinWake(SystemPtr* ppSys) {
+    return RunWakeTest(ppSys->get(), System::ExecMode::RoundRobin, 16, 0);
+}
+
+/* Test idle harts are parked and requeued when woken, with fewer workers than harts which steal from eachother. */
+Result TestThreadPoolWake(SystemPtr* ppSys) {
+    return RunWakeTest(ppSys->get(), System::ExecMode::ThreadPool, 16, 3);
+}
+
+constexpr TestFramework g_TestRunner{
+    &ResetSystem,
+
+    std::tuple{
+        TestCase{ "DestroyWithClint", &TestDestroyWithClint },
+        TestCase{ "TimeMatchesClint", &TestTimeMatchesClint },
+        TestCase{ "ClintTimerWakesWfi", &TestClintTimerWakesWfi },
+        TestCase{ "TimeAdvancesByDefault", &TestTimeAdvancesByDefault },
+        TestCase{ "IdleCyclesKeepPace", &TestIdleCyclesKeepPace },
+        TestCase{ "YieldedCyclesKeepPace", &TestYieldedCyclesKeepPace },
+        TestCase{ "PacingLargeQuantum", &TestPacingLargeQuantum },
+        TestCase{ "ThreadPerHartWake", &TestThreadPerHartWake },
+        TestCase{ "RoundRobinWake", &TestRoundRobinWake },
+        TestCase{ "ThreadPoolWake", &TestThreadPoolWake },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args arg) {
+    SystemPtr sys;
+
+    return g_TestRunner.RunAll(&sys);
+}
+
+} // namespace test
+} // namespace riscv
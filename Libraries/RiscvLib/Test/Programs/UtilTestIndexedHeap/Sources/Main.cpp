@@ -0,0 +1,186 @@
+#include <RiscvEmuTest/test_Common.h>
+#include <RiscvEmuTest/test_FuncTestCase.h>
+#include <RiscvEmuTest/test_TestFramework.h>
+#include <RiscvEmuTest/test_Result.ext.h>
+#include <RiscvEmu/util/util_IndexedHeap.h>
+#include <algorithm>
+#include <initializer_list>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace riscv {
+namespace test {
+
+namespace {
+
+using Heap = util::IndexedHeap<DWord>;
+using TestCase = FuncTestCase<Heap>;
+
+Result ResetHeap(Heap* pHeap) {
+    pHeap->Clear();
+    return ResultSuccess();
+}
+
+/** Pop every element, checking they come out in the expected order. */
+Result CheckPopOrder(Heap* pHeap, std::initializer_list<DWord> expected) {
+    std::vector<DWord> popped;
+    while(!pHeap->IsEmpty()) {
+        popped.push_back(pHeap->GetTop());
+        pHeap->Pop();
+    }
+
+    if(!std::equal(popped.begin(), popped.end(), expected.begin(), expected.end())) {
+        std::cout << "        Expected:";
+        for(DWord val : expected) {
+            std::cout << std::format(" {}", val);
+        }
+        std::cout << "\n        Got:     ";
+        for(DWord val : popped) {
+            std::cout << std::format(" {}", val);
+        }
+        std::cout << std::endl;
+        return ResultValMismatch();
+    }
+    return ResultSuccess();
+}
+
+/* Test elements are popped in order, duplicates included. */
+Result TestPopOrder(Heap* pHeap) {
+    for(DWord val : { 50, 20, 70, 10, 20, 90, 30, 60, 40, 80 }) {
+        pHeap->Push(val);
+    }
+    if(pHeap->GetSize() != 10) {
+        return ResultValMismatch();
+    }
+
+    return CheckPopOrder(pHeap, { 10, 20, 20, 30, 40, 50, 60, 70, 80, 90 });
+}
+
+/* Test updating a handle's value moves it up or down and keeps the handle. */
+Result TestUpdate(Heap* pHeap) {
+    std::vector<Heap::Handle> handles;
+    for(DWord val : { 10, 20, 30, 40, 50, 60, 70, 80 }) {
+        handles.push_back(pHeap->Push(val));
+    }
+
+    /* Decrease the last element to the top, increase the top to the bottom. */
+    pHeap->Update(handles[7], 5);
+    if(pHeap->GetTopHandle() != handles[7]) {
+        return ResultValMismatch();
+    }
+
+    pHeap->Update(handles[0], 100);
+    pHeap->Update(handles[3], 45);
+    if(pHeap->Get(handles[0]) != 100 || pHeap->Get(handles[3]) != 45 || pHeap->Get(handles[5]) != 60) {
+        return ResultValMismatch();
+    }
+
+    return CheckPopOrder(pHeap, { 5, 20, 30, 45, 50, 60, 70, 100 });
+}
+
+/* Test removing by handle, leaving the other handles valid, and reusing removed handles. */
+Result TestRemove(Heap* pHeap) {
+    std::vector<Heap::Handle> handles;
+    for(DWord val : { 10, 20, 30, 40, 50, 60, 70, 80 }) {
+        handles.push_back(pHeap->Push(val));
+    }
+
+    /* Remove the top, a leaf and an inner node. */
+    pHeap->Remove(handles[0]);
+    pHeap->Remove(handles[7]);
+    pHeap->Remove(handles[2]);
+    for(std::size_t i = 0; i < handles.size(); i++) {
+        const bool removed = i == 0 || i == 7 || i == 2;
+        if(pHeap->Contains(handles[i]) == removed) {
+            return ResultValMismatch();
+        }
+        if(!removed && pHeap->Get(handles[i]) != (i + 1) * 10) {
+            return ResultValMismatch();
+        }
+    }
+
+    /* Removed handles are handed out again. */
+    Heap::Handle reused = pHeap->Push(35);
+    if(reused != handles[0] && reused != handles[7] && reused != handles[2]) {
+        return ResultValMismatch();
+    }
+    if(pHeap->Get(reused) != 35) {
+        return ResultValMismatch();
+    }
+
+    return CheckPopOrder(pHeap, { 20, 35, 40, 50, 60, 70 });
+}
+
+/* Test random pushes, updates, removes and pops against a reference map of handles. */
+Result TestRandomized(Heap* pHeap) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<DWord> valDist(0, 999);
+    std::map<Heap::Handle, DWord> reference;
+
+    for(int i = 0; i < 20000; i++) {
+        const auto op = rng() % 4;
+        if(op == 0 || reference.empty()) {
+            const DWord val = valDist(rng);
+            Heap::Handle handle = pHeap->Push(val);
+            if(reference.contains(handle)) {
+                return ResultValMismatch();
+            }
+            reference[handle] = val;
+        }
+        else {
+            auto it = std::next(reference.begin(), static_cast<std::ptrdiff_t>(rng() % reference.size()));
+            if(op == 1) {
+                it->second = valDist(rng);
+                pHeap->Update(it->first, it->second);
+            }
+            else if(op == 2) {
+                pHeap->Remove(it->first);
+                reference.erase(it);
+            }
+            else {
+                auto minIt = std::min_element(reference.begin(), reference.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.second < rhs.second;
+                });
+                if(pHeap->GetTop() != minIt->second || reference.at(pHeap->GetTopHandle()) != minIt->second) {
+                    return ResultValMismatch();
+                }
+                reference.erase(pHeap->GetTopHandle());
+                pHeap->Pop();
+            }
+        }
+
+        if(pHeap->GetSize() != reference.size()) {
+            return ResultValMismatch();
+        }
+    }
+
+    for(const auto& [handle, val] : reference) {
+        if(!pHeap->Contains(handle) || pHeap->Get(handle) != val) {
+            return ResultValMismatch();
+        }
+    }
+    return ResultSuccess();
+}
+
+constexpr TestFramework g_TestRunner{
+    &ResetHeap,
+
+    std::tuple{
+        TestCase{ "PopOrder", &TestPopOrder },
+        TestCase{ "Update", &TestUpdate },
+        TestCase{ "Remove", &TestRemove },
+        TestCase{ "Randomized", &TestRandomized },
+    }
+};
+
+} // namespace
+
+TestResults Main([[maybe_unused]] Args arg) {
+    Heap heap;
+
+    return g_TestRunner.RunAll(&heap);
+}
+
+} // namespace test
+} // namespace riscv
@@ -1,4 +1,6 @@
 #include <RiscvEmuTest/cpu/test_HartTestSystem.h>
+#include <algorithm>
+#include <span>
 
 namespace riscv {
 namespace test {
@@ -38,20 +40,16 @@ void HartTestSystem::ClearGPRs() noexcept {
 }
 
 Result HartTestSystem::ClearMem() {
-    /* Memory size must be aligned to 8 bytes. */
-    static_assert(MemoryAddress + MemorySize % 8);
-
-    /* Write zero to entirety of ram. */
-    Address curAddr = MemoryAddress;
-    while(curAddr < MemoryAddress + MemorySize) {
-        Result res = this->MemWriteDWord(0, curAddr);
-        if(res.IsFailure()) {
-            return res;
-        }
-
-        curAddr += 8;
+    /* Get direct access to the entirety of ram. */
+    std::span<Byte> mem;
+    Result res = m_MemCtlr.GetHostSpan(&mem, MemoryAddress, MemorySize);
+    if(res.IsFailure()) {
+        return res;
     }
 
+    /* Write zero to it. */
+    std::ranges::fill(mem, 0);
+
     return ResultSuccess();
 }
 